@@ -7,14 +7,122 @@ void fittingWorker::run( hs_parameters_t                   params_low,
                          hs_parameters_t                   params_high,
                          int                               subdivisions,
                          double                            amortization,
-                         bool                              use_geometric,
+                         int                               norm,
+                         int                               engine,
+                         int                               max_evaluations,
                          const std::vector< test_data_t >& test_set,
                          Hartman_Schijve_autoRange         autoRange,
-                         bool                              compute_individually )
+                         bool                              compute_individually,
+                         hs_common_t                       common )
 {
   running_        = true;
   stop_requested_ = false;
 
+  using param_t = cg::Hartman_Schijve::parameters< real_t >;
+
+  // Same order as the items of engine_type
+  auto fit = [ & ]( const param_t&                                    low,
+                    const param_t&                                    high,
+                    const std::vector< cg::test_data_t< real_t > >&   tests,
+                    std::function< void( param_t, param_t, param_t ) > update_callback,
+                    cg::Hartman_Schijve::progress_callback_t          progress_callback ) {
+    switch ( engine )
+    {
+    case 1:
+      return cg::Hartman_Schijve::fit_direct( low,
+                                              high,
+                                              tests,
+                                              max_evaluations,
+                                              cg::Hartman_Schijve::norm_t( norm ),
+                                              update_callback,
+                                              progress_callback,
+                                              stop_requested_ );
+    case 2:
+      return cg::Hartman_Schijve::fit_cmaes( low,
+                                             high,
+                                             tests,
+                                             max_evaluations,
+                                             cg::Hartman_Schijve::norm_t( norm ),
+                                             update_callback,
+                                             progress_callback,
+                                             stop_requested_ );
+    case 3:
+      return cg::Hartman_Schijve::fit_differential_evolution( low,
+                                                              high,
+                                                              tests,
+                                                              max_evaluations,
+                                                              cg::Hartman_Schijve::norm_t( norm ),
+                                                              update_callback,
+                                                              progress_callback,
+                                                              stop_requested_ );
+    case 4:
+      return cg::Hartman_Schijve::fit_surrogate( low,
+                                                 high,
+                                                 tests,
+                                                 max_evaluations,
+                                                 cg::Hartman_Schijve::norm_t( norm ),
+                                                 update_callback,
+                                                 progress_callback,
+                                                 stop_requested_ );
+    case 5:
+      return cg::Hartman_Schijve::fit_race( low,
+                                            high,
+                                            tests,
+                                            { cg::Hartman_Schijve::engine_t::grid,
+                                              cg::Hartman_Schijve::engine_t::direct,
+                                              cg::Hartman_Schijve::engine_t::cmaes,
+                                              cg::Hartman_Schijve::engine_t::differential_evolution,
+                                              cg::Hartman_Schijve::engine_t::surrogate,
+                                              cg::Hartman_Schijve::engine_t::nelder_mead },
+                                            subdivisions,
+                                            amortization,
+                                            max_evaluations,
+                                            cg::Hartman_Schijve::norm_t( norm ),
+                                            update_callback,
+                                            progress_callback,
+                                            stop_requested_ );
+    case 6:
+    {
+      // A grid contracted a hundredfold, refined within the whole box. An amortization that does
+      // not contract the grid runs a fixed number of rounds.
+      const std::size_t iterations
+        = amortization > 1.0 ? std::max( 1.0, std::log( 100.0 ) / std::log( amortization ) ) : 10;
+
+      const auto start = cg::Hartman_Schijve::fit( low,
+                                                   high,
+                                                   tests,
+                                                   subdivisions,
+                                                   amortization,
+                                                   iterations,
+                                                   cg::Hartman_Schijve::norm_t( norm ),
+                                                   update_callback,
+                                                   progress_callback,
+                                                   stop_requested_ );
+
+      return cg::Hartman_Schijve::fit_levenberg_marquardt( low,
+                                                           high,
+                                                           tests,
+                                                           start,
+                                                           100,
+                                                           cg::Hartman_Schijve::norm_t( norm ),
+                                                           update_callback,
+                                                           progress_callback,
+                                                           stop_requested_ );
+    }
+    }
+
+    return cg::Hartman_Schijve::fit( low,
+                                     high,
+                                     tests,
+                                     subdivisions,
+                                     amortization,
+                                     0,
+                                     cg::Hartman_Schijve::norm_t( norm ),
+                                     update_callback,
+                                     progress_callback,
+                                     stop_requested_ );
+  };
+
   if ( !compute_individually )
   {
     std::vector< cg::test_data_t< real_t > > test_set_fitting;
@@ -32,8 +140,6 @@ void fittingWorker::run( hs_parameters_t                   params_low,
       }
     }
 
-    using param_t = cg::Hartman_Schijve::parameters< real_t >;
-
     std::function< void( param_t, param_t, param_t ) > update_callback
       = [ this ]( param_t params, param_t params_lower, param_t params_upper ) {
           calback_mutex.lock( );
@@ -47,16 +153,78 @@ void fittingWorker::run( hs_parameters_t                   params_low,
       calback_mutex.unlock( );
     };
 
-    cg::Hartman_Schijve::fit( params_low,
-                              params_high,
-                              test_set_fitting,
-                              subdivisions,
-                              amortization,
-                              0,
-                              use_geometric,
-                              update_callback,
-                              progress_report_callback,
-                              stop_requested_ );
+    fit( params_low, params_high, test_set_fitting, update_callback, progress_report_callback );
+  }
+  else if ( common.any_common( ) )
+  {
+    // One box for all tests, so the automatic ranges of DeltaK_thr and A span those of the tests
+    std::vector< cg::test_data_t< real_t > > test_set_fitting;
+
+    real_t max_DeltaK_thr = 0.0;
+    real_t min_A          = std::numeric_limits< real_t >::max( );
+    real_t max_A          = 0.0;
+
+    for ( const auto& test : test_set )
+    {
+      cg::test_data_t< real_t > test_data;
+      test_data.R = test.R;
+
+      for ( const auto point : test.points )
+      {
+        test_data.points.push_back( { real_t { point.DeltaK }, real_t { point.dadN } } );
+      }
+      test_set_fitting.emplace_back( std::move( test_data ) );
+
+      max_DeltaK_thr = std::max( max_DeltaK_thr, Hartman_Schijve::calc_max_DeltaK_thr( test ) );
+      min_A          = std::min( min_A, Hartman_Schijve::calc_min_A( test ) );
+      max_A          = std::max( max_A, Hartman_Schijve::calc_min_A( test ) );
+    }
+
+    if ( autoRange.DeltaK_thr_low )
+    {
+      params_low.DeltaK_thr = Hartman_Schijve::min_DeltaK_thr;
+    }
+
+    if ( autoRange.DeltaK_thr_high )
+    {
+      params_high.DeltaK_thr = 1.2 * max_DeltaK_thr;
+    }
+
+    if ( autoRange.A_low )
+    {
+      params_low.A = 0.8 * min_A;
+    }
+
+    if ( autoRange.A_high )
+    {
+      params_high.A = 10.0 * max_A;
+    }
+
+    // The grid over the shared parameters, the only engine of fit_joint, which the window selects
+    // while any parameter is common
+    cg::Hartman_Schijve::fit_joint< real_t >(
+      common,
+      params_low,
+      params_high,
+      test_set_fitting,
+      subdivisions,
+      amortization,
+      0,
+      cg::Hartman_Schijve::norm_t( norm ),
+      [ this ]( std::vector< param_t > params ) {
+        calback_mutex.lock( );
+        for ( std::size_t id = 0; id != params.size( ); id++ )
+        {
+          emit individuallyUpdatedResults( params[ id ], params[ id ], params[ id ], int( id ) );
+        }
+        calback_mutex.unlock( );
+      },
+      [ this ]( std::size_t i, std::size_t total ) {
+        calback_mutex.lock( );
+        emit progressReport( i, total );
+        calback_mutex.unlock( );
+      },
+      stop_requested_ );
   }
   else
   {
@@ -75,8 +243,6 @@ void fittingWorker::run( hs_parameters_t                   params_low,
       }
       test_set_fitting.emplace_back( std::move( test_data ) );
 
-      using param_t = cg::Hartman_Schijve::parameters< real_t >;
-
       std::function< void( param_t, param_t, param_t ) > update_callback
         = [ this, &id ]( param_t params, param_t params_lower, param_t params_upper ) {
             calback_mutex.lock( );
@@ -117,16 +283,7 @@ void fittingWorker::run( hs_parameters_t                   params_low,
         std::cout << "maxA = " << params_high.A << std::endl;
       }
 
-      cg::Hartman_Schijve::fit( params_low,
-                                params_high,
-                                test_set_fitting,
-                                subdivisions,
-                                amortization,
-                                0,
-                                use_geometric,
-                                update_callback,
-                                progress_report_callback,
-                                stop_requested_ );
+      fit( params_low, params_high, test_set_fitting, update_callback, progress_report_callback );
       id++;
     }
   }
@@ -138,6 +295,56 @@ void fittingWorker::run( hs_parameters_t                   params_low,
   emit finished();
 }
 
+void fittingWorker::profile( hs_parameters_t                   params_low,
+                             hs_parameters_t                   params_high,
+                             hs_parameters_t                   estimate,
+                             int                               norm,
+                             const std::vector< test_data_t >& test_set )
+{
+  running_        = true;
+  stop_requested_ = false;
+
+  std::vector< cg::test_data_t< real_t > > test_set_fitting;
+  for ( const auto& test : test_set )
+  {
+    cg::test_data_t< real_t > test_data;
+    test_data.R = test.R;
+
+    for ( const auto point : test.points )
+    {
+      test_data.points.push_back( { real_t { point.DeltaK }, real_t { point.dadN } } );
+    }
+    test_set_fitting.emplace_back( std::move( test_data ) );
+  }
+
+  cg::Hartman_Schijve::profile< real_t >(
+    params_low,
+    params_high,
+    test_set_fitting,
+    estimate,
+    41,
+    cg::Hartman_Schijve::norm_t( norm ),
+    0.95,
+    0.5,
+    [ this ]( hs_profiles_t profiles ) {
+      calback_mutex.lock( );
+      emit profileUpdated( profiles );
+      calback_mutex.unlock( );
+    },
+    [ this ]( std::size_t i, std::size_t total ) {
+      calback_mutex.lock( );
+      emit progressReport( i, total );
+      calback_mutex.unlock( );
+    },
+    stop_requested_ );
+
+  running_        = false;
+  stop_requested_ = false;
+
+  emit progressReport( 99, 100 );
+  emit finished( );
+}
+
 void fittingWorker::stop( )
 {
   qDebug( ) << "Stopping";
@@ -50,6 +50,8 @@
 // Todo: move hs_parameters_t inside the fitting worker
 using real_t          = long double;
 using hs_parameters_t = crack_growth::Hartman_Schijve::parameters< real_t >;
+using hs_common_t     = crack_growth::Hartman_Schijve::common_among_tests;
+using hs_profiles_t   = std::array< crack_growth::Hartman_Schijve::profile_t< real_t >, 4 >;
 
 struct Hartman_Schijve_autoRange
 {
@@ -101,10 +103,19 @@ public slots:
             hs_parameters_t                   params_high,
             int                               subdivisions,
             double                            amortization,
-            bool                              use_geometric,
+            int                               norm,
+            int                               engine,
+            int                               max_evaluations,
             const std::vector< test_data_t >& test_set,
             Hartman_Schijve_autoRange         autoRange,
-            bool                              compute_individually = false );
+            bool                              compute_individually = false,
+            hs_common_t                       common = hs_common_t { false, false, false, false } );
+
+  void profile( hs_parameters_t                   params_low,
+                hs_parameters_t                   params_high,
+                hs_parameters_t                   estimate,
+                int                               norm,
+                const std::vector< test_data_t >& test_set );
 
   void stop( );
 
@@ -120,6 +131,8 @@ signals:
                                    hs_parameters_t params_upper,
                                    int             dataSetId );
 
+  void profileUpdated( hs_profiles_t profiles );
+
   void progressReport( int, int );
 
   void finished();
@@ -11,6 +11,8 @@ void register_qt_meta_types()
     qRegisterMetaType<test_data_t>("test_data_t");
     qRegisterMetaType<std::vector<test_data_t>>("std::vector<test_data_t>");
     qRegisterMetaType<Hartman_Schijve_autoRange>("Hartman_Schijve_autoRange");
+    qRegisterMetaType<hs_common_t>("hs_common_t");
+    qRegisterMetaType<hs_profiles_t>("hs_profiles_t");
 }
 
 int main(int argc, char* argv[])
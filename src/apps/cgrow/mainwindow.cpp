@@ -179,6 +179,7 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
            this,
            &mainWindow::handleIndividualResults );
   connect( worker, &fittingWorker::progressReport, this, &mainWindow::handleProgressReport );
+  connect( worker, &fittingWorker::profileUpdated, this, &mainWindow::handle_profiles );
 
   connect( worker, &fittingWorker::finished, this, &mainWindow::handle_fitting_finished );
 
@@ -222,7 +223,7 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
       eqnLabel->setPixmap(
         eqnPic.scaled( 240, 70, Qt::KeepAspectRatio, Qt::SmoothTransformation ) );
       eqnLabel->setAlignment( Qt::AlignHCenter | Qt::AlignVCenter );
-      fgrid->addWidget( eqnLabel, ++q, 0, 1, 5 );
+      fgrid->addWidget( eqnLabel, ++q, 0, 1, 6 );
 
       auto palette = eqnLabel->palette( );
       palette.setColor( eqnLabel->backgroundRole( ), Qt::white );
@@ -239,6 +240,14 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
     fgrid->addWidget( new QLabel( tr( "Maximum" ) ), q, 3, 1, 1 );
     fgrid->addWidget( new QLabel( tr( "Auto" ) ), q, 4, 1, 1 );
 
+    {
+      auto common_label = new QLabel( tr( "Common" ) );
+      common_label->setToolTip(
+        tr( "Shared among the tests when computing individually, the others fitted per test. "
+            "Only the grid contraction supports them." ) );
+      fgrid->addWidget( common_label, q, 5, 1, 1 );
+    }
+
     {
       auto validator = new QDoubleValidator( 0, 1e100, 10 );
 
@@ -251,6 +260,9 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
       fgrid->addWidget( new QLabel( "D:" ), ++q, 0, 1, 1 );
       fgrid->addWidget( D_min, q, 1, 1, 1 );
       fgrid->addWidget( D_max, q, 3, 1, 1 );
+
+      D_common = new QCheckBox;
+      fgrid->addWidget( D_common, q, 5, 1, 1 );
     }
 
     {
@@ -265,6 +277,9 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
       fgrid->addWidget( new QLabel( "p:" ), ++q, 0, 1, 1 );
       fgrid->addWidget( p_min, q, 1, 1, 1 );
       fgrid->addWidget( p_max, q, 3, 1, 1 );
+
+      p_common = new QCheckBox;
+      fgrid->addWidget( p_common, q, 5, 1, 1 );
     }
 
     {
@@ -294,6 +309,9 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
       fgrid->addWidget( DeltaK_thr_min_auto, q, 2, 1, 1 );
       fgrid->addWidget( DeltaK_thr_max, q, 3, 1, 1 );
       fgrid->addWidget( DeltaK_thr_max_auto, q, 4, 1, 1 );
+
+      DeltaK_thr_common = new QCheckBox;
+      fgrid->addWidget( DeltaK_thr_common, q, 5, 1, 1 );
     }
 
     {
@@ -320,11 +338,28 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
       fgrid->addWidget( A_min_auto, q, 2, 1, 1 );
       fgrid->addWidget( A_max, q, 3, 1, 1 );
       fgrid->addWidget( A_max_auto, q, 4, 1, 1 );
+
+      A_common = new QCheckBox;
+      fgrid->addWidget( A_common, q, 5, 1, 1 );
     }
 
     auto ogrid = new QGridLayout;
     int  s     = -1;
 
+    {
+      engine_type = new QComboBox;
+      engine_type->addItem( tr( "Grid contraction" ) );
+      engine_type->addItem( tr( "DIRECT-L" ) );
+      engine_type->addItem( tr( "CMA-ES (BIPOP)" ) );
+      engine_type->addItem( tr( "Differential evolution (JADE)" ) );
+      engine_type->addItem( tr( "Surrogate (GP, EI)" ) );
+      engine_type->addItem( tr( "Race (all engines)" ) );
+      engine_type->addItem( tr( "Grid + Levenberg-Marquardt" ) );
+
+      ogrid->addWidget( new QLabel( "Engine:" ), ++s, 0, 1, 3 );
+      ogrid->addWidget( engine_type, s, 3, 1, 1 );
+    }
+
     {
       auto validator = new QIntValidator( 3, 1000 );
 
@@ -343,10 +378,52 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
       ogrid->addWidget( amortization, s, 3, 1, 1 );
     }
 
+    {
+      auto validator = new QIntValidator( 100, 100000000 );
+
+      max_evaluations = new QLineEdit( "20000" );
+      max_evaluations->setValidator( validator );
+      max_evaluations->setEnabled( false );
+      ogrid->addWidget( new QLabel( "Evaluations:" ), ++s, 0, 1, 3 );
+      ogrid->addWidget( max_evaluations, s, 3, 1, 1 );
+    }
+
+    // The grid is set by its subdivisions and amortization, the other engines by a budget, the
+    // race by both. Levenberg-Marquardt refines a coarse grid and stops when it converges.
+    connect( engine_type, QOverload< int >::of( &QComboBox::currentIndexChanged ), [ this ]( int ) {
+      const bool grid  = engine_type->currentIndex( ) == 0;
+      const bool race  = engine_type->currentIndex( ) == 5;
+      const bool local = engine_type->currentIndex( ) == 6;
+      subdivisions->setEnabled( grid || race || local );
+      amortization->setEnabled( grid || race || local );
+      max_evaluations->setEnabled( !grid && !local );
+    } );
+
+    // fit_joint has the grid contraction only, so it is the engine while any parameter is common
+    for ( auto common_box : { D_common, p_common, DeltaK_thr_common, A_common } )
+    {
+      connect( common_box, &QCheckBox::toggled, [ this ]( bool ) {
+        const bool any_common = D_common->isChecked( ) || p_common->isChecked( )
+                                || DeltaK_thr_common->isChecked( ) || A_common->isChecked( );
+        if ( any_common )
+        {
+          engine_type->setCurrentIndex( 0 );
+        }
+        engine_type->setEnabled( !any_common );
+        engine_type->setToolTip(
+          any_common ? tr( "Common parameters are fitted by the grid contraction only." )
+                     : QString( ) );
+      } );
+    }
+
     {
       norm_type = new QComboBox;
       norm_type->addItem( tr( "Ordinary LS" ) );
       norm_type->addItem( tr( "Total LS" ) );
+      norm_type->addItem( tr( "Total LS (sweep)" ) );
+      norm_type->addItem( tr( "Ordinary (Huber)" ) );
+      norm_type->addItem( tr( "Ordinary (10% trimmed)" ) );
+      norm_type->addItem( tr( "Ordinary (median)" ) );
 
       ogrid->addWidget( new QLabel( "Norm:" ), ++s, 0, 1, 3 );
       ogrid->addWidget( norm_type, s, 3, 1, 1 );
@@ -356,7 +433,7 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
     optim_control_group_box->setLayout( ogrid );
     optim_control_group_box->setTitle( tr( "Global optimization options" ) );
 
-    fgrid->addWidget( optim_control_group_box, ++q, 0, 1, 5 );
+    fgrid->addWidget( optim_control_group_box, ++q, 0, 1, 6 );
 
     auto fit_group_box = new QGroupBox( );
     fit_group_box->setLayout( fgrid );
@@ -547,7 +624,7 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
     compute_individually_action->setIcon( QIcon( "://assets/icons/process.png" ) );
     compute_individually_action->setShortcut( tr( "Ctrl+I" ) );
     compute_individually_action->setStatusTip(
-      tr( "Compute HS parameters individually for each dataset." ) );
+      tr( "Compute HS parameters individually for each dataset, sharing those marked common." ) );
 
     toolbar->addAction( compute_individually_action );
 
@@ -564,6 +641,30 @@ mainWindow::mainWindow( QWidget* parent ) : QMainWindow( parent )
     } );
   }
 
+  {
+    profile_action = new QAction( tr( "Profile" ), this );
+
+    profile_action->setIcon( QIcon( "://assets/icons/process.png" ) );
+    profile_action->setShortcut( tr( "Ctrl+L" ) );
+    profile_action->setStatusTip(
+      tr( "Profile the likelihood of each HS parameter of the fit of all datasets." ) );
+
+    toolbar->addAction( profile_action );
+
+    connect( profile_action, &QAction::triggered, [ this ]( ) {
+      if ( !worker->running( ) )
+      {
+        profile( );
+      }
+      else
+      {
+        worker->stop( );
+      }
+    } );
+
+    profile_action->setEnabled( false );
+  }
+
   {
     to_excel_action = new QAction( tr( "Excel Formula" ), this );
 
@@ -961,6 +1062,8 @@ mainWindow::~mainWindow( )
     qDebug( ) << "Terminating fitting thread.";
     workerThread.terminate( );
   }
+
+  delete profile_plot;
 }
 
 void mainWindow::resizeEvent( QResizeEvent* event )
@@ -1013,17 +1116,12 @@ void mainWindow::fit( bool individually )
 
   computed_graphs.clear( );
 
-  if ( lower_bounds_graph != nullptr )
+  for ( auto g : band_graphs )
   {
-    plot->removeGraph( lower_bounds_graph );
-    lower_bounds_graph = nullptr;
+    plot->removeGraph( g );
   }
 
-  if ( upper_bounds_graph != nullptr )
-  {
-    plot->removeGraph( upper_bounds_graph );
-    upper_bounds_graph = nullptr;
-  }
+  band_graphs.clear( );
 
   auto iline = 0;
   if ( individually )
@@ -1051,6 +1149,7 @@ void mainWindow::fit( bool individually )
     compute_individually_action->setIcon( QIcon( "://assets/icons/process_stop.png" ) );
     compute_individually_action->setText( tr( "Stop" ) );
     compute_action->setEnabled( false );
+    profile_action->setEnabled( false );
   }
   else
   {
@@ -1069,26 +1168,33 @@ void mainWindow::fit( bool individually )
       pen.setStyle( lt.ps );
       g->setPen( pen );
 
+      // Two sigma prediction band, the lower graph filled up to the upper one
+      auto fill = lt.color;
+      fill.setAlpha( 30 );
+
+      auto* lower = plot->addGraph( );
+      lower->setName( QString( "±2σ, R = %1" ).arg( R ) );
+      lower->setPen( QPen( Qt::NoPen ) );
+      lower->setBrush( QBrush( fill ) );
+
+      auto* upper = plot->addGraph( );
+      upper->setPen( QPen( Qt::NoPen ) );
+      upper->removeFromLegend( );
+      lower->setChannelFillGraph( upper );
+
+      band_graphs.push_back( lower );
+      band_graphs.push_back( upper );
+
       if ( iline == standardLineTypes.size( ) )
       {
         iline = 0;
       }
     }
 
-    // Lower and upper fit bounds
-    lower_bounds_graph = plot->addGraph( );
-    lower_bounds_graph->setName( "Lower Opt. Bound" );
-    lower_bounds_graph->setPen( QPen( Qt::gray ) );
-    lower_bounds_graph->setBrush( QBrush( QColor( 0, 0, 255, 20 ) ) );
-
-    upper_bounds_graph = plot->addGraph( );
-    upper_bounds_graph->setName( "Upper Opt. Bound" );
-    upper_bounds_graph->setPen( QPen( Qt::gray ) );
-    lower_bounds_graph->setChannelFillGraph( upper_bounds_graph );
-
     compute_action->setIcon( QIcon( "://assets/icons/process_stop.png" ) );
     compute_action->setText( tr( "Stop" ) );
     compute_individually_action->setEnabled( false );
+    profile_action->setEnabled( false );
   }
 
   auto params_low = hs_parameters_t { D_min->text( ).toDouble( ),
@@ -1101,11 +1207,29 @@ void mainWindow::fit( bool individually )
                                        DeltaK_thr_max->text( ).toDouble( ),
                                        A_max->text( ).toDouble( ) };
 
-  bool use_geometric = false;
+  // Same order as the items of norm_type and engine_type
+  int norm   = norm_type->currentIndex( );
+  int engine = engine_type->currentIndex( );
 
-  if ( norm_type->currentIndex( ) == 1 )
+  // Kept for the covariance and the profiles of the parameters reported by the fit
+  fitted_low_  = params_low;
+  fitted_high_ = params_high;
+  fitted_norm_ = norm;
+
+  fitted_tests_.clear( );
+  if ( !individually )
   {
-    use_geometric = true;
+    for ( const auto& test : tests_to_fit )
+    {
+      cg::test_data_t< real_t > test_data;
+      test_data.R = test.R;
+
+      for ( const auto point : test.points )
+      {
+        test_data.points.push_back( { real_t { point.DeltaK }, real_t { point.dadN } } );
+      }
+      fitted_tests_.emplace_back( std::move( test_data ) );
+    }
   }
 
   new_file_action->setEnabled( false );
@@ -1118,21 +1242,112 @@ void mainWindow::fit( bool individually )
                                                DeltaK_thr_max_auto->isChecked( ),
                                                A_min_auto->isChecked( ),
                                                A_max_auto->isChecked( ) };
+
+  auto common = hs_common_t { D_common->isChecked( ),
+                              p_common->isChecked( ),
+                              DeltaK_thr_common->isChecked( ),
+                              A_common->isChecked( ) };
+
   QMetaObject::invokeMethod( worker,
                              "run",
                              Q_ARG( hs_parameters_t, params_low ),
                              Q_ARG( hs_parameters_t, params_high ),
                              Q_ARG( int, subdivisions->text( ).toInt( ) ),
                              Q_ARG( double, amortization->text( ).toDouble( ) ),
-                             Q_ARG( bool, use_geometric ),
+                             Q_ARG( int, norm ),
+                             Q_ARG( int, engine ),
+                             Q_ARG( int, max_evaluations->text( ).toInt( ) ),
                              Q_ARG( std::vector< test_data_t >, tests_to_fit ),
                              Q_ARG( Hartman_Schijve_autoRange, autoRange ),
-                             Q_ARG( bool, individually ) );
+                             Q_ARG( bool, individually ),
+                             Q_ARG( hs_common_t, common ) );
+}
+
+void mainWindow::profile( )
+{
+  if ( fitted_tests_.empty( ) || computed_.size( ) != 1 )
+  {
+    return;
+  }
+
+  if ( profile_plot == nullptr )
+  {
+    profile_plot = new QCustomPlot( );
+    profile_plot->setWindowTitle( tr( "Profile likelihood" ) );
+    profile_plot->resize( 900, 700 );
+    profile_plot->plotLayout( )->clear( );
+
+    for ( std::size_t k = 0; k != 4; k++ )
+    {
+      auto* rect = new QCPAxisRect( profile_plot );
+      profile_plot->plotLayout( )->addElement( int( k / 2 ), int( k % 2 ), rect );
+
+      auto* x = rect->axis( QCPAxis::atBottom );
+      auto* y = rect->axis( QCPAxis::atLeft );
+      y->setLabel( tr( "Deviance" ) );
+
+      if ( k == 0 )
+      {
+        QSharedPointer< QCPAxisTickerLog > logTicker( new QCPAxisTickerLog );
+        x->setTicker( logTicker );
+        x->setScaleType( QCPAxis::stLogarithmic );
+      }
+
+      profile_graphs[ k ] = profile_plot->addGraph( x, y );
+
+      auto pen = profile_graphs[ k ]->pen( );
+      pen.setWidthF( 2.0f );
+      pen.setColor( standardLineTypes[ 0 ].color );
+      profile_graphs[ k ]->setPen( pen );
+      profile_graphs[ k ]->setScatterStyle( QCPScatterStyle( QCPScatterStyle::ssDisc, 4 ) );
+
+      threshold_graphs[ k ] = profile_plot->addGraph( x, y );
+      threshold_graphs[ k ]->setPen( QPen( Qt::gray, 1.0, Qt::DashLine ) );
+    }
+  }
+
+  for ( auto* g : profile_graphs )
+  {
+    g->data( )->clear( );
+  }
+
+  for ( auto* g : threshold_graphs )
+  {
+    g->data( )->clear( );
+  }
+
+  profile_plot->show( );
+  profile_plot->raise( );
+
+  new_file_action->setEnabled( false );
+  control_widget->setEnabled( false );
+  open_file_action->setEnabled( false );
+  save_file_action->setEnabled( false );
+  compute_action->setEnabled( false );
+  compute_individually_action->setEnabled( false );
+
+  profile_action->setIcon( QIcon( "://assets/icons/process_stop.png" ) );
+  profile_action->setText( tr( "Stop" ) );
+
+  // Not through pull_tests_list, which would change the Rs of the computed curves
+  std::vector< test_data_t > tests_to_profile;
+  for ( const auto& test : tests_list->tests( ) )
+  {
+    tests_to_profile.push_back( test.data );
+  }
+
+  QMetaObject::invokeMethod( worker,
+                             "profile",
+                             Q_ARG( hs_parameters_t, fitted_low_ ),
+                             Q_ARG( hs_parameters_t, fitted_high_ ),
+                             Q_ARG( hs_parameters_t, computed_[ 0 ] ),
+                             Q_ARG( int, fitted_norm_ ),
+                             Q_ARG( std::vector< test_data_t >, tests_to_profile ) );
 }
 
 void mainWindow::handleResults( hs_parameters_t params,
-                                hs_parameters_t params_lower,
-                                hs_parameters_t params_upper )
+                                hs_parameters_t /*params_lower*/,
+                                hs_parameters_t /*params_upper*/ )
 {
   if ( computed_.size( ) != 1 )
   {
@@ -1154,15 +1369,10 @@ void mainWindow::handleResults( hs_parameters_t params,
     return std::make_tuple( DKs, dadNs );
   };
 
-  std::size_t c    = 0;
-  real_t      Rmin = 1.0;
-  real_t      Rmax = -1.0;
+  std::size_t c = 0;
 
   for ( real_t R : Rs )
   {
-    Rmin = std::min( R, Rmin );
-    Rmax = std::max( R, Rmax );
-
     {
       auto [ DKs, dadNs ] = generate_hs_curve( params, R );
 
@@ -1187,33 +1397,11 @@ void mainWindow::handleResults( hs_parameters_t params,
                                        .arg( x_quantity_label->text( ) )
                                        .arg( double( params.DeltaK_thr ), 0, 'g', 3 )
                                        .arg( double( params.A ), 0, 'g', 3 ) );
+
       c++;
     }
   }
 
-  // TODO: replacements to correct for the virtual abberations think a bit about this
-  params_lower.D = params.D;
-  params_lower.p = params.p;
-  params_upper.D = params.D;
-  params_upper.p = params.p;
-
-  auto [ DKs1, dadNs1 ] = generate_hs_curve( params_lower, Rmax );
-  auto [ DKs2, dadNs2 ] = generate_hs_curve( params_upper, Rmin );
-
-  if ( std::isnan( double( dadNs2[ 0 ] ) ) )
-  {
-    dadNs2[ 0 ] = 0;
-  }
-
-  DKs2.insert( DKs2.begin( ), DKs1[ 0 ] ); // So we can force QCustomplot to fill the area.
-  dadNs2.insert( dadNs2.begin( ), dadNs1[ 0 ] );
-
-  DKs1.push_back( *DKs2.rbegin( ) );
-  dadNs1.push_back( *dadNs2.rbegin( ) );
-
-  this->setLow( DKs1, dadNs1 );
-  this->setHigh( DKs2, dadNs2 );
-
   rescale_plot( );
 
   plot->replot( );
@@ -1311,6 +1499,52 @@ void mainWindow::handleIndividualResults( hs_parameters_t params,
   plot->replot( );
 }
 
+// Of the curves of the last fit of all tests together. Once it has finished, as the covariance is
+// too costly for every intermediate result, and only if the band graphs are still empty, as they
+// are made anew by every fit.
+void mainWindow::update_prediction_band( )
+{
+  if ( band_graphs.empty( ) || fitted_tests_.empty( ) || computed_graphs[ 0 ]->data( )->isEmpty( )
+       || !band_graphs[ 0 ]->data( )->isEmpty( ) )
+  {
+    return;
+  }
+
+  const auto& params = computed_[ 0 ];
+
+  const auto covariance
+    = cg::Hartman_Schijve::covariance( fitted_low_, fitted_high_, fitted_tests_, params );
+
+  auto to_qvector = []( const auto& values ) {
+    QVector< double > result;
+    for ( auto v : values )
+    {
+      result.push_back( double( v ) );
+    }
+    return result;
+  };
+
+  std::size_t c = 0;
+
+  for ( real_t R : Rs )
+  {
+    QVector< double >     xs;
+    std::vector< real_t > DKs;
+    for ( const auto& point : *computed_graphs[ c ]->data( ) )
+    {
+      xs.push_back( point.key );
+      DKs.push_back( point.key );
+    }
+
+    auto [ lower, upper ] = cg::Hartman_Schijve::prediction_band( params, covariance, R, DKs );
+
+    band_graphs[ 2 * c ]->setData( xs, to_qvector( lower ), true );
+    band_graphs[ 2 * c + 1 ]->setData( xs, to_qvector( upper ), true );
+
+    c++;
+  }
+}
+
 void mainWindow::handle_fitting_finished( )
 {
   new_file_action->setEnabled( true );
@@ -1326,13 +1560,13 @@ void mainWindow::handle_fitting_finished( )
   compute_individually_action->setText( tr( "Compute Individually" ) );
   compute_individually_action->setEnabled( true );
 
-  progressBar->hide( );
+  profile_action->setIcon( QIcon( "://assets/icons/process.png" ) );
+  profile_action->setText( tr( "Profile" ) );
+  profile_action->setEnabled( !fitted_tests_.empty( ) );
 
-  // plot->removeGraph( lower_bounds_graph );
-  //  lower_bounds_graph = nullptr;
+  progressBar->hide( );
 
-  // plot->removeGraph( upper_bounds_graph );
-  // upper_bounds_graph = nullptr;
+  update_prediction_band( );
 
   rescale_plot( );
   plot->replot( );
@@ -1416,6 +1650,56 @@ void mainWindow::handleProgressReport( int i, int total )
   //  }
 }
 
+void mainWindow::handle_profiles( hs_profiles_t profiles )
+{
+  if ( profile_plot == nullptr )
+  {
+    return;
+  }
+
+  const QString names[] = { "D", "p", x_quantity_label->text( ) + "ₜₕᵣ", "A" };
+
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    const auto& profile = profiles[ k ];
+
+    if ( profile.values.empty( ) )
+    {
+      continue;
+    }
+
+    QVector< double > xs, ys;
+    for ( std::size_t j = 0; j != profile.values.size( ); j++ )
+    {
+      xs.push_back( double( profile.values[ j ] ) );
+      ys.push_back( double( profile.deviances[ j ] ) );
+    }
+
+    profile_graphs[ k ]->setData( xs, ys, true );
+
+    const double threshold = double( profile.threshold );
+    threshold_graphs[ k ]->setData(
+      { xs.front( ), xs.back( ) }, { threshold, threshold }, true );
+
+    // Open ends of the interval are where the scan stopped within the threshold
+    auto bound = [ & ]( bool open, const real_t& value ) {
+      return open ? QString( "…" ) : QString( "%1" ).arg( double( value ), 0, 'g', 4 );
+    };
+
+    auto* x = profile_graphs[ k ]->keyAxis( );
+    x->setLabel( QString( "%1 ∈ [%2, %3]" )
+                   .arg( names[ k ] )
+                   .arg( bound( profile.lower_open, profile.lower ) )
+                   .arg( bound( profile.upper_open, profile.upper ) ) );
+    x->setRange( xs.front( ), xs.back( ) );
+
+    // The deviance far outside the interval, or where the curve leaves the data, is of no interest
+    profile_graphs[ k ]->valueAxis( )->setRange( 0.0, 5.0 * threshold );
+  }
+
+  profile_plot->replot( );
+}
+
 void mainWindow::remove_test( int index )
 {
   if ( tests_graph_map.size( ) > index )
@@ -78,47 +78,6 @@ public:
 
   ~mainWindow( );
 
-  template< class T >
-  void setLow( const std::vector< T >& DeltaKs, const std::vector< T >& dadNs )
-  {
-
-    QVector< double > xs;
-    for ( auto x : DeltaKs )
-    {
-      xs.push_back( double( x ) );
-    }
-
-    QVector< double > ys;
-    for ( auto y : dadNs )
-    {
-      ys.push_back( double( y ) );
-    }
-
-    lower_bounds_graph->setData( xs, ys, true );
-  }
-
-  template< class T >
-  void setHigh( const std::vector< T >& DeltaKs, const std::vector< T >& dadNs )
-  {
-
-    QVector< double > xs;
-    for ( auto x : DeltaKs )
-    {
-      xs.push_back( double( x ) );
-    }
-
-    QVector< double > ys;
-    for ( auto y : dadNs )
-    {
-      ys.push_back( double( y ) );
-    }
-
-    upper_bounds_graph->setData( xs, ys, true );
-
-    plot->xAxis->setRange( 0, 20 );
-    plot->yAxis->setRange( 1e-13, 1e-4 );
-  }
-
 signals:
   void operate( );
 
@@ -131,6 +90,8 @@ private slots:
 
   void fit( bool individually = false );
 
+  void profile( );
+
   void handleResults( hs_parameters_t params,
                       hs_parameters_t params_lower,
                       hs_parameters_t params_upper );
@@ -142,6 +103,8 @@ private slots:
 
   void handleProgressReport( int i, int total );
 
+  void handle_profiles( hs_profiles_t profiles );
+
   void update_test( int index );
 
   void handle_selected_test_changed( int index );
@@ -189,6 +152,8 @@ private:
 
   void insert_graph( int index );
 
+  void update_prediction_band( );
+
 
   QString current_directory_;
 
@@ -203,31 +168,38 @@ private:
   QAction* save_file_action;
   QAction* compute_action;
   QAction* compute_individually_action;
+  QAction* profile_action;
   QAction* to_excel_action;
   QAction* to_tabulated_action;
 
   QLineEdit* D_min;
   QLineEdit* D_max;
+  QCheckBox* D_common;
 
   QLineEdit* p_min;
   QLineEdit* p_max;
+  QCheckBox* p_common;
 
   QLineEdit* DeltaK_thr_min;
   QCheckBox* DeltaK_thr_min_auto;
 
   QLineEdit* DeltaK_thr_max;
   QCheckBox* DeltaK_thr_max_auto;
+  QCheckBox* DeltaK_thr_common;
 
   QLineEdit* A_min;
   QCheckBox* A_min_auto;
 
   QLineEdit* A_max;
   QCheckBox* A_max_auto;
+  QCheckBox* A_common;
 
   QLineEdit* subdivisions;
   QLineEdit* amortization;
+  QLineEdit* max_evaluations;
 
   QComboBox* norm_type;
+  QComboBox* engine_type;
 
   decorated_double_spinbox* font_size_spinbox;
   decorated_int_spinbox*    legend_columns_spinbox;
@@ -258,8 +230,19 @@ private:
   QVector< QCPGraph* > computed_graphs;
   std::set< real_t >   Rs;
 
-  QCPGraph* lower_bounds_graph = nullptr;
-  QCPGraph* upper_bounds_graph = nullptr;
+  // Lower and upper graph of the prediction band of every R
+  std::vector< QCPGraph* > band_graphs;
+
+  // Of the last fit of all tests together, empty after fitting them individually
+  std::vector< crack_growth::test_data_t< real_t > > fitted_tests_;
+  hs_parameters_t                                    fitted_low_;
+  hs_parameters_t                                    fitted_high_;
+  int                                                fitted_norm_ = 0;
+
+  // Window of the profiles of the parameters: the deviance and its threshold of every parameter
+  QCustomPlot*               profile_plot = nullptr;
+  std::array< QCPGraph*, 4 > profile_graphs { };
+  std::array< QCPGraph*, 4 > threshold_graphs { };
 
   int previously_selected_graph_index = -1;
 
@@ -40,15 +40,26 @@
 
 #pragma once
 
+#include "cmaes.hpp"
+#include "differential_evolution.hpp"
+#include "dual.hpp"
+#include "fast_math.hpp"
 #include "nelder_mead.hpp"
+#include "sampling.hpp"
+#include "surrogate.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cmath>
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <mutex>
+#include <numeric>
+#include <random>
 #include <thread>
 #include <tuple>
 #include <type_traits>
@@ -57,8 +68,6 @@
 inline int        totalevals = 0;
 inline std::mutex stdoutmutex;
 
-#define HS_MAX_ITERS 60
-
 namespace cuhyso
 {
 
@@ -172,7 +181,39 @@ bool generate_eval_set( F&&                  f,
   return !stop_requested;
 }
 
-template< class T, class F, class ParamList >
+// Candidates of a round by one of the samplers of sample_unit_cube, budget of them, or
+// subdivisions^N for a budget of zero
+template< class List >
+void generate_sampled_set( const List&          low,
+                           const List&          high,
+                           std::size_t          subdivisions,
+                           sampler_t            sampler,
+                           std::size_t          budget,
+                           unsigned             round,
+                           std::vector< List >& eval_set )
+{
+  const auto num_params = low.size( );
+
+  if ( budget == 0 )
+  {
+    budget = std::pow( subdivisions, num_params );
+  }
+
+  for ( const auto& u : sample_unit_cube( sampler, num_params, budget, round ) )
+  {
+    auto params = low;
+    for ( std::size_t k = 0; k != num_params; k++ )
+    {
+      params[ k ] = low[ k ] + u[ k ] * ( high[ k ] - low[ k ] );
+    }
+    eval_set.push_back( params );
+  }
+}
+
+// f( params ) or, to keep per thread state, f( params, thread ) with the index of the calling
+// thread. new_min_callback( params, low, high ) receives each new minimum, and its value too if it
+// takes a fourth argument.
+template< class T, class F, class ParamList, class Callback = callback_t< ParamList > >
 void minimize(
   F&&                     f,
   ParamList               low,
@@ -180,14 +221,21 @@ void minimize(
   const std::size_t&      subdivisions,
   const T&                amortization,
   std::atomic_bool&       stop_requested,
-  callback_t< ParamList > new_min_callback  = []( ParamList, ParamList, ParamList ) {},
+  Callback                new_min_callback  = []( ParamList, ParamList, ParamList ) {},
   progress_callback_t     progress_callback = []( std::size_t, std::size_t ) {},
   std::size_t             iterations        = 0,
-  const std::size_t&      num_threads       = std::thread::hardware_concurrency( ) )
+  const std::size_t&      num_threads       = std::thread::hardware_concurrency( ),
+  sampler_t               sampler           = sampler_t::grid,
+  std::size_t             budget            = 0 )
 {
 
   using namespace std::chrono;
 
+  if ( sampler == sampler_t::adaptive_grid )
+  {
+    throw std::runtime_error( "The adaptive grid is available in fit only." );
+  }
+
   stop_requested = false;
 
   if ( iterations == 0 )
@@ -199,7 +247,9 @@ void minimize(
 
   ParamList params;
 
-  std::atomic< T > minVal = std::numeric_limits< T >::max( );
+  // Guarded by minListMutex. Each thread compares with the value it last saw, and locks only if it
+  // improves on that, which keeps long double free of atomics.
+  T minVal = std::numeric_limits< T >::max( );
 
   ParamList  minList;
   std::mutex minListMutex;
@@ -218,8 +268,17 @@ void minimize(
 
   for ( auto i = 0; i != iterations; i++ )
   {
-    generate_eval_set< T >(
-      std::forward< F >( f ), low, high, subdivisions, eval_set, stop_requested, params );
+    eval_set.clear( );
+
+    if ( sampler == sampler_t::grid )
+    {
+      generate_eval_set< T >(
+        std::forward< F >( f ), low, high, subdivisions, eval_set, stop_requested, params );
+    }
+    else
+    {
+      generate_sampled_set( low, high, subdivisions, sampler, budget, i, eval_set );
+    }
 
     std::vector< std::unique_ptr< std::atomic_bool > > thread_finished( num_threads );
     for ( std::size_t i = 0; i != num_threads; i++ )
@@ -258,16 +317,42 @@ void minimize(
 //          }
 //        }
 
+        T seen = std::numeric_limits< T >::max( );
+
         for ( auto i = tid; i < eval_set.size( ); i += num_threads )
         {
           const auto& p = eval_set[ i ];
-          auto        v = f( p );
-          if ( v < minVal )
+
+          T v;
+          if constexpr ( std::is_invocable_v< F&, const ParamList&, std::size_t > )
+          {
+            v = f( p, tid );
+          }
+          else
+          {
+            v = f( p );
+          }
+          if ( v < seen )
           {
             minListMutex.lock( );
-            minVal  = v;
-            minList = p;
-            new_min_callback( p, low, high );
+            if ( v < minVal )
+            {
+              minVal  = v;
+              minList = p;
+              if constexpr ( std::is_invocable_v< Callback&,
+                                                  const ParamList&,
+                                                  const ParamList&,
+                                                  const ParamList&,
+                                                  const T& > )
+              {
+                new_min_callback( p, low, high, v );
+              }
+              else
+              {
+                new_min_callback( p, low, high );
+              }
+            }
+            seen = minVal;
             minListMutex.unlock( );
           }
         }
@@ -324,6 +409,7 @@ struct data_point_t
 {
   T DeltaK;
   T dadN;
+  T weight = 1.0; // Number of points represented, see compress_test_set
 };
 
 template< class T >
@@ -360,6 +446,97 @@ T computeAxesScale( const Container_t& test_set )
          / ( std::log10( DKmax ) - std::log10( std::max( DKmin, T( 1e-19 ) ) ) );
 }
 
+// Coreset of a test set, for fitting large data sets. The points of every test are binned in
+// square cells of cell_size in the space of the distance, log10( DeltaK ) by scale * log10( da/dN )
+// with the scale of computeAxesScale. The points of a cell are replaced by one at their weighted
+// mean in that space, which carries their total weight. The points with the extreme DeltaK and
+// da/dN of the set are kept as they are, so the compressed set has the same axes scale.
+//
+// No point moves by more than h = cell_size * sqrt( 2 ) in that space. The distance to the curve
+// of the geometric norm is 1-Lipschitz there, so its objective F changes by at most
+// h * ( 2 * sqrt( F ) + h ). A residual of the ordinary norm changes by at most
+// cell_size * ( 1 / scale + s ), s being the largest log-log slope of the model over the cell.
+template< typename T, class Container_t >
+Container_t compress_test_set( const Container_t& test_set, const T& cell_size )
+{
+  const T scale = computeAxesScale< T >( test_set );
+
+  // Test and point indices of the extremes
+  using index_t = std::pair< std::size_t, std::size_t >;
+
+  index_t DKmin { 0, 0 }, DKmax { 0, 0 }, dadNmin { 0, 0 }, dadNmax { 0, 0 };
+
+  auto point_at = [ & ]( const index_t& index ) -> const auto& {
+    return test_set[ index.first ].points[ index.second ];
+  };
+
+  for ( std::size_t t = 0; t != test_set.size( ); t++ )
+  {
+    for ( std::size_t i = 0; i != test_set[ t ].points.size( ); i++ )
+    {
+      const auto& point = test_set[ t ].points[ i ];
+      const index_t index { t, i };
+
+      DKmin   = point.DeltaK < point_at( DKmin ).DeltaK ? index : DKmin;
+      DKmax   = point.DeltaK > point_at( DKmax ).DeltaK ? index : DKmax;
+      dadNmin = point.dadN < point_at( dadNmin ).dadN ? index : dadNmin;
+      dadNmax = point.dadN > point_at( dadNmax ).dadN ? index : dadNmax;
+    }
+  }
+
+  struct cell_t
+  {
+    T weight = 0.0;
+    T x      = 0.0; // Weighted sums of log10( DeltaK ) and log10( da/dN )
+    T y      = 0.0;
+  };
+
+  Container_t compressed;
+
+  for ( std::size_t t = 0; t != test_set.size( ); t++ )
+  {
+    const auto& test = test_set[ t ];
+
+    auto compressed_test = test;
+    compressed_test.points.clear( );
+
+    std::map< std::pair< long long, long long >, cell_t > cells;
+
+    for ( std::size_t i = 0; i != test.points.size( ); i++ )
+    {
+      const auto& point = test.points[ i ];
+      const index_t index { t, i };
+
+      if ( index == DKmin || index == DKmax || index == dadNmin || index == dadNmax )
+      {
+        compressed_test.points.push_back( point );
+        continue;
+      }
+
+      const T x = std::log10( point.DeltaK );
+      const T y = std::log10( point.dadN );
+
+      auto& cell = cells[ { ( long long )( std::floor( x / cell_size ) ),
+                            ( long long )( std::floor( scale * y / cell_size ) ) } ];
+
+      cell.weight += point.weight;
+      cell.x += point.weight * x;
+      cell.y += point.weight * y;
+    }
+
+    for ( const auto& [ key, cell ] : cells )
+    {
+      compressed_test.points.push_back( { std::pow( T( 10.0 ), cell.x / cell.weight ),
+                                          std::pow( T( 10.0 ), cell.y / cell.weight ),
+                                          cell.weight } );
+    }
+
+    compressed.push_back( compressed_test );
+  }
+
+  return compressed;
+}
+
 namespace CUHYSO
 {
 // template< class Parameters, class F >
@@ -404,6 +581,195 @@ struct Model_Distance_t
 template< class T >
 using callback_t = std::function< void( parameters< T >, parameters< T >, parameters< T > ) >;
 
+namespace detail
+{
+
+// Objective of the engines, in which utilization is preferred over minimization through a penalty
+// on the rejected weight
+template< class T >
+T penalized( const Model_Distance_t< T >& d )
+{
+  return d.distance + T( 1000000.0 ) * T( 1.0 - d.utilization );
+}
+
+// Threads of the fits
+inline std::size_t thread_count( )
+{
+  return std::max( ( unsigned int )( 4 ), std::thread::hardware_concurrency( ) );
+}
+
+// computeAxesScale of the test set, which the fits reject if it is not within ten orders of
+// magnitude of one
+template< class T, class Container_t >
+T checked_scale( const Container_t& test_set )
+{
+  const T scale = computeAxesScale< T >( test_set );
+
+  if ( scale < 1.0e-10 || scale > 1.0e10 )
+  {
+    throw std::runtime_error( "Test data relative scales vary orders of magnitude." );
+  }
+
+  return scale;
+}
+
+} // namespace detail
+
+// How the distances of the data points are combined into the objective. huber averages the Huber
+// loss of the distances, trimmed averages the distances without the largest trimmed_fraction of
+// them, median takes their median.
+enum class aggregation_t
+{
+  mean,
+  huber,
+  trimmed,
+  median
+};
+
+// Norm policies. Everything the objective kernel branches on is a compile time constant so that
+// the grid loop of fit gets a fully specialized instantiation per norm.
+struct ordinary_norm
+{
+  static constexpr bool          geometric   = false;
+  static constexpr bool          sweep       = false;
+  static constexpr aggregation_t aggregation = aggregation_t::mean;
+
+  // Fidelity schedule of fit, see fidelity_schedule
+  static constexpr double      coarse_tolerance_scale = 1.0;
+  static constexpr double      full_tolerance_box     = 1.0;
+  static constexpr std::size_t coarse_stride          = 8;
+  static constexpr double      full_stride_box        = 0.03;
+  static constexpr std::size_t min_subsample          = 500; // Points per test
+};
+
+struct geometric_norm
+{
+  static constexpr bool          geometric   = true;
+  static constexpr bool          sweep       = false;
+  static constexpr aggregation_t aggregation = aggregation_t::mean;
+
+  static constexpr std::size_t max_iterations = 60;
+  static constexpr double      tolerance      = 1.0e-4; // Relative to the log10 span of the bracket
+
+  // Squared offset along the tangent, relative to the squared distance, up to which the closed form
+  // of minimum_distance2 is used instead of the root solver. Zero disables it.
+  static constexpr double closed_form_tolerance = 1.0e-3;
+
+  static constexpr double      coarse_tolerance_scale = 100.0;
+  static constexpr double      full_tolerance_box     = 1.0e-2;
+  static constexpr std::size_t coarse_stride          = 8;
+  static constexpr double      full_stride_box        = 0.03;
+  static constexpr std::size_t min_subsample          = 500; // Points per test
+};
+
+// Geometric norm evaluated by tabulating the curve of a candidate once per R and sweeping the data
+// points of that R, sorted by DeltaK, along it. Lengths are in the scaled log10 space of the
+// distance.
+struct geometric_sweep_norm
+{
+  static constexpr bool          geometric   = true;
+  static constexpr bool          sweep       = true;
+  static constexpr aggregation_t aggregation = aggregation_t::mean;
+
+  static constexpr std::size_t initial_samples = 16;
+  static constexpr double      max_segment     = 0.5;
+  static constexpr double      max_deviation   = 5.0e-3; // Of the curve from the segment chord
+
+  static constexpr double      coarse_tolerance_scale = 1.0;
+  static constexpr double      full_tolerance_box     = 1.0;
+  static constexpr std::size_t coarse_stride          = 8;
+  static constexpr double      full_stride_box        = 0.03;
+  static constexpr std::size_t min_subsample          = 500; // Points per test
+};
+
+// Robust variants of the ordinary norm. Residuals are in log10( da/dN ).
+struct ordinary_huber_norm : ordinary_norm
+{
+  static constexpr aggregation_t aggregation = aggregation_t::huber;
+  static constexpr double        huber_delta = 0.1; // Quadratic below, linear above
+};
+
+struct ordinary_trimmed_norm : ordinary_norm
+{
+  static constexpr aggregation_t aggregation      = aggregation_t::trimmed;
+  static constexpr double        trimmed_fraction = 0.1;
+};
+
+struct ordinary_median_norm : ordinary_norm
+{
+  static constexpr aggregation_t aggregation = aggregation_t::median;
+};
+
+// Fidelity of an objective evaluation. At reduced fidelity the root solver of the geometric norm
+// stops at a looser tolerance, the closed form is accepted further from the foot point, and only
+// every stride-th data point of each test, in order of DeltaK, is visited. The subsample is
+// stratified so that every test is sampled across its DeltaK range.
+struct fidelity_t
+{
+  double      tolerance_scale = 1.0;
+  std::size_t stride          = 1;
+
+  bool full( ) const { return tolerance_scale == 1.0 && stride == 1; }
+
+  bool visits( const std::size_t& rank ) const { return rank % stride == 0; }
+};
+
+// Fidelity at which fit evaluates the grid, for a search box whose widths are box_fraction of the
+// initial widths (the largest ratio among the axes). The tolerance is relaxed in proportion to the
+// box above full_tolerance_box, up to coarse_tolerance_scale, and the stride likewise above
+// full_stride_box, up to coarse_stride. As the box contracts geometrically, the subsample grows
+// geometrically to the full data. No test is subsampled below min_subsample points, so that small
+// data sets, where the subsample would steer the contraction elsewhere, are always used in full.
+template< class Norm >
+fidelity_t fidelity_schedule( const double& box_fraction, const std::size_t& smallest_test )
+{
+  fidelity_t fidelity;
+
+  fidelity.tolerance_scale = std::clamp(
+    box_fraction / Norm::full_tolerance_box, 1.0, double( Norm::coarse_tolerance_scale ) );
+
+  const auto max_stride = std::min( Norm::coarse_stride, smallest_test / Norm::min_subsample );
+
+  fidelity.stride = std::clamp( std::size_t( box_fraction / Norm::full_stride_box ),
+                                std::size_t( 1 ),
+                                std::max( max_stride, std::size_t( 1 ) ) );
+
+  return fidelity;
+}
+
+enum class norm_t
+{
+  ordinary,
+  geometric,
+  geometric_sweep,
+  ordinary_huber,
+  ordinary_trimmed,
+  ordinary_median
+};
+
+// Calls f with the policy of norm, so that the kernels are specialized for it
+template< class F >
+decltype( auto ) dispatch_norm( norm_t norm, F&& f )
+{
+  switch ( norm )
+  {
+  case norm_t::geometric:
+    return f( geometric_norm { } );
+  case norm_t::geometric_sweep:
+    return f( geometric_sweep_norm { } );
+  case norm_t::ordinary_huber:
+    return f( ordinary_huber_norm { } );
+  case norm_t::ordinary_trimmed:
+    return f( ordinary_trimmed_norm { } );
+  case norm_t::ordinary_median:
+    return f( ordinary_median_norm { } );
+  case norm_t::ordinary:
+    break;
+  }
+
+  return f( ordinary_norm { } );
+}
+
 using progress_callback_t = std::function< void( std::size_t, std::size_t ) >;
 
 template< class T >
@@ -412,18 +778,20 @@ T calc_K_max( const parameters< T >& params, const T& R )
   return params.A * ( T { 1.0 } - R );
 }
 
-template< class T >
+// Math is a policy of fast_math.hpp. approximate_math trades accuracy for speed. The fits and the
+// objective functions evaluate the model through curve_t, with std_math only.
+template< class T, class Math = fast_math::std_math >
 T evaluate( const T& D, const T& p, const T& DeltaK_thr, const T& A, const T& R, const T& DeltaK )
 {
   auto s = DeltaK / ( A * ( T { 1.0 } - R ) );
 
-  return D * std::pow( ( DeltaK - DeltaK_thr ) / ( std::sqrt( 1.0 - s ) ), p );
+  return D * Math::pow( ( DeltaK - DeltaK_thr ) / ( Math::sqrt( T( 1.0 - s ) ) ), p );
 }
 
-template< class T >
+template< class T, class Math = fast_math::std_math >
 T evaluate( const parameters< T >& params, const T& R, const T& DeltaK )
 {
-  return evaluate( params.D, params.p, params.DeltaK_thr, params.A, R, DeltaK );
+  return evaluate< T, Math >( params.D, params.p, params.DeltaK_thr, params.A, R, DeltaK );
 }
 
 template< class T, class Container_t >
@@ -442,7 +810,7 @@ Container_t evaluate( const parameters< T >& params, const T& R, const Container
 // two axes. I think this needs finding the horizontal intersection (i.e. the line with constant
 // dadNi), which is the minimization we need to perform because the other distance can be directly
 // evaluated from the function
-template< class T >
+template< class T, class Math = fast_math::std_math >
 T DistanceScaled( const T& DeltaK,
                   const T& DeltaKi,
                   const T& dadNi,
@@ -453,20 +821,19 @@ T DistanceScaled( const T& DeltaK,
                   const T& A,
                   const T& sc )
 {
+  auto square = []( const T& x ) { return x * x; };
+
+  const T base
+    = ( DeltaK - 1. * DeltaKthr ) / Math::sqrt( T( 1. + DeltaK / ( A * ( -1. + R ) ) ) );
 
   return 0.18861169701161387
-         * ( pow( log( DeltaK ) - 1. * log( DeltaKi ), 2 )
-             + pow( sc, 2 )
-                 * pow( log( dadNi )
-                          - 1.
-                              * log( DD
-                                     * pow( ( DeltaK - 1. * DeltaKthr )
-                                              / sqrt( 1. + DeltaK / ( A * ( -1. + R ) ) ),
-                                            p ) ),
-                        2 ) );
+         * ( square( Math::log( DeltaK ) - 1. * Math::log( DeltaKi ) )
+             + square( sc )
+                 * square( Math::log( dadNi )
+                           - 1. * Math::log( T( DD * Math::pow( base, p ) ) ) ) );
 }
 
-template< class T >
+template< class T, class Math = fast_math::std_math >
 T DistanceDeriv( const T& DeltaK,
                  const T& DeltaKi,
                  const T& dadNi,
@@ -480,709 +847,4666 @@ T DistanceDeriv( const T& DeltaK,
   T S1 = -1. + R;
   T S2 = DeltaK - DeltaKthr;
 
+  const T base = S2 / Math::sqrt( T( 1. + DeltaK / ( A * S1 ) ) );
+
   return 0.18861169701161387
-         * ( ( 2. * ( log( DeltaK ) - 1. * log( DeltaKi ) ) ) / DeltaK
-             - ( 1. * p * ( DeltaK + DeltaKthr + 2. * A * S1 ) * pow( sc, 2 )
-                 * ( log( dadNi )
-                     - 1. * log( DD * pow( S2 / sqrt( 1. + DeltaK / ( A * S1 ) ), p ) ) ) )
+         * ( ( 2. * ( Math::log( DeltaK ) - 1. * Math::log( DeltaKi ) ) ) / DeltaK
+             - ( 1. * p * ( DeltaK + DeltaKthr + 2. * A * S1 ) * sc * sc
+                 * ( Math::log( dadNi ) - 1. * Math::log( T( DD * Math::pow( base, p ) ) ) ) )
                  / ( ( DeltaK + A * S1 ) * S2 ) );
 }
 
-// todo: this needs more work and although CUHYSO works, others don't in test4.
-template< typename T >
-auto minimum_distance2( const T& DeltaKi,
-                        const T& dadNi,
-                        const T& R,
-                        const T& DD,
-                        const T& p,
-                        const T& DeltaKthr,
-                        const T& A,
-                        const T& scale )
-{
-
-  T S1 = T( 1.0 ) / A;
-  T S2 = T( 1.0 ) / ( -1. + R );
-  T S3 = pow( dadNi / DD, 2. / p );
-
-  T v
-    = 0.03557437224960084 * pow( scale, 2 )
-      * pow(
-        log( dadNi )
-          - 1.
-              * log( DD * pow( ( DeltaKi - 1. * DeltaKthr ) / sqrt( 1. + DeltaKi * S1 * S2 ), p ) ),
-        2 )
-      * pow( log( DeltaKi )
-               - 1.
-                   * log( 0.5
-                          * ( 2. * DeltaKthr + S1 * S2 * S3
-                              + sqrt( 4. * ( -1. * pow( DeltaKthr, 2 ) + S3 )
-                                      + pow( -2. * DeltaKthr + S3 / ( A - 1. * A * R ), 2 ) ) ) ),
-             2 );
-
-  return std::make_tuple( v, std::size_t( 0 ) );
-}
+// Test set prepared for the objective function. The points of all tests with the same R are merged
+// into a contiguous block and sorted by DeltaK. Each point carries the natural logs of its
+// coordinates, the index of its test and its rank among the points of that test.
+template< class T >
+struct prepared_point_t
+{
+  T           DeltaK;
+  T           dadN;
+  T           log_DeltaK;
+  T           log_dadN;
+  std::size_t test;
+  T           weight = 1.0;
+  std::size_t rank   = 0; // In order of DeltaK, for the subsamples of fidelity_t
+};
 
-template< typename T >
-std::tuple< T, std::size_t > minimum_distance( const T& DeltaKi,
-                                               const T& dadNi,
-                                               const T& R,
-                                               const T& DD,
-                                               const T& p,
-                                               const T& DeltaKthr,
-                                               const T& A,
-                                               const T& scale )
+template< class T >
+struct prepared_test_set_t
 {
-  if ( dadNi < 1e-17 )
+  struct block_t
   {
-    return std::make_tuple( DeltaKthr, std::size_t( 0 ) );
-  }
+    T           R;
+    std::size_t begin;
+    std::size_t end;
+  };
 
-  constexpr T beta   = 1.0e-4;
-  const T     DKlow  = DeltaKthr * ( 1.0 + beta );
-  const T     DKhigh = A * ( 1.0 - R ) * ( 1.0 - beta );
+  std::vector< prepared_point_t< T > > points;
+  std::vector< block_t >              blocks;
+  std::size_t                         num_tests = 0;
+};
 
-  T dlow  = DistanceDeriv( DKlow, DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale );
-  T dhigh = DistanceDeriv( DKhigh, DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale );
+template< class T, class Container_t >
+prepared_test_set_t< T > prepare_test_set( const Container_t& test_set )
+{
+  prepared_test_set_t< T > prepared;
+  prepared.num_tests = test_set.size( );
 
-  if ( dlow > 0 && dhigh > 0 )
+  std::vector< T > Rs;
+  for ( const auto& test : test_set )
   {
-    return std::make_tuple( DistanceScaled( DKlow, DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale ),
-                            std::size_t( 0 ) );
+    if ( std::find( Rs.begin( ), Rs.end( ), test.R ) == Rs.end( ) )
+    {
+      Rs.push_back( test.R );
+    }
   }
-  else if ( dlow < 0 && dhigh < 0 )
+
+  for ( const auto& R : Rs )
   {
-    return std::make_tuple( DistanceScaled( DKhigh, DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale ),
-                            std::size_t( 0 ) );
+    auto begin = prepared.points.size( );
+
+    std::size_t test_id = 0;
+    for ( const auto& test : test_set )
+    {
+      if ( test.R == R )
+      {
+        for ( const auto& point : test.points )
+        {
+          prepared.points.push_back( { point.DeltaK,
+                                       point.dadN,
+                                       std::log( point.DeltaK ),
+                                       std::log( point.dadN ),
+                                       test_id,
+                                       point.weight } );
+        }
+      }
+      test_id++;
+    }
+
+    std::sort( prepared.points.begin( ) + begin,
+               prepared.points.end( ),
+               []( const auto& a, const auto& b ) { return a.DeltaK < b.DeltaK; } );
+
+    std::vector< std::size_t > ranks( test_set.size( ), 0 );
+    for ( auto i = begin; i != prepared.points.size( ); i++ )
+    {
+      prepared.points[ i ].rank = ranks[ prepared.points[ i ].test ]++;
+    }
+
+    prepared.blocks.push_back( { R, begin, prepared.points.size( ) } );
   }
 
-  T xpos = 0;
-  T xneg = 0;
+  return prepared;
+}
 
-  if ( dlow > 0 )
+// Samples of the tabulated curve of a candidate for the geometric sweep.
+template< class T >
+struct curve_sample_t
+{
+  T t;          // Parameter of the curve, see curve_t::sampler
+  T log_DeltaK; // Natural logs
+  T x;          // log10( DeltaK )
+  T y;          // scale * log10( da/dN )
+};
+
+// Factors of the model that depend only on the candidate and R, hoisted out of the point loops.
+template< class T >
+struct curve_t
+{
+  curve_t( const parameters< T >& params, const T& R )
+    : R( R ),
+      D( params.D ),
+      p( params.p ),
+      DeltaKthr( params.DeltaK_thr ),
+      A( params.A ),
+      S1( -1. + R ),
+      Kmax( params.A * ( 1.0 - R ) ),
+      log_D( std::log( params.D ) )
   {
-    xpos = DKlow;
-    xneg = DKhigh;
   }
-  else
+
+  // Same as evaluate
+  T model( const T& DeltaK ) const
   {
-    xpos = DKhigh;
-    xneg = DKlow;
+    return D * std::pow( ( DeltaK - DeltaKthr ) / std::sqrt( 1.0 - DeltaK / Kmax ), p );
   }
 
-  std::size_t niters = 0;
+  // Natural log of the model
+  T log_model( const T& DeltaK ) const
+  {
+    return log_D
+           + p * ( std::log( DeltaK - DeltaKthr ) - 0.5 * std::log( 1. + DeltaK / ( A * S1 ) ) );
+  }
+
+  // The kernels below are templated on the curve, so that models.hpp reuses them with curves of
+  // the same interface.
 
-  const T tol  = ( std::log10( DKhigh ) - std::log10( DKlow ) ) * 1.0e-4;
-  auto    span = std::abs( std::log10( xpos ) - std::log10( xneg ) );
+  // Smallest parameter step that tabulate_curve subdivides
+  static constexpr double min_dt = 1.0e-6;
 
-  while ( niters++ < HS_MAX_ITERS && span > tol )
+  // Points of vanishing rate are at the distance DeltaKthr, as in minimum_distance
+  static constexpr bool vanishing_rate_at_threshold = true;
+
+  // Natural log of the model, for the ordinary norms
+  T log_rate( const T& DeltaK ) const { return std::log( model( DeltaK ) ); }
+
+  // The parameter of tabulate_curve at both ends of the tabulated range between the asymptotes,
+  // false if there is none
+  bool tabulation_range( T& first, T& last ) const
   {
-    T xhalf    = ( xpos + xneg ) / 2.0;
-    T dhalfway = DistanceDeriv( xhalf, DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale );
+    constexpr T beta   = 1.0e-4;
+    const T     DKlow  = DeltaKthr * ( 1.0 + beta );
+    const T     DKhigh = Kmax * ( 1.0 - beta );
 
-    if ( dhalfway > 0 )
-    {
-      xpos = xhalf;
-    }
-    else
+    if ( !( DKlow < DKhigh ) || !( DeltaKthr > 0 ) || !( D > 0 ) )
     {
-      xneg = xhalf;
+      return false;
     }
 
-    auto span = std::abs( std::log10( xpos ) - std::log10( xneg ) );
-  }
-
-  return std::make_tuple(
-    DistanceScaled( ( xpos + xneg ) / 2.0, DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale ),
-    std::size_t( 1 ) );
-}
+    first = std::log( ( DKlow - DeltaKthr ) / ( Kmax - DKlow ) );
+    last  = std::log( ( DKhigh - DeltaKthr ) / ( Kmax - DKhigh ) );
 
-template< class T, class Container_t >
-Model_Distance_t< T > objective_function( const parameters< T >& hs_params,
-                                          bool                   use_geometric,
-                                          const Container_t&     test_set,
-                                          const T                scale )
-{
-  T sum = 0.0;
+    return true;
+  }
 
-  std::size_t num_rejected_data_points = 0;
-  std::size_t num_data_points          = 0;
+  // Samples at the parameter t = log( ( DeltaK - DeltaKthr ) / ( Kmax - DeltaK ) ), which densifies
+  // logarithmically towards both asymptotes, where the curve is then sampled about uniformly along
+  // its length.
+  auto sampler( const T& scale ) const
+  {
+    const T log_span = std::log( Kmax - DeltaKthr );
+    const T log_Kmax = std::log( Kmax );
+
+    // With e = exp( t ): DeltaK - DeltaKthr = span * e / ( 1 + e ),
+    // Kmax - DeltaK = span / ( 1 + e )
+    return [ this, scale, log_span, log_Kmax ]( const T& t ) {
+      T e          = std::exp( t );
+      T log_1pe    = std::log1p( e );
+      T log_DeltaK = std::log( ( DeltaKthr + Kmax * e ) / ( 1.0 + e ) );
+      T log_model
+        = log_D + p * ( log_span + t - log_1pe - 0.5 * ( log_span - log_1pe - log_Kmax ) );
+
+      return curve_sample_t< T > { t,
+                                   log_DeltaK,
+                                   log_DeltaK * T( 0.43429448190325182 ),
+                                   scale * log_model * T( 0.43429448190325182 ) };
+    };
+  }
 
-  if ( use_geometric )
+  // Natural log of the model at exp( log_DeltaK ), and the slope of the curve there in the natural
+  // logs, for the geometric sweep
+  T log_model_slope( const T& log_DeltaK, T& slope ) const
   {
-    for ( const auto& test : test_set )
-    {
-      for ( const auto& point : test.points )
-      {
-        num_data_points++;
+    T DeltaK = std::exp( log_DeltaK );
+    T S2     = DeltaK - DeltaKthr;
+    T S3     = Kmax - DeltaK;
 
-        auto [ dis, iters ] = minimum_distance( point.DeltaK,
-                                                point.dadN,
-                                                test.R,
-                                                hs_params.D,
-                                                hs_params.p,
-                                                hs_params.DeltaK_thr,
-                                                hs_params.A,
-                                                scale );
+    slope = p * DeltaK * ( 1.0 / S2 + 0.5 / S3 );
 
-        if ( std::isfinite( dis ) && iters < HS_MAX_ITERS )
-        {
-          sum += dis;
-        }
-        else
-        {
-          num_rejected_data_points++; // This should never happen
-        }
-      }
-    }
+    return log_D + p * ( std::log( S2 ) - 0.5 * std::log( S3 / Kmax ) );
   }
-  else
-  {
-    for ( const auto& test : test_set )
-    {
-      for ( const auto& point : test.points )
-      {
-        num_data_points++;
 
-        auto dis = std::abs( std::log10( evaluate( hs_params, test.R, point.DeltaK ) )
-                             - std::log10( point.dadN ) );
-        if ( std::isfinite( dis ) )
-        {
-          sum += dis;
-        }
-        else
-        {
-          num_rejected_data_points++;
-        }
-      }
-    }
-  }
+  T R;
+  T D;
+  T p;
+  T DeltaKthr;
+  T A;
+  T S1;   // R - 1
+  T Kmax; // A * ( 1 - R )
+  T log_D;
+};
+
+// Closed form approximation of minimum_distance. The vertical and the horizontal intersections of
+// the data point with the curve, the latter from a quadratic in DeltaK, span a right triangle whose
+// hypotenuse approximates the curve. The model is evaluated once, at the DeltaK of the foot of the
+// perpendicular on the hypotenuse, and the distance is taken to the tangent of the curve there. The
+// offset of the data point along that tangent is zero at the exact foot point, so it serves as the
+// error estimate. The second element is false if it exceeds Norm::closed_form_tolerance relative to
+// the distance, or if an intersection does not exist. foot_point is set to the curve point in
+// either case.
+template< typename T, class Norm = geometric_norm >
+std::tuple< T, bool > minimum_distance2( const prepared_point_t< T >& point,
+                                         const curve_t< T >&          curve,
+                                         const T&                     scale,
+                                         T&                           foot_point,
+                                         const T&                     tolerance_scale = 1.0 )
+{
+  const T& DeltaKi   = point.DeltaK;
+  const T& DeltaKthr = curve.DeltaKthr;
+  const T& Kmax      = curve.Kmax;
+  const T& p         = curve.p;
 
-  auto num_utlized_points = num_data_points - num_rejected_data_points;
+  if ( !( DeltaKi > DeltaKthr ) || !( DeltaKi < Kmax ) || !( point.dadN > 0 ) )
+  {
+    return std::make_tuple( T( 0.0 ), false );
+  }
 
-  //  if ( num_rejected_data_points > 0 )
-  //  {
-  //    std::cout << "Rejected : " << num_rejected_data_points << std::endl;
-  //  }
+  // Natural logs, with the da/dN axis scaled
+  const T Px = point.log_DeltaK;
+  const T Py = scale * point.log_dadN;
+  const T Vy = scale * curve.log_model( DeltaKi );
 
-  double utilization = double( num_utlized_points ) / num_data_points;
+  // ( DeltaK - DeltaKthr )^2 = S3 * ( 1 - DeltaK / Kmax ), where the model equals dadNi
+  const T S3 = std::exp( ( point.log_dadN - curve.log_D ) * ( 2. / p ) );
+  const T b  = 2. * DeltaKthr - S3 / Kmax;
+  const T DH = 0.5 * ( b + std::sqrt( b * b - 4. * ( DeltaKthr * DeltaKthr - S3 ) ) );
 
-  if ( num_utlized_points == 0 )
+  if ( !( DH > DeltaKthr ) || !( DH < Kmax ) )
   {
-    return Model_Distance_t( T( 1000000.0 ), 0.0 );
+    return std::make_tuple( T( 0.0 ), false );
   }
 
-  return Model_Distance_t { sum / num_utlized_points, utilization };
-}
+  const T Hx = std::log( DH );
 
-struct common_among_tests
-{
-  bool D          = true;
-  bool p          = true;
-  bool DeltaK_thr = true;
-  bool A          = true;
+  // Foot of the perpendicular on the hypotenuse from V = ( Px, Vy ) to H = ( Hx, Py )
+  const T ex = Hx - Px;
+  const T ey = Py - Vy;
+  const T e2 = ex * ex + ey * ey;
 
-  bool all_common( ) const
+  if ( !( e2 > 0 ) )
   {
-    return D && p && DeltaK_thr && A;
+    foot_point = DeltaKi;
+    return std::make_tuple( T( 0.0 ), std::isfinite( e2 ) );
   }
-};
 
-template< class T, class Container_t >
-parameters< T > fit(
+  const T lambda = ( Py - Vy ) * ey / e2;
+  const T DC     = std::exp( Px + lambda * ex );
+
+  foot_point = DC;
+
+  // Tangent of the curve at C = ( log( DC ), scale * log_model( DC ) )
+  const T slope = scale * p * DC * ( 1.0 / ( DC - DeltaKthr ) + 0.5 / ( Kmax - DC ) );
+
+  const T rx = -lambda * ex;
+  const T ry = Py - scale * curve.log_model( DC );
+  const T r2 = rx * rx + ry * ry;
+
+  const T along = ( rx + slope * ry ) / std::sqrt( 1.0 + slope * slope );
+  const T d2    = std::max( r2 - along * along, T( 0.0 ) );
+
+  const bool valid = std::isfinite( d2 )
+                     && along * along <= T( Norm::closed_form_tolerance ) * tolerance_scale * r2;
+
+  return std::make_tuple( T( 0.18861169701161387 ) * d2, valid );
+}
+
+template< typename T, class Norm = geometric_norm >
+std::tuple< T, bool > minimum_distance2( const T& DeltaKi,
+                                         const T& dadNi,
+                                         const T& R,
+                                         const T& DD,
+                                         const T& p,
+                                         const T& DeltaKthr,
+                                         const T& A,
+                                         const T& scale,
+                                         T&       foot_point )
+{
+  const prepared_point_t< T > point { DeltaKi, dadNi, std::log( DeltaKi ), std::log( dadNi ), 0 };
+  const curve_t< T >          curve( parameters< T > { DD, p, DeltaKthr, A }, R );
+
+  return minimum_distance2< T, Norm >( point, curve, scale, foot_point );
+}
+
+template< class T >
+struct weighted_residual_t
+{
+  T residual;
+  T weight;
+};
+
+// Per thread scratch of the objective kernel. foot_points holds, for every data point, the DeltaK
+// of the foot of the perpendicular found for the previously evaluated candidate. Consecutive grid
+// candidates differ in a single parameter, so it is a good starting point for the next solve. The
+// geometric sweep keeps the curve of the current candidate instead. rejected_per_test counts, for
+// the last evaluated candidate, the rejected data points of every test. residuals is kept so that
+// the selection of the robust aggregations does not allocate.
+template< class T >
+struct distance_scratch_t
+{
+  bool             warm_start = true;
+  std::vector< T > foot_points;
+
+  std::vector< curve_sample_t< T > > samples;
+  std::vector< std::size_t >         rejected_per_test;
+  std::vector< weighted_residual_t< T > > residuals;
+
+  fidelity_t fidelity;
+
+  std::size_t solves      = 0;
+  std::size_t iterations  = 0;
+  std::size_t closed_form = 0; // Solves answered by minimum_distance2
+};
+
+// foot_point is the DeltaK of the foot of the perpendicular. On input it is used as a starting
+// point if it lies within the admissible range (pass 0 for a cold start). On output it holds the
+// new foot point.
+template< typename T, class Norm = geometric_norm >
+std::tuple< T, std::size_t > minimum_distance( const prepared_point_t< T >& point,
+                                               const curve_t< T >&          curve,
+                                               const T&                     scale,
+                                               T&                           foot_point,
+                                               const T&                     tolerance_scale = 1.0 )
+{
+  const T& R         = curve.R;
+  const T& p         = curve.p;
+  const T& DeltaKthr = curve.DeltaKthr;
+  const T& A         = curve.A;
+
+  if ( point.dadN < 1e-17 )
+  {
+    return std::make_tuple( DeltaKthr, std::size_t( 0 ) );
+  }
+
+  constexpr T beta   = 1.0e-4;
+  const T     DKlow  = DeltaKthr * ( 1.0 + beta );
+  const T     DKhigh = curve.Kmax * ( 1.0 - beta );
+
+  const T& S1         = curve.S1;
+  const T& log_DD     = curve.log_D;
+  const T& log_dadNi  = point.log_dadN;
+  const T& log_DeltaK = point.log_DeltaK;
+
+  // Same as DistanceDeriv. Also returns the natural log of the model at DeltaK, and shares the
+  // logarithms between the two.
+  auto deriv = [ & ]( const T& DeltaK, T& log_model ) {
+    T S2 = DeltaK - DeltaKthr;
+
+    log_model = log_DD + p * ( std::log( S2 ) - 0.5 * std::log( 1. + DeltaK / ( A * S1 ) ) );
+
+    return 0.18861169701161387
+           * ( ( 2. * ( std::log( DeltaK ) - log_DeltaK ) ) / DeltaK
+               - ( p * ( DeltaK + DeltaKthr + 2. * A * S1 ) * scale * scale
+                   * ( log_dadNi - log_model ) )
+                   / ( ( DeltaK + A * S1 ) * S2 ) );
+  };
+
+  auto distance_at = [ & ]( const T& DeltaK ) {
+    foot_point = DeltaK;
+    return DistanceScaled( DeltaK, point.DeltaK, point.dadN, R, curve.D, p, DeltaKthr, A, scale );
+  };
+
+  const T tol = std::log10( DKhigh / DKlow ) * T( Norm::tolerance ) * tolerance_scale;
+
+  // Bracket of the root of the derivative. xpos and xneg are where the derivative is positive and
+  // negative respectively. ypos and yneg are the natural logs of the model there.
+  T xpos = 0;
+  T xneg = 0;
+  T dpos = 0;
+  T dneg = 0;
+  T ypos = 0;
+  T yneg = 0;
+
+  auto update_bracket = [ & ]( const T& x, const T& d, const T& y ) {
+    if ( d > 0 )
+    {
+      xpos = x;
+      dpos = d;
+      ypos = y;
+    }
+    else
+    {
+      xneg = x;
+      dneg = d;
+      yneg = y;
+    }
+  };
+
+  std::size_t niters = 0;
+
+  const bool warm_start = foot_point > DKlow && foot_point < DKhigh;
+
+  if ( warm_start )
+  {
+    // Warm start: step away from the previous foot point in the direction of the root, using the
+    // secant of the derivative to size the steps, until the derivative changes sign.
+    T ystart = 0;
+    T dstart = deriv( foot_point, ystart );
+
+    if ( dstart == 0 )
+    {
+      return std::make_tuple( distance_at( foot_point ), std::size_t( 0 ) );
+    }
+
+    update_bracket( foot_point, dstart, ystart );
+
+    const bool root_below = dstart > 0;
+    const T    direction  = root_below ? -1.0 : 1.0;
+
+    // The slope of the curve in the log-log space is
+    // p * ( DeltaK / ( DeltaK - DeltaKthr ) + s / ( 2 * ( 1 - s ) ) ). The first step spans about
+    // one tolerance along the curve. Steps are relative to the previous foot point, where a
+    // relative step h is a log10 step of h / ln( 10 ).
+    const T s     = foot_point / ( A * ( 1.0 - R ) );
+    const T slope = p * ( foot_point / ( foot_point - DeltaKthr ) + s / ( 2.0 * ( 1.0 - s ) ) );
+
+    T hprev = 0;
+    T dprev = dstart;
+    T step  = 2.302585092994046 * tol / std::sqrt( 1.0 + scale * scale * slope * slope );
+
+    while ( true )
+    {
+      niters++;
+
+      T x = foot_point * ( 1.0 + direction * step );
+      T y = 0;
+
+      if ( root_below && x <= DKlow )
+      {
+        x      = DKlow;
+        auto d = deriv( x, y );
+
+        if ( d > 0 )
+        {
+          return std::make_tuple( distance_at( x ), niters );
+        }
+
+        update_bracket( x, d, y );
+        break;
+      }
+
+      if ( !root_below && x >= DKhigh )
+      {
+        x      = DKhigh;
+        auto d = deriv( x, y );
+
+        if ( d < 0 )
+        {
+          return std::make_tuple( distance_at( x ), niters );
+        }
+
+        update_bracket( x, d, y );
+        break;
+      }
+
+      T d = deriv( x, y );
+
+      update_bracket( x, d, y );
+
+      if ( ( root_below && d <= 0 ) || ( !root_below && d > 0 ) )
+      {
+        break;
+      }
+
+      // Remaining distance to the root, extrapolated linearly. Overshoot a little so that the next
+      // step brackets the root, but grow the step at least geometrically.
+      T remaining = ( step - hprev ) * d / ( dprev - d );
+      T increment = std::isfinite( remaining ) && remaining > 0 ? 1.25 * remaining : step;
+
+      hprev = step;
+      dprev = d;
+      step += std::clamp( increment, step, 8 * step );
+    }
+  }
+  else
+  {
+    T ylow  = 0;
+    T yhigh = 0;
+    T dlow  = deriv( DKlow, ylow );
+    T dhigh = deriv( DKhigh, yhigh );
+
+    if ( dlow > 0 && dhigh > 0 )
+    {
+      return std::make_tuple( distance_at( DKlow ), std::size_t( 0 ) );
+    }
+    else if ( dlow < 0 && dhigh < 0 )
+    {
+      return std::make_tuple( distance_at( DKhigh ), std::size_t( 0 ) );
+    }
+
+    if ( dlow > 0 )
+    {
+      xpos = DKlow;
+      dpos = dlow;
+      ypos = ylow;
+      xneg = DKhigh;
+      dneg = dhigh;
+      yneg = yhigh;
+    }
+    else
+    {
+      xpos = DKhigh;
+      dpos = dhigh;
+      ypos = yhigh;
+      xneg = DKlow;
+      dneg = dlow;
+      yneg = ylow;
+    }
+  }
+
+  // The bracket is measured along the curve in the scaled log-log metric of the distance. Near the
+  // asymptotes the curve is almost vertical and a bracket that is narrow in DeltaK alone can still
+  // span a large part of the curve.
+  auto bracket_span = [ & ]( ) {
+    T dx = std::log( xpos / xneg );
+    T dy = scale * ( ypos - yneg );
+    return std::sqrt( dx * dx + dy * dy ) * T( 0.43429448190325182 ); // To log10
+  };
+
+  auto span = bracket_span( );
+
+  // The wide bracket of a cold start is bisected. The derivative may vary by orders of magnitude
+  // across it near the asymptotes. The narrow bracket of a warm start is reduced with the Illinois
+  // variant of regula falsi: the derivative value kept at the side that did not move is halved, so
+  // that both sides converge.
+  T   wpos      = dpos;
+  T   wneg      = dneg;
+  int last_side = 0;
+
+  while ( niters < Norm::max_iterations && span > tol )
+  {
+    niters++;
+
+    T x = ( xpos + xneg ) / 2.0;
+
+    if ( warm_start )
+    {
+      T xf = xneg + ( xpos - xneg ) * ( -wneg / ( wpos - wneg ) );
+
+      if ( std::isfinite( xf ) && xf > std::min( xpos, xneg ) && xf < std::max( xpos, xneg ) )
+      {
+        x = xf;
+      }
+    }
+
+    T y = 0;
+    T d = deriv( x, y );
+
+    update_bracket( x, d, y );
+
+    if ( d > 0 )
+    {
+      wpos = d;
+      if ( last_side == 1 )
+      {
+        wneg /= 2;
+      }
+      last_side = 1;
+    }
+    else
+    {
+      wneg = d;
+      if ( last_side == -1 )
+      {
+        wpos /= 2;
+      }
+      last_side = -1;
+    }
+
+    span = bracket_span( );
+  }
+
+  // The distance is very sensitive to the foot point where the curve is steep. Interpolating the
+  // derivative within the final bracket makes the result independent of where the bracket started.
+  T foot = ( xpos + xneg ) / 2.0;
+  if ( std::isfinite( dpos ) && std::isfinite( dneg ) && dpos - dneg > 0 )
+  {
+    foot = xneg + ( xpos - xneg ) * ( -dneg / ( dpos - dneg ) );
+  }
+
+  return std::make_tuple( distance_at( foot ), niters );
+}
+
+template< typename T, class Norm = geometric_norm >
+std::tuple< T, std::size_t > minimum_distance( const T& DeltaKi,
+                                               const T& dadNi,
+                                               const T& R,
+                                               const T& DD,
+                                               const T& p,
+                                               const T& DeltaKthr,
+                                               const T& A,
+                                               const T& scale,
+                                               T&       foot_point )
+{
+  const prepared_point_t< T > point { DeltaKi, dadNi, std::log( DeltaKi ), std::log( dadNi ), 0 };
+  const curve_t< T >          curve( parameters< T > { DD, p, DeltaKthr, A }, R );
+
+  return minimum_distance< T, Norm >( point, curve, scale, foot_point );
+}
+
+template< typename T, class Norm = geometric_norm >
+std::tuple< T, std::size_t > minimum_distance( const T& DeltaKi,
+                                               const T& dadNi,
+                                               const T& R,
+                                               const T& DD,
+                                               const T& p,
+                                               const T& DeltaKthr,
+                                               const T& A,
+                                               const T& scale )
+{
+  T foot_point = 0;
+  return minimum_distance< T, Norm >( DeltaKi, dadNi, R, DD, p, DeltaKthr, A, scale, foot_point );
+}
+
+// Samples the curve over its tabulation_range. The parameter is uniform at first. Segments that
+// are too long, or deviate too much from the curve, are split.
+template< class Norm, class T, class Curve >
+bool tabulate_curve( const Curve&                        curve,
+                     const T&                            scale,
+                     std::vector< curve_sample_t< T > >& samples )
+{
+  samples.clear( );
+
+  T t_first, t_last;
+
+  if ( !curve.tabulation_range( t_first, t_last ) )
+  {
+    return false;
+  }
+
+  const auto sample = curve.sampler( scale );
+
+  const auto first = sample( t_first );
+  const auto last  = sample( t_last );
+
+  if ( !std::isfinite( first.y ) || !std::isfinite( last.y ) )
+  {
+    return false;
+  }
+
+  auto needs_split = [ & ]( const auto& a, const auto& m, const auto& b ) {
+    T dx  = b.x - a.x;
+    T dy  = b.y - a.y;
+    T len = std::sqrt( dx * dx + dy * dy );
+
+    if ( len > T( Norm::max_segment ) )
+    {
+      return true;
+    }
+
+    return std::abs( dx * ( m.y - a.y ) - dy * ( m.x - a.x ) ) > T( Norm::max_deviation ) * len;
+  };
+
+  constexpr T min_dt = Curve::min_dt;
+
+  std::vector< curve_sample_t< T > > pending;
+
+  samples.push_back( first );
+
+  for ( std::size_t k = 1; k != Norm::initial_samples; k++ )
+  {
+    const T t = first.t + ( last.t - first.t ) * k / ( Norm::initial_samples - 1 );
+
+    pending.push_back( k == Norm::initial_samples - 1 ? last : sample( t ) );
+
+    while ( !pending.empty( ) )
+    {
+      const auto& a = samples.back( );
+      const auto  b = pending.back( );
+      const auto  m = sample( ( a.t + b.t ) / 2.0 );
+
+      if ( b.t - a.t > min_dt && needs_split( a, m, b ) )
+      {
+        pending.push_back( m );
+      }
+      else
+      {
+        samples.push_back( b );
+        pending.pop_back( );
+      }
+    }
+  }
+
+  return true;
+}
+
+// Squared distance, as in DistanceScaled, of a point to a segment of the tabulated curve.
+template< class T >
+T segment_distance2( const curve_sample_t< T >& a,
+                     const curve_sample_t< T >& b,
+                     const T&                   x,
+                     const T&                   y )
+{
+  T dx = b.x - a.x;
+  T dy = b.y - a.y;
+
+  T l = ( ( x - a.x ) * dx + ( y - a.y ) * dy ) / ( dx * dx + dy * dy );
+  l   = std::clamp( l, T( 0.0 ), T( 1.0 ) );
+
+  T ex = a.x + l * dx - x;
+  T ey = a.y + l * dy - y;
+
+  return ex * ex + ey * ey;
+}
+
+// Sum of the distances of the points of a block, which are sorted by DeltaK, to the curve of the
+// candidate. The nearest segment of each point is found by walking from the nearest segment of the
+// previous point. The projection on the segment is then refined by one Gauss-Newton step on the
+// curve. The distance is stationary at the foot point, so the error of the projection is of second
+// order in the distance.
+template< class Norm, class T, class Curve >
+void sweep_distances( const prepared_test_set_t< T >&                    prepared,
+                      const typename prepared_test_set_t< T >::block_t& block,
+                      const Curve&                                       curve,
+                      const T&                                           scale,
+                      distance_scratch_t< T >&                           scratch,
+                      T&                                                 sum,
+                      T&                                                 rejected_weight )
+{
+  const auto& samples = scratch.samples;
+
+  const auto& fidelity = scratch.fidelity;
+
+  if ( !tabulate_curve< Norm >( curve, scale, scratch.samples ) )
+  {
+    for ( auto i = block.begin; i != block.end; i++ )
+    {
+      const auto& point = prepared.points[ i ];
+
+      if ( fidelity.visits( point.rank ) )
+      {
+        scratch.rejected_per_test[ point.test ]++;
+        rejected_weight += point.weight;
+      }
+    }
+    return;
+  }
+
+  const std::size_t last_segment = samples.size( ) - 2;
+
+  // Squared distance in the natural log space, and the slope of the curve there
+  auto distance2 = [ & ]( const prepared_point_t< T >& point, const T& log_DeltaK, T& slope ) {
+    T log_model = curve.log_model_slope( log_DeltaK, slope );
+
+    T dx = point.log_DeltaK - log_DeltaK;
+    T dy = scale * ( point.log_dadN - log_model );
+
+    return std::make_tuple( dx * dx + dy * dy, dx + scale * dy * slope );
+  };
+
+  std::size_t j     = 0;
+  bool        first = true;
+
+  for ( auto i = block.begin; i != block.end; i++ )
+  {
+    const auto& point = prepared.points[ i ];
+
+    if ( !fidelity.visits( point.rank ) )
+    {
+      continue;
+    }
+
+    scratch.solves++;
+
+    if constexpr ( Curve::vanishing_rate_at_threshold )
+    {
+      if ( point.dadN < 1e-17 )
+      {
+        sum += curve.DeltaKthr;
+        continue;
+      }
+    }
+
+    const T x = point.log_DeltaK * T( 0.43429448190325182 );
+    const T y = scale * point.log_dadN * T( 0.43429448190325182 );
+
+    auto segment_d2 = [ & ]( std::size_t k ) {
+      return segment_distance2( samples[ k ], samples[ k + 1 ], x, y );
+    };
+
+    if ( first )
+    {
+      T d2min = segment_d2( 0 );
+      for ( std::size_t k = 1; k <= last_segment; k++ )
+      {
+        T d2 = segment_d2( k );
+        if ( d2 < d2min )
+        {
+          d2min = d2;
+          j     = k;
+        }
+      }
+      first = false;
+    }
+    else
+    {
+      T d2 = segment_d2( j );
+      while ( j > 0 )
+      {
+        T d2prev = segment_d2( j - 1 );
+        if ( !( d2prev < d2 ) )
+        {
+          break;
+        }
+        d2 = d2prev;
+        j--;
+      }
+      while ( j < last_segment )
+      {
+        T d2next = segment_d2( j + 1 );
+        if ( !( d2next < d2 ) )
+        {
+          break;
+        }
+        d2 = d2next;
+        j++;
+      }
+    }
+
+    const auto& a = samples[ j ];
+    const auto& b = samples[ j + 1 ];
+
+    T dx = b.x - a.x;
+    T dy = b.y - a.y;
+    T l  = ( ( x - a.x ) * dx + ( y - a.y ) * dy ) / ( dx * dx + dy * dy );
+    l    = std::clamp( l, T( 0.0 ), T( 1.0 ) );
+
+    T u0    = a.log_DeltaK + l * ( b.log_DeltaK - a.log_DeltaK );
+    T slope = 0;
+
+    auto [ d2_0, gradient ] = distance2( point, u0, slope );
+
+    T u1 = std::clamp( u0 + gradient / ( 1.0 + scale * scale * slope * slope ),
+                       samples.front( ).log_DeltaK,
+                       samples.back( ).log_DeltaK );
+
+    auto d2_1 = std::get< 0 >( distance2( point, u1, slope ) );
+
+    scratch.iterations++;
+
+    T dis = T( 0.18861169701161387 ) * ( d2_1 < d2_0 ? d2_1 : d2_0 );
+
+    if ( std::isfinite( dis ) )
+    {
+      sum += point.weight * dis;
+    }
+    else
+    {
+      scratch.rejected_per_test[ point.test ]++;
+      rejected_weight += point.weight;
+    }
+  }
+}
+
+// Index k of the residual at which the cumulative weight of the residuals in increasing order
+// reaches target, and the part of its weight needed for that. Reorders residuals so that the ones
+// before k are not larger and the ones after not smaller. Expected linear time.
+template< class T >
+std::tuple< std::size_t, T > weighted_select( std::vector< weighted_residual_t< T > >& residuals,
+                                              T                                        target )
+{
+  auto less = []( const auto& a, const auto& b ) { return a.residual < b.residual; };
+
+  std::size_t begin = 0;
+  std::size_t end   = residuals.size( );
+
+  while ( end - begin > 1 )
+  {
+    const auto middle = begin + ( end - begin ) / 2;
+
+    std::nth_element( residuals.begin( ) + begin,
+                      residuals.begin( ) + middle,
+                      residuals.begin( ) + end,
+                      less );
+
+    T lower_weight = 0.0;
+    for ( auto i = begin; i != middle; i++ )
+    {
+      lower_weight += residuals[ i ].weight;
+    }
+
+    if ( lower_weight >= target )
+    {
+      end = middle;
+    }
+    else
+    {
+      target -= lower_weight;
+      begin = middle;
+    }
+  }
+
+  return std::make_tuple( begin, target );
+}
+
+// Weighted mean of the residuals without the largest fraction of their weight, rounded down to
+// whole points. Reorders residuals.
+template< class T >
+T trimmed_mean( std::vector< weighted_residual_t< T > >& residuals,
+                const T&                                total_weight,
+                const double&                           fraction )
+{
+  const T kept_weight = total_weight - std::floor( fraction * total_weight );
+
+  auto [ k, remaining ] = weighted_select( residuals, kept_weight );
+
+  T sum = remaining * residuals[ k ].residual;
+  for ( std::size_t i = 0; i != k; i++ )
+  {
+    sum += residuals[ i ].weight * residuals[ i ].residual;
+  }
+
+  return sum / kept_weight;
+}
+
+// Weighted median. Reorders residuals.
+template< class T >
+T median( std::vector< weighted_residual_t< T > >& residuals, const T& total_weight )
+{
+  auto [ k, remaining ] = weighted_select( residuals, total_weight / 2.0 );
+
+  if ( remaining < residuals[ k ].weight || k + 1 == residuals.size( ) )
+  {
+    return residuals[ k ].residual;
+  }
+
+  // Exactly half of the weight is up to k. Average with the next residual.
+  auto next = std::min_element(
+    residuals.begin( ) + k + 1, residuals.end( ), []( const auto& a, const auto& b ) {
+      return a.residual < b.residual;
+    } );
+
+  return ( residuals[ k ].residual + next->residual ) / 2.0;
+}
+
+// Distance of a data point to the curve of a candidate, not finite if the point is rejected.
+// foot_point is that of minimum_distance.
+template< class Norm, class T, class Curve >
+T point_distance( const prepared_point_t< T >& point,
+                  const Curve&                 curve,
+                  const T&                     scale,
+                  T&                           foot_point,
+                  const T&                     tolerance_scale,
+                  distance_scratch_t< T >&     scratch )
+{
+  if constexpr ( Norm::geometric )
+  {
+    scratch.solves++;
+
+    if constexpr ( Norm::closed_form_tolerance > 0 )
+    {
+      auto [ closed_form_dis, valid ]
+        = minimum_distance2< T, Norm >( point, curve, scale, foot_point, tolerance_scale );
+
+      if ( valid )
+      {
+        scratch.closed_form++;
+        return closed_form_dis;
+      }
+    }
+
+    auto [ solver_dis, iters ]
+      = minimum_distance< T, Norm >( point, curve, scale, foot_point, tolerance_scale );
+
+    scratch.iterations += iters;
+
+    return iters < Norm::max_iterations ? solver_dis : std::numeric_limits< T >::quiet_NaN( );
+  }
+  else
+  {
+    return std::abs( ( curve.log_rate( point.DeltaK ) - point.log_dadN )
+                     * T( 0.43429448190325182 ) );
+  }
+}
+
+// Adds the distance of a point to the sum, or to the residuals of the robust aggregations
+template< class Norm, class T >
+void accumulate_distance( const T& dis, const T& weight, T& sum, distance_scratch_t< T >& scratch )
+{
+  if constexpr ( Norm::aggregation == aggregation_t::mean )
+  {
+    sum += weight * dis;
+  }
+  else if constexpr ( Norm::aggregation == aggregation_t::huber )
+  {
+    constexpr T delta = Norm::huber_delta;
+
+    sum += weight * ( dis <= delta ? dis * dis / ( 2.0 * delta ) : dis - delta / 2.0 );
+  }
+  else
+  {
+    scratch.residuals.push_back( { dis, weight } );
+  }
+}
+
+template< class Norm, class T >
+Model_Distance_t< T > aggregate_distances( const T&                 sum,
+                                           const T&                 total_weight,
+                                           const T&                 rejected_weight,
+                                           distance_scratch_t< T >& scratch )
+{
+  auto utilized_weight = total_weight - rejected_weight;
+
+  double utilization = double( utilized_weight / total_weight );
+
+  if ( !( utilized_weight > 0 ) )
+  {
+    return Model_Distance_t( T( 1000000.0 ), 0.0 );
+  }
+
+  if constexpr ( Norm::aggregation == aggregation_t::trimmed )
+  {
+    return Model_Distance_t {
+      trimmed_mean( scratch.residuals, utilized_weight, Norm::trimmed_fraction ), utilization };
+  }
+  else if constexpr ( Norm::aggregation == aggregation_t::median )
+  {
+    return Model_Distance_t { median( scratch.residuals, utilized_weight ), utilization };
+  }
+
+  return Model_Distance_t { sum / utilized_weight, utilization };
+}
+
+// Objective over the prepared test set of the curves that make_curve returns for its blocks, of the
+// interface of curve_t. For the mean and Huber aggregations, the evaluation is abandoned as soon as
+// the partial sum shows that the result will exceed bound. The distance returned then is only
+// known to be larger.
+template< class Norm, class T, class Make_curve >
+Model_Distance_t< T >
+curve_objective_function( const prepared_test_set_t< T >& prepared,
+                          const T                         scale,
+                          distance_scratch_t< T >&        scratch,
+                          Make_curve&&                    make_curve,
+                          const T& bound = std::numeric_limits< T >::infinity( ) )
+{
+  T sum = 0.0;
+
+  // Points count by their weight
+  T total_weight    = 0.0;
+  T rejected_weight = 0.0;
+
+  const auto& fidelity = scratch.fidelity;
+  const T     tolerance_scale( fidelity.tolerance_scale );
+
+  scratch.rejected_per_test.assign( prepared.num_tests, 0 );
+  scratch.residuals.clear( );
+
+  static_assert( !Norm::sweep || Norm::aggregation == aggregation_t::mean );
+
+  constexpr bool prunable
+    = Norm::aggregation == aggregation_t::mean || Norm::aggregation == aggregation_t::huber;
+
+  if constexpr ( Norm::geometric && !Norm::sweep )
+  {
+    if ( scratch.warm_start )
+    {
+      // The scratch is bound to one test set
+      scratch.foot_points.resize( prepared.points.size( ), T( 0.0 ) );
+    }
+  }
+
+  for ( const auto& point : prepared.points )
+  {
+    if ( fidelity.visits( point.rank ) )
+    {
+      total_weight += point.weight;
+    }
+  }
+
+  const T pruning_sum = bound * total_weight;
+
+  for ( const auto& block : prepared.blocks )
+  {
+    const auto curve = make_curve( block );
+
+    if constexpr ( Norm::sweep )
+    {
+      sweep_distances< Norm >( prepared, block, curve, scale, scratch, sum, rejected_weight );
+    }
+    else
+    {
+      for ( auto i = block.begin; i != block.end; i++ )
+      {
+        const auto& point = prepared.points[ i ];
+
+        if ( !fidelity.visits( point.rank ) )
+        {
+          continue;
+        }
+
+        T  cold_start = 0;
+        T& foot_point
+          = Norm::geometric && scratch.warm_start ? scratch.foot_points[ i ] : cold_start;
+
+        const T dis
+          = point_distance< Norm >( point, curve, scale, foot_point, tolerance_scale, scratch );
+
+        if ( std::isfinite( dis ) )
+        {
+          accumulate_distance< Norm >( dis, point.weight, sum, scratch );
+        }
+        else
+        {
+          scratch.rejected_per_test[ point.test ]++;
+          rejected_weight += point.weight; // For the geometric norm, this should never happen
+        }
+
+        if constexpr ( prunable )
+        {
+          if ( sum > pruning_sum )
+          {
+            return Model_Distance_t { sum / total_weight, 1.0 };
+          }
+        }
+      }
+    }
+
+    if constexpr ( prunable )
+    {
+      if ( sum > pruning_sum )
+      {
+        return Model_Distance_t { sum / total_weight, 1.0 };
+      }
+    }
+  }
+
+  return aggregate_distances< Norm >( sum, total_weight, rejected_weight, scratch );
+}
+
+template< class Norm, class T >
+Model_Distance_t< T > objective_function( const parameters< T >&          hs_params,
+                                          const prepared_test_set_t< T >& prepared,
+                                          const T                         scale,
+                                          distance_scratch_t< T >&        scratch )
+{
+  return curve_objective_function< Norm >(
+    prepared, scale, scratch, [ & ]( const auto& block ) {
+      return curve_t< T >( hs_params, block.R );
+    } );
+}
+
+// Single evaluation on the test set as given, without preparing it, for callers that do not
+// evaluate many candidates on the same test set. The sweep walks the points of every R in order
+// of DeltaK, so it prepares the test set.
+template< class Norm, class T, class Container_t >
+Model_Distance_t< T > objective_function( const parameters< T >& hs_params,
+                                          const Container_t&     test_set,
+                                          const T                scale )
+{
+  distance_scratch_t< T > scratch;
+  scratch.warm_start = false;
+
+  if constexpr ( Norm::sweep )
+  {
+    return objective_function< Norm >(
+      hs_params, prepare_test_set< T >( test_set ), scale, scratch );
+  }
+  else
+  {
+    T sum             = 0.0;
+    T total_weight    = 0.0;
+    T rejected_weight = 0.0;
+
+    for ( const auto& test : test_set )
+    {
+      const curve_t< T > curve( hs_params, T( test.R ) );
+
+      for ( const auto& data_point : test.points )
+      {
+        const prepared_point_t< T > point { T( data_point.DeltaK ),
+                                            T( data_point.dadN ),
+                                            std::log( T( data_point.DeltaK ) ),
+                                            std::log( T( data_point.dadN ) ),
+                                            0,
+                                            T( data_point.weight ) };
+
+        total_weight += point.weight;
+
+        T       foot_point = 0;
+        const T dis = point_distance< Norm >( point, curve, scale, foot_point, T( 1.0 ), scratch );
+
+        if ( std::isfinite( dis ) )
+        {
+          accumulate_distance< Norm >( dis, point.weight, sum, scratch );
+        }
+        else
+        {
+          rejected_weight += point.weight;
+        }
+      }
+    }
+
+    return aggregate_distances< Norm >( sum, total_weight, rejected_weight, scratch );
+  }
+}
+
+// Runtime entry point. Prefer the Norm specialized version above in loops that evaluate many
+// candidates.
+template< class T, class Container_t >
+Model_Distance_t< T > objective_function( const parameters< T >& hs_params,
+                                          norm_t                 norm,
+                                          const Container_t&     test_set,
+                                          const T                scale )
+{
+  return dispatch_norm( norm, [ & ]( auto norm_policy ) {
+    return objective_function< decltype( norm_policy ) >( hs_params, test_set, scale );
+  } );
+}
+
+template< class T, class Container_t >
+Model_Distance_t< T > objective_function( const parameters< T >& hs_params,
+                                          bool                   use_geometric,
+                                          const Container_t&     test_set,
+                                          const T                scale )
+{
+  return objective_function(
+    hs_params, use_geometric ? norm_t::geometric : norm_t::ordinary, test_set, scale );
+}
+
+// Guaranteed lower bound of the objective of the mean and Huber ordinary norms over all parameters
+// in the box [ min, max ], by interval evaluation of the model. log10 of the model is increasing in
+// D, decreasing in DeltaK_thr and A, and monotone in p with the sign of log10 of the base, so the
+// corners of the box bound it per point. Points that the model may reject somewhere in the box
+// count as zero, and the sum is divided by the weight of all points, which is at least the
+// utilized weight of any parameters in the box.
+template< class Norm, class T >
+T objective_lower_bound( const parameters< T >&          min,
+                         const parameters< T >&          max,
+                         const prepared_test_set_t< T >& prepared )
+{
+  static_assert( !Norm::geometric
+                 && ( Norm::aggregation == aggregation_t::mean
+                      || Norm::aggregation == aggregation_t::huber ) );
+
+  const T log10D_min = std::log10( min.D );
+  const T log10D_max = std::log10( max.D );
+
+  T sum          = 0.0;
+  T total_weight = 0.0;
+
+  for ( const auto& block : prepared.blocks )
+  {
+    for ( auto i = block.begin; i != block.end; i++ )
+    {
+      const auto& point = prepared.points[ i ];
+
+      total_weight += point.weight;
+
+      const T s_min = point.DeltaK / ( max.A * ( T { 1.0 } - block.R ) );
+      const T s_max = point.DeltaK / ( min.A * ( T { 1.0 } - block.R ) );
+
+      if ( !( s_max < 1.0 ) || !( point.DeltaK > max.DeltaK_thr ) )
+      {
+        continue;
+      }
+
+      const T log_base_min
+        = std::log10( ( point.DeltaK - max.DeltaK_thr ) / std::sqrt( 1.0 - s_min ) );
+      const T log_base_max
+        = std::log10( ( point.DeltaK - min.DeltaK_thr ) / std::sqrt( 1.0 - s_max ) );
+
+      const std::array< T, 4 > products { min.p * log_base_min,
+                                          min.p * log_base_max,
+                                          max.p * log_base_min,
+                                          max.p * log_base_max };
+
+      const T model_min = log10D_min + *std::min_element( products.begin( ), products.end( ) );
+      const T model_max = log10D_max + *std::max_element( products.begin( ), products.end( ) );
+
+      const T log10_dadN = point.log_dadN * T( 0.43429448190325182 );
+
+      const T dis = std::max( { T( 0.0 ), model_min - log10_dadN, log10_dadN - model_max } );
+
+      if constexpr ( Norm::aggregation == aggregation_t::huber )
+      {
+        constexpr T delta = Norm::huber_delta;
+
+        sum += point.weight
+               * ( dis <= delta ? dis * dis / ( 2.0 * delta ) : dis - delta / 2.0 );
+      }
+      else
+      {
+        sum += point.weight * dis;
+      }
+    }
+  }
+
+  return total_weight > 0 ? sum / total_weight : T( 0.0 );
+}
+
+struct common_among_tests
+{
+  bool D          = true;
+  bool p          = true;
+  bool DeltaK_thr = true;
+  bool A          = true;
+
+  bool all_common( ) const
+  {
+    return D && p && DeltaK_thr && A;
+  }
+
+  bool any_common( ) const
+  {
+    return D || p || DeltaK_thr || A;
+  }
+};
+
+namespace detail
+{
+
+// Subdivisions of the axes of the adaptive grid for a budget of their product. Minimizing the sum
+// over the axes of the squared variation of the objective between neighbouring grid points makes
+// them proportional to the variation along each axis. Flat axes keep min_subdivisions, inactive
+// ones (a search range of zero width) one.
+inline std::array< std::size_t, 4 > allocate_subdivisions(
+  const std::array< double, 4 >& variations,
+  const std::array< bool, 4 >&   active,
+  const double&                  budget )
+{
+  constexpr std::size_t min_subdivisions = 3;
+
+  std::array< std::size_t, 4 > subdivisions { 1, 1, 1, 1 };
+
+  std::size_t num_active    = 0;
+  double      max_variation = 0.0;
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    if ( active[ k ] )
+    {
+      num_active++;
+      max_variation = std::max( max_variation, variations[ k ] );
+    }
+  }
+
+  if ( num_active == 0 )
+  {
+    return subdivisions;
+  }
+
+  // Relative to the geometric mean of the variations, flat axes counting as a thousandth of the
+  // steepest one
+  auto log_variation = [ & ]( std::size_t k ) {
+    return std::log( std::max( variations[ k ], 1.0e-3 * max_variation ) );
+  };
+
+  double log_mean = 0.0;
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    if ( active[ k ] && max_variation > 0 )
+    {
+      log_mean += log_variation( k ) / num_active;
+    }
+  }
+
+  const double per_axis = std::pow( budget, 1.0 / num_active );
+
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    if ( active[ k ] )
+    {
+      const double n = max_variation > 0 ? per_axis * std::exp( log_variation( k ) - log_mean )
+                                         : per_axis;
+
+      subdivisions[ k ] = std::max( min_subdivisions, std::size_t( std::round( n ) ) );
+    }
+  }
+
+  // Rounding and the minimum can exceed the budget
+  auto product = [ & ]( ) {
+    return double( subdivisions[ 0 ] ) * subdivisions[ 1 ] * subdivisions[ 2 ] * subdivisions[ 3 ];
+  };
+
+  while ( product( ) > budget )
+  {
+    auto largest = std::max_element( subdivisions.begin( ), subdivisions.end( ) );
+    if ( *largest <= min_subdivisions )
+    {
+      break;
+    }
+    ( *largest )--;
+  }
+
+  return subdivisions;
+}
+
+// callback may take the Model_Distance_t of the minimum as a fourth argument. num_threads is the
+// number of threads, 0 for as many as there are cores.
+template< class Norm, class T, class Container_t, class Stop, class Callback = callback_t< T > >
+parameters< T > fit( parameters< T >                          search_space_min,
+                     parameters< T >                          search_space_max,
+                     const Container_t&                       test_set,
+                     const std::size_t                        subdivisions,
+                     const double&                            amortization,
+                     std::size_t                              iterations,
+                     Callback                                 callback,
+                     progress_callback_t                      progress_callback,
+                     const Stop&                              stop_requested,
+                     std::function< void( parameters< T > ) > per_thread_callback,
+                     cuhyso::sampler_t                        sampler,
+                     std::size_t                              budget,
+                     std::size_t                              num_threads = 0 )
+{
+  using params_t = parameters< T >;
+
+  auto contract_range
+    = []( const T& lower, const T& upper, const T& new_center, const T& amortization ) {
+        auto dif    = upper - lower;
+        auto newdif = dif / amortization;
+
+        auto new_lower = new_center - newdif / 2;
+        auto new_upper = new_center + newdif / 2;
+
+        if ( new_upper > upper )
+        {
+          new_upper = upper;
+          new_lower = new_upper - newdif;
+        }
+        else if ( new_lower < lower )
+        {
+          new_lower = lower;
+          new_upper = new_lower + newdif;
+        }
+
+        return std::make_tuple( new_lower, new_upper );
+      };
+
+  using st = std::size_t;
+
+  auto   objective_min      = std::numeric_limits< T >::max( );
+  auto   params_at_min      = params_t { 0.0, 0.0, 0.0, 0.0 };
+  double utilization_at_min = 0;
+
+  // Utilization is preferred over minimization
+  auto is_better
+    = []( const T& distance, double utilization, const T& best, double best_utilization ) {
+        return utilization > best_utilization
+               || ( best > distance && utilization >= best_utilization );
+      };
+
+  if ( iterations == 0 )
+  {
+    iterations = std::log( 4000.0 ) / std::log( amortization );
+  }
+
+  auto subd = subdivisions;
+
+  auto subdD = subd;
+  if ( std::fabs( search_space_max.D - search_space_min.D ) < 1e-19 )
+  {
+    subdD = 1;
+  }
+
+  if ( num_threads == 0 )
+  {
+    num_threads = detail::thread_count( );
+  }
+  if ( sampler == cuhyso::sampler_t::grid )
+  {
+    num_threads = std::min( num_threads, subdD );
+  }
+
+  std::vector< double >   max_utilization_mins( num_threads, 0.0 );
+  std::vector< T >        objective_mins( num_threads );
+  std::vector< params_t > params_mins( num_threads );
+
+  // Kept across rounds, so that the first candidates of a round start from the foot points of the
+  // previous round, which was contracted around the incumbent.
+  std::vector< distance_scratch_t< T > > scratches( num_threads );
+
+  for ( st i = 0; i != num_threads; i++ )
+  {
+    objective_mins[ i ] = std::numeric_limits< T >::max( );
+    params_mins[ i ]    = params_t { 0.0, 0.0, 0.0, 0.0 };
+  }
+
+  const auto scale = detail::checked_scale< T >( test_set );
+
+  const auto prepared = prepare_test_set< T >( test_set );
+
+  std::size_t smallest_test = std::numeric_limits< std::size_t >::max( );
+  for ( const auto& test : test_set )
+  {
+    smallest_test = std::min( smallest_test, std::size_t( test.points.size( ) ) );
+  }
+
+  // Largest ratio among the axes of the width of the search box to the initial width, D in the
+  // log10 space
+  auto box_fraction = [ initial_min = search_space_min, initial_max = search_space_max ](
+                        const params_t& min, const params_t& max ) {
+    double fraction = 0;
+
+    auto axis = [ & ]( const T& width, const T& initial_width ) {
+      if ( initial_width > 0 )
+      {
+        fraction = std::max( fraction, double( width / initial_width ) );
+      }
+    };
+
+    axis( std::log10( max.D / min.D ), std::log10( initial_max.D / initial_min.D ) );
+    axis( max.p - min.p, initial_max.p - initial_min.p );
+    axis( max.DeltaK_thr - min.DeltaK_thr, initial_max.DeltaK_thr - initial_min.DeltaK_thr );
+    axis( max.A - min.A, initial_max.A - initial_min.A );
+
+    return fraction;
+  };
+
+  // Candidates of the tensor grid with the dj-th D, D in the log10 space
+  auto append_grid_candidates = [ & ]( st dj, std::vector< params_t >& candidates ) {
+    params_t obj_params;
+
+    auto lowl = std::log10( search_space_min.D );
+    auto hil  = std::log10( search_space_max.D );
+
+    obj_params.D = std::pow( 10.0, cuhyso::sample_parameter( lowl, hil, subdD, dj ) );
+
+    auto subdp = subd;
+    if ( std::fabs( search_space_max.p - search_space_min.p ) < 1e-19 )
+    {
+      subdp = 1;
+    }
+
+    for ( st pj = 0; pj != subdp; pj++ )
+    {
+      obj_params.p = cuhyso::sample_parameter( search_space_min.p, search_space_max.p, subd, pj );
+
+      auto subdDeltaKj = subd;
+      if ( std::fabs( search_space_max.DeltaK_thr - search_space_min.DeltaK_thr ) < 1e-19 )
+      {
+        subdDeltaKj = 1;
+      }
+
+      for ( st DeltaKj = 0; DeltaKj != subdDeltaKj; DeltaKj++ )
+      {
+        obj_params.DeltaK_thr = cuhyso::sample_parameter(
+          search_space_min.DeltaK_thr, search_space_max.DeltaK_thr, subd, DeltaKj );
+
+        auto subdA = subd;
+        if ( std::fabs( search_space_max.A - search_space_min.A ) < 1e-19 )
+        {
+          subdA = 1;
+        }
+
+        for ( st Aj = 0; Aj != subdA; Aj++ )
+        {
+          obj_params.A
+            = cuhyso::sample_parameter( search_space_min.A, search_space_max.A, subd, Aj );
+
+          candidates.push_back( obj_params );
+        }
+      }
+    }
+  };
+
+  // Subdivisions and amortizations of the axes D, p, DeltaK_thr and A. They differ among the axes
+  // only for the adaptive grid.
+  std::array< st, 4 > axis_subdivisions { subd, subd, subd, subd };
+  std::array< T, 4 >  axis_amortization;
+  axis_amortization.fill( amortization );
+
+  auto active_axes = [ & ]( ) {
+    return std::array< bool, 4 > {
+      std::fabs( search_space_max.D - search_space_min.D ) >= 1e-19,
+      std::fabs( search_space_max.p - search_space_min.p ) >= 1e-19,
+      std::fabs( search_space_max.DeltaK_thr - search_space_min.DeltaK_thr ) >= 1e-19,
+      std::fabs( search_space_max.A - search_space_min.A ) >= 1e-19 };
+  };
+
+  const double adaptive_budget = budget > 0 ? double( budget ) : std::pow( double( subd ), 4 );
+
+  // The first round has no variations yet, so the budget is spread evenly
+  if ( sampler == cuhyso::sampler_t::adaptive_grid )
+  {
+    axis_subdivisions
+      = allocate_subdivisions( { 1.0, 1.0, 1.0, 1.0 }, active_axes( ), adaptive_budget );
+  }
+
+  // Candidates of the adaptive grid, the last axis fastest
+  auto append_adaptive_candidates = [ & ]( std::vector< params_t >& candidates ) {
+    const auto active = active_axes( );
+
+    std::array< st, 4 > counts;
+    for ( st k = 0; k != 4; k++ )
+    {
+      counts[ k ] = active[ k ] ? axis_subdivisions[ k ] : 1;
+    }
+
+    const auto lowl = std::log10( search_space_min.D );
+    const auto hil  = std::log10( search_space_max.D );
+
+    for ( st Dj = 0; Dj != counts[ 0 ]; Dj++ )
+      for ( st pj = 0; pj != counts[ 1 ]; pj++ )
+        for ( st DeltaKj = 0; DeltaKj != counts[ 2 ]; DeltaKj++ )
+          for ( st Aj = 0; Aj != counts[ 3 ]; Aj++ )
+          {
+            candidates.push_back(
+              { std::pow( 10.0, cuhyso::sample_parameter( lowl, hil, counts[ 0 ], Dj ) ),
+                cuhyso::sample_parameter(
+                  search_space_min.p, search_space_max.p, counts[ 1 ], pj ),
+                cuhyso::sample_parameter( search_space_min.DeltaK_thr,
+                                          search_space_max.DeltaK_thr,
+                                          counts[ 2 ],
+                                          DeltaKj ),
+                cuhyso::sample_parameter(
+                  search_space_min.A, search_space_max.A, counts[ 3 ], Aj ) } );
+          }
+
+    return counts;
+  };
+
+  for ( st t = 0; t != iterations && !stop_requested; t++ )
+  {
+    std::vector< std::thread > threads;
+
+    const auto fidelity = fidelity_schedule< Norm >(
+      box_fraction( search_space_min, search_space_max ), smallest_test );
+
+    for ( auto& scratch : scratches )
+    {
+      scratch.fidelity = fidelity;
+    }
+
+    // Values of different fidelities are not comparable. The round starts afresh and its best
+    // candidate is checked against the incumbent at full fidelity below.
+    if ( !fidelity.full( ) )
+    {
+      for ( st tid = 0; tid != num_threads; tid++ )
+      {
+        objective_mins[ tid ]       = std::numeric_limits< T >::max( );
+        max_utilization_mins[ tid ] = 0.0;
+      }
+    }
+
+    // The candidates of the round, and the range of them of each thread
+    std::vector< params_t > candidates;
+    std::vector< st >       thread_begin;
+    std::array< st, 4 >     adaptive_counts { };
+
+    if ( sampler == cuhyso::sampler_t::grid )
+    {
+      auto D_index_span = std::floor( ( subdD ) / num_threads );
+
+      for ( st tid = 0; tid != num_threads; tid++ )
+      {
+        thread_begin.push_back( candidates.size( ) );
+
+        auto start  = D_index_span * tid;
+        auto finish = ( tid == num_threads - 1 ) ? subdD : start + D_index_span;
+
+        for ( auto dj = start; dj != finish; dj++ )
+        {
+          append_grid_candidates( dj, candidates );
+        }
+      }
+    }
+    else
+    {
+      const auto budget_or_grid = budget > 0 ? budget : st( std::pow( subd, 4 ) );
+
+      if ( sampler == cuhyso::sampler_t::adaptive_grid )
+      {
+        adaptive_counts = append_adaptive_candidates( candidates );
+      }
+      else
+      {
+        for ( const auto& u : cuhyso::sample_unit_cube( sampler, 4, budget_or_grid, t ) )
+        {
+          params_t obj_params;
+
+          obj_params.D = std::pow(
+            10.0,
+            std::log10( search_space_min.D )
+              + u[ 0 ] * ( std::log10( search_space_max.D ) - std::log10( search_space_min.D ) ) );
+          obj_params.p = search_space_min.p + u[ 1 ] * ( search_space_max.p - search_space_min.p );
+          obj_params.DeltaK_thr
+            = search_space_min.DeltaK_thr
+              + u[ 2 ] * ( search_space_max.DeltaK_thr - search_space_min.DeltaK_thr );
+          obj_params.A = search_space_min.A + u[ 3 ] * ( search_space_max.A - search_space_min.A );
+
+          candidates.push_back( obj_params );
+        }
+      }
+
+      for ( st tid = 0; tid != num_threads; tid++ )
+      {
+        thread_begin.push_back( candidates.size( ) * tid / num_threads );
+      }
+    }
+
+    thread_begin.push_back( candidates.size( ) );
+
+    // Objective of every candidate, for the sensitivities of the adaptive grid
+    std::vector< T >      values( candidates.size( ), std::numeric_limits< T >::max( ) );
+    std::vector< double > utilizations( candidates.size( ), 0.0 );
+
+    for ( st tid = 0; tid != num_threads; tid++ )
+    {
+      threads.push_back( std::thread( [ per_thread_callback,
+                                        tid,
+                                        &stop_requested,
+                                        &candidates,
+                                        &thread_begin,
+                                        &values,
+                                        &utilizations,
+                                        &max_utilization_mins,
+                                        &objective_mins,
+                                        &params_mins,
+                                        &scratches,
+                                        &prepared,
+                                        &is_better,
+                                        scale ]( ) {
+        auto& scratch = scratches[ tid ];
+
+        for ( auto i = thread_begin[ tid ]; i != thread_begin[ tid + 1 ] && !stop_requested; i++ )
+        {
+          const auto& obj_params = candidates[ i ];
+
+          per_thread_callback( obj_params );
+
+          auto d = objective_function< Norm >( obj_params, prepared, scale, scratch );
+          totalevals++;
+
+          values[ i ]       = d.distance;
+          utilizations[ i ] = d.utilization;
+
+          if ( is_better(
+                 d.distance, d.utilization, objective_mins[ tid ], max_utilization_mins[ tid ] ) )
+          {
+            objective_mins[ tid ]       = d.distance;
+            params_mins[ tid ]          = obj_params;
+            max_utilization_mins[ tid ] = d.utilization;
+          }
+        }
+      } ) );
+    }
+
+    for ( st tid = 0; tid != num_threads; tid++ )
+    {
+      threads[ tid ].join( );
+    }
+
+    // Not after a stop, which leaves candidates of the round unevaluated
+    if ( sampler == cuhyso::sampler_t::adaptive_grid && !candidates.empty( ) && !stop_requested )
+    {
+      // Variation of the objective along each axis, through the best candidate of the round
+      st best = 0;
+      for ( st i = 1; i != candidates.size( ); i++ )
+      {
+        if ( is_better( values[ i ], utilizations[ i ], values[ best ], utilizations[ best ] ) )
+        {
+          best = i;
+        }
+      }
+
+      std::array< double, 4 > variations { };
+
+      st stride = 1;
+      for ( st k = 4; k-- != 0; )
+      {
+        const auto index = ( best / stride ) % adaptive_counts[ k ];
+
+        T lowest  = values[ best ];
+        T highest = values[ best ];
+        for ( st j = 0; j != adaptive_counts[ k ]; j++ )
+        {
+          const auto i = best - index * stride + j * stride;
+          if ( utilizations[ i ] >= utilizations[ best ] )
+          {
+            lowest  = std::min( lowest, values[ i ] );
+            highest = std::max( highest, values[ i ] );
+          }
+        }
+
+        variations[ k ] = double( highest - lowest );
+        stride *= adaptive_counts[ k ];
+      }
+
+      const auto active = active_axes( );
+      axis_subdivisions = allocate_subdivisions( variations, active, adaptive_budget );
+
+      // The axes resolved finer contract faster. The exponents average to one over the active
+      // axes, so every axis contracts and the volume of the box contracts by amortization to the
+      // number of active axes, as for the grid.
+      double mean_subdivisions = 0.0;
+      st     num_active        = 0;
+      for ( st k = 0; k != 4; k++ )
+      {
+        if ( active[ k ] )
+        {
+          mean_subdivisions += double( axis_subdivisions[ k ] );
+          num_active++;
+        }
+      }
+      mean_subdivisions /= std::max( num_active, st( 1 ) );
+
+      for ( st k = 0; k != 4; k++ )
+      {
+        axis_amortization[ k ]
+          = active[ k ] ? std::pow( amortization, axis_subdivisions[ k ] / mean_subdivisions )
+                        : amortization;
+      }
+    }
+
+    auto   round_min         = std::numeric_limits< T >::max( );
+    auto   round_params      = params_at_min;
+    double round_utilization = 0;
+
+    for ( st tid = 0; tid != num_threads; tid++ )
+    {
+      if ( is_better(
+             objective_mins[ tid ], max_utilization_mins[ tid ], round_min, round_utilization ) )
+      {
+        round_min         = objective_mins[ tid ];
+        round_params      = params_mins[ tid ];
+        round_utilization = max_utilization_mins[ tid ];
+      }
+    }
+
+    if ( !fidelity.full( ) )
+    {
+      auto& scratch    = scratches[ 0 ];
+      scratch.fidelity = fidelity_t { };
+
+      auto d = objective_function< Norm >( round_params, prepared, scale, scratch );
+      totalevals++;
+
+      round_min         = d.distance;
+      round_utilization = d.utilization;
+    }
+
+    if ( is_better( round_min, round_utilization, objective_min, utilization_at_min ) )
+    {
+      objective_min      = round_min;
+      params_at_min      = round_params;
+      utilization_at_min = round_utilization;
+    }
+
+    for ( st tid = 0; tid != num_threads; tid++ )
+    {
+      objective_mins[ tid ]       = objective_min;
+      params_mins[ tid ]          = params_at_min;
+      max_utilization_mins[ tid ] = utilization_at_min;
+    }
+
+    // std::cout << "Max util: " << utilization_at_min << std::endl;
+
+    if constexpr ( std::is_invocable_v< Callback&,
+                                        const params_t&,
+                                        const params_t&,
+                                        const params_t&,
+                                        const Model_Distance_t< T >& > )
+    {
+      callback( params_at_min,
+                search_space_min,
+                search_space_max,
+                Model_Distance_t< T >( objective_min, utilization_at_min ) );
+    }
+    else
+    {
+      callback( params_at_min, search_space_min, search_space_max );
+    }
+
+    const auto& a = axis_amortization;
+
+    T Dlmin                  = 0;
+    T Dlmax                  = 0;
+    std::tie( Dlmin, Dlmax ) = contract_range( std::log10( search_space_min.D ),
+                                               std::log10( search_space_max.D ),
+                                               std::log10( params_at_min.D ),
+                                               a[ 0 ] );
+
+    search_space_min.D = std::pow( 10.0, Dlmin );
+    search_space_max.D = std::pow( 10.0, Dlmax );
+
+    std::tie( search_space_min.p, search_space_max.p )
+      = contract_range( search_space_min.p, search_space_max.p, params_at_min.p, a[ 1 ] );
+
+    std::tie( search_space_min.DeltaK_thr, search_space_max.DeltaK_thr ) = contract_range(
+      search_space_min.DeltaK_thr, search_space_max.DeltaK_thr, params_at_min.DeltaK_thr, a[ 2 ] );
+
+    std::tie( search_space_min.A, search_space_max.A )
+      = contract_range( search_space_min.A, search_space_max.A, params_at_min.A, a[ 3 ] );
+
+    progress_callback( t, iterations );
+
+//    std::cout << search_space_min.D << " " << search_space_max.D << " " << params_at_min.D << " "
+//              << objective_min << std::endl;
+  }
+
+  // TODO: Is this correct? For some reason it was not here
+  return params_at_min;
+}
+
+} // namespace detail
+
+// The norm is selected once per fit. The grid loop then runs on a kernel specialized for it.
+template< class T, class Container_t >
+parameters< T > fit(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  const std::size_t   subdivisions,
+  const double&       amortization,
+  std::size_t         iterations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {},
+  cuhyso::sampler_t                        sampler             = cuhyso::sampler_t::grid,
+  std::size_t                              budget              = 0 )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit< decltype( norm_policy ) >( search_space_min,
+                                                   search_space_max,
+                                                   test_set,
+                                                   subdivisions,
+                                                   amortization,
+                                                   iterations,
+                                                   callback,
+                                                   progress_callback,
+                                                   stop_requested,
+                                                   per_thread_callback,
+                                                   sampler,
+                                                   budget );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+template< class T, class Container_t >
+parameters< T > fit(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  const std::size_t   subdivisions  = 7,
+  const double&       amortization  = 1.02,
+  std::size_t         iterations    = 0,
+  bool                use_geometric = false,
+  callback_t< T >     callback      = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
+{
+  return fit( search_space_min,
+              search_space_max,
+              std::move( test_set ),
+              subdivisions,
+              amortization,
+              iterations,
+              use_geometric ? norm_t::geometric : norm_t::ordinary,
+              callback,
+              progress_callback,
+              stop_requested,
+              per_thread_callback );
+}
+
+namespace detail
+{
+
+// Runs minimize( objective, low, high, report ) over ( log10 D, p, DeltaK_thr, A ), the axes with
+// an empty range held fixed. objective( x, thread ) may be called from num_threads threads at once,
+// and report( x, low, high ) forwards a new minimum and its box to callback. Utilization is
+// preferred over minimization, as in fit, through a penalty on the rejected weight.
+template< class Norm, class T, class Container_t, class Minimize >
+parameters< T > fit_box_search( parameters< T >                          search_space_min,
+                                parameters< T >                          search_space_max,
+                                const Container_t&                       test_set,
+                                std::size_t                              num_threads,
+                                callback_t< T >                          callback,
+                                std::function< void( parameters< T > ) > per_thread_callback,
+                                Minimize&&                               minimize )
+{
+  using params_t = parameters< T >;
+
+  const auto scale = detail::checked_scale< T >( test_set );
+
+  const auto prepared = prepare_test_set< T >( test_set );
+
+  auto to_array = []( const params_t& params ) {
+    return std::array< T, 4 > {
+      std::log10( params.D ), params.p, params.DeltaK_thr, params.A };
+  };
+
+  auto to_params = []( const std::array< T, 4 >& x ) {
+    return params_t { std::pow( 10.0, x[ 0 ] ), x[ 1 ], x[ 2 ], x[ 3 ] };
+  };
+
+  const auto fixed = to_array( search_space_min );
+  const auto upper = to_array( search_space_max );
+
+  std::vector< std::size_t > axes;
+  std::vector< T >           low, high;
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    if ( std::fabs( upper[ k ] - fixed[ k ] ) >= 1e-19 )
+    {
+      axes.push_back( k );
+      low.push_back( fixed[ k ] );
+      high.push_back( upper[ k ] );
+    }
+  }
+
+  if ( axes.empty( ) )
+  {
+    return search_space_min;
+  }
+
+  auto params_of = [ & ]( const std::vector< T >& x ) {
+    auto full = fixed;
+    for ( std::size_t j = 0; j != axes.size( ); j++ )
+    {
+      full[ axes[ j ] ] = x[ j ];
+    }
+    return to_params( full );
+  };
+
+  std::vector< distance_scratch_t< T > > scratches( num_threads );
+
+  auto objective = [ & ]( const std::vector< T >& x, std::size_t tid ) {
+    const auto params = params_of( x );
+
+    per_thread_callback( params );
+
+    auto d = objective_function< Norm >( params, prepared, scale, scratches[ tid ] );
+
+    return detail::penalized( d );
+  };
+
+  auto report = [ & ]( std::vector< T > x, std::vector< T > box_low, std::vector< T > box_high ) {
+    callback( params_of( x ), params_of( box_low ), params_of( box_high ) );
+  };
+
+  return params_of( minimize( objective, low, high, report ) );
+}
+
+template< class Norm, class T, class Container_t >
+parameters< T > fit_direct( parameters< T >                          search_space_min,
+                            parameters< T >                          search_space_max,
+                            const Container_t&                       test_set,
+                            std::size_t                              max_evaluations,
+                            callback_t< T >                          callback,
+                            progress_callback_t                      progress_callback,
+                            const bool&                              stop_requested,
+                            std::function< void( parameters< T > ) > per_thread_callback )
+{
+  nelder_mead::direct_options_t< T > options;
+  options.max_evaluations = max_evaluations;
+  options.size_threshold  = 1e-6;
+  options.num_threads     = detail::thread_count( );
+
+  return fit_box_search< Norm >(
+    search_space_min,
+    search_space_max,
+    test_set,
+    options.num_threads,
+    callback,
+    per_thread_callback,
+    [ & ]( auto& objective, auto& low, auto& high, auto& report ) {
+      return nelder_mead::search< T >(
+        objective, low, high, options, report, progress_callback, stop_requested );
+    } );
+}
+
+template< class Norm, class T, class Container_t >
+parameters< T > fit_cmaes( parameters< T >                          search_space_min,
+                           parameters< T >                          search_space_max,
+                           const Container_t&                       test_set,
+                           std::size_t                              max_evaluations,
+                           cmaes::restarts_t                        restarts,
+                           callback_t< T >                          callback,
+                           progress_callback_t                      progress_callback,
+                           const bool&                              stop_requested,
+                           std::function< void( parameters< T > ) > per_thread_callback )
+{
+  cmaes::options_t< T > options;
+  options.max_evaluations = max_evaluations;
+  options.restarts        = restarts;
+  options.num_threads     = detail::thread_count( );
+
+  return fit_box_search< Norm >(
+    search_space_min,
+    search_space_max,
+    test_set,
+    options.num_threads,
+    callback,
+    per_thread_callback,
+    [ & ]( auto& objective, auto& low, auto& high, auto& report ) {
+      return cmaes::minimize< T >(
+        objective, low, high, { }, options, report, progress_callback, stop_requested );
+    } );
+}
+
+template< class Norm, class T, class Container_t >
+parameters< T > fit_differential_evolution(
+  parameters< T >                          search_space_min,
+  parameters< T >                          search_space_max,
+  const Container_t&                       test_set,
+  std::size_t                              max_evaluations,
+  differential_evolution::strategy_t       strategy,
+  differential_evolution::mode_t           mode,
+  callback_t< T >                          callback,
+  progress_callback_t                      progress_callback,
+  const bool&                              stop_requested,
+  std::function< void( parameters< T > ) > per_thread_callback )
+{
+  differential_evolution::options_t< T > options;
+  options.max_evaluations = max_evaluations;
+  options.strategy        = strategy;
+  options.mode            = mode;
+  options.num_threads     = detail::thread_count( );
+
+  return fit_box_search< Norm >(
+    search_space_min,
+    search_space_max,
+    test_set,
+    options.num_threads,
+    callback,
+    per_thread_callback,
+    [ & ]( auto& objective, auto& low, auto& high, auto& report ) {
+      return differential_evolution::minimize< T >(
+        objective, low, high, { }, options, report, progress_callback, stop_requested );
+    } );
+}
+
+template< class Norm, class T, class Container_t >
+parameters< T > fit_surrogate( parameters< T >                          search_space_min,
+                               parameters< T >                          search_space_max,
+                               const Container_t&                       test_set,
+                               std::size_t                              max_evaluations,
+                               callback_t< T >                          callback,
+                               progress_callback_t                      progress_callback,
+                               const bool&                              stop_requested,
+                               std::function< void( parameters< T > ) > per_thread_callback )
+{
+  surrogate::options_t< T > options;
+  options.max_evaluations = max_evaluations;
+  options.num_threads     = detail::thread_count( );
+
+  return fit_box_search< Norm >(
+    search_space_min,
+    search_space_max,
+    test_set,
+    options.num_threads,
+    callback,
+    per_thread_callback,
+    [ & ]( auto& objective, auto& low, auto& high, auto& report ) {
+      return surrogate::minimize< T >(
+        objective, low, high, { }, options, report, progress_callback, stop_requested );
+    } );
+}
+
+} // namespace detail
+
+// Deterministic global alternative to the contraction of fit: DIRECT-L over the search box, the
+// new points of each iteration evaluated in parallel. callback receives each new minimum and the
+// box of its rectangle.
+template< class T, class Container_t >
+parameters< T > fit_direct(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  std::size_t         max_evaluations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_direct< decltype( norm_policy ) >( search_space_min,
+                                                          search_space_max,
+                                                          test_set,
+                                                          max_evaluations,
+                                                          callback,
+                                                          progress_callback,
+                                                          stop_requested,
+                                                          per_thread_callback );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// CMA-ES with IPOP or BIPOP restarts over the search box, each generation evaluated in parallel.
+// callback receives each new minimum and the box of two standard deviations of the search
+// distribution.
+template< class T, class Container_t >
+parameters< T > fit_cmaes(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  std::size_t         max_evaluations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {},
+  cmaes::restarts_t                        restarts            = cmaes::restarts_t::bipop )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_cmaes< decltype( norm_policy ) >( search_space_min,
+                                                         search_space_max,
+                                                         test_set,
+                                                         max_evaluations,
+                                                         restarts,
+                                                         callback,
+                                                         progress_callback,
+                                                         stop_requested,
+                                                         per_thread_callback );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// Differential evolution over the search box. In the asynchronous mode the threads update the
+// population without generation barriers, which keeps them busy when the cost of the objective
+// varies among candidates, as with the geometric norm. callback receives each new minimum and the
+// bounding box of the population.
+template< class T, class Container_t >
+parameters< T > fit_differential_evolution(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  std::size_t         max_evaluations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {},
+  differential_evolution::strategy_t strategy = differential_evolution::strategy_t::jade,
+  differential_evolution::mode_t     mode     = differential_evolution::mode_t::asynchronous )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_differential_evolution< decltype( norm_policy ) >( search_space_min,
+                                                                          search_space_max,
+                                                                          test_set,
+                                                                          max_evaluations,
+                                                                          strategy,
+                                                                          mode,
+                                                                          callback,
+                                                                          progress_callback,
+                                                                          stop_requested,
+                                                                          per_thread_callback );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// Gaussian process surrogate search for expensive objectives, such as the geometric norms on large
+// test sets, within a budget of a few thousand evaluations. callback receives each new minimum and
+// the trust region around it.
+template< class T, class Container_t >
+parameters< T > fit_surrogate(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  std::size_t         max_evaluations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_surrogate< decltype( norm_policy ) >( search_space_min,
+                                                             search_space_max,
+                                                             test_set,
+                                                             max_evaluations,
+                                                             callback,
+                                                             progress_callback,
+                                                             stop_requested,
+                                                             per_thread_callback );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// Result of fit_branch_and_bound. gap bounds the objective of the estimate above the global
+// minimum, infinite while the estimate does not utilize all points. certified is set if no box was
+// left open, so that the gap is within tolerance.
+template< class T >
+struct branch_and_bound_t
+{
+  parameters< T > estimate;
+
+  T           objective   = 0.0;
+  double      utilization = 0.0;
+  T           gap         = std::numeric_limits< T >::infinity( );
+  bool        certified   = false;
+  std::size_t evaluations = 0;
+};
+
+namespace detail
+{
+
+// Best first branch and bound over ( log10 D, p, DeltaK_thr, A ). Each batch bisects the open boxes
+// with the lowest lower bounds along their widest axis, relative to the initial box, and evaluates
+// the objective at the centers and the lower bounds of the halves in parallel. Boxes whose lower
+// bound is within tolerance of the incumbent are discarded once the incumbent utilizes all points.
+// Before that, a box may hold parameters that utilize more points at a larger objective, which are
+// preferred, so the lower bounds of the objective cannot discard it.
+template< class Norm, class T, class Container_t >
+branch_and_bound_t< T >
+fit_branch_and_bound( parameters< T >                          search_space_min,
+                      parameters< T >                          search_space_max,
+                      const Container_t&                       test_set,
+                      const T&                                 tolerance,
+                      std::size_t                              max_evaluations,
+                      callback_t< T >                          callback,
+                      progress_callback_t                      progress_callback,
+                      const bool&                              stop_requested,
+                      std::function< void( parameters< T > ) > per_thread_callback )
+{
+  using params_t = parameters< T >;
+  using st       = std::size_t;
+
+  if constexpr ( Norm::geometric
+                 || !( Norm::aggregation == aggregation_t::mean
+                       || Norm::aggregation == aggregation_t::huber ) )
+  {
+    throw std::runtime_error(
+      "Branch and bound is available for the ordinary and ordinary Huber norms only." );
+  }
+  else
+  {
+    const auto scale = detail::checked_scale< T >( test_set );
+
+    const auto prepared = prepare_test_set< T >( test_set );
+
+    auto is_better
+      = []( const T& distance, double utilization, const T& best, double best_utilization ) {
+          return utilization > best_utilization
+                 || ( best > distance && utilization >= best_utilization );
+        };
+
+    // Boxes in ( log10 D, p, DeltaK_thr, A )
+    using point_t = std::array< T, 4 >;
+
+    struct box_t
+    {
+      point_t low;
+      point_t high;
+      T       lower_bound = 0.0;
+    };
+
+    auto to_point = []( const params_t& params ) {
+      return point_t { std::log10( params.D ), params.p, params.DeltaK_thr, params.A };
+    };
+
+    auto to_params = []( const point_t& x ) {
+      return params_t { std::pow( 10.0, x[ 0 ] ), x[ 1 ], x[ 2 ], x[ 3 ] };
+    };
+
+    const auto initial_low  = to_point( search_space_min );
+    const auto initial_high = to_point( search_space_max );
+
+    st num_threads = detail::thread_count( );
+    const st batch_size = 8 * num_threads;
+
+    std::vector< distance_scratch_t< T > > scratches( num_threads );
+
+    auto   objective_min      = std::numeric_limits< T >::max( );
+    auto   params_at_min      = params_t { 0.0, 0.0, 0.0, 0.0 };
+    double utilization_at_min = 0;
+
+    std::vector< box_t > open { { initial_low, initial_high, 0.0 } };
+
+    st evaluations = 0;
+
+    while ( !open.empty( ) && evaluations < max_evaluations && !stop_requested )
+    {
+      const auto batch = std::min( batch_size, open.size( ) );
+
+      std::partial_sort( open.begin( ),
+                         open.begin( ) + batch,
+                         open.end( ),
+                         []( const box_t& a, const box_t& b ) {
+                           return a.lower_bound < b.lower_bound;
+                         } );
+
+      std::vector< box_t > children;
+      for ( st b = 0; b != batch; b++ )
+      {
+        const auto& box = open[ b ];
+
+        st axis      = 0;
+        T  max_width = -1;
+        for ( st k = 0; k != 4; k++ )
+        {
+          const auto initial_width = initial_high[ k ] - initial_low[ k ];
+          if ( std::fabs( initial_width ) < 1e-19 )
+          {
+            continue;
+          }
+
+          const auto width = ( box.high[ k ] - box.low[ k ] ) / initial_width;
+          if ( width > max_width )
+          {
+            max_width = width;
+            axis      = k;
+          }
+        }
+
+        const auto middle = ( box.low[ axis ] + box.high[ axis ] ) / 2;
+
+        children.push_back( box );
+        children.back( ).high[ axis ] = middle;
+
+        children.push_back( box );
+        children.back( ).low[ axis ] = middle;
+      }
+
+      open.erase( open.begin( ), open.begin( ) + batch );
+
+      std::vector< Model_Distance_t< T > > centers( children.size( ), { T( 0.0 ), 0.0 } );
+      std::vector< params_t >             center_params( children.size( ) );
+
+      std::vector< std::thread > threads;
+      for ( st tid = 0; tid != num_threads; tid++ )
+      {
+        threads.push_back( std::thread( [ &, tid ]( ) {
+          for ( auto c = tid; c < children.size( ); c += num_threads )
+          {
+            auto& child = children[ c ];
+
+            point_t center;
+            for ( st k = 0; k != 4; k++ )
+            {
+              center[ k ] = ( child.low[ k ] + child.high[ k ] ) / 2;
+            }
+
+            center_params[ c ] = to_params( center );
+            per_thread_callback( center_params[ c ] );
+
+            centers[ c ] = objective_function< Norm >(
+              center_params[ c ], prepared, scale, scratches[ tid ] );
+
+            child.lower_bound = objective_lower_bound< Norm >(
+              to_params( child.low ), to_params( child.high ), prepared );
+          }
+        } ) );
+      }
+
+      for ( auto& thread : threads )
+      {
+        thread.join( );
+      }
+
+      evaluations += children.size( );
+
+      for ( st c = 0; c != children.size( ); c++ )
+      {
+        const auto& center = centers[ c ];
+
+        if ( is_better( center.distance, center.utilization, objective_min, utilization_at_min ) )
+        {
+          objective_min      = center.distance;
+          params_at_min      = center_params[ c ];
+          utilization_at_min = center.utilization;
+        }
+      }
+
+      open.insert( open.end( ), children.begin( ), children.end( ) );
+
+      if ( utilization_at_min >= 1.0 )
+      {
+        open.erase( std::remove_if( open.begin( ),
+                                    open.end( ),
+                                    [ & ]( const box_t& box ) {
+                                      return box.lower_bound >= objective_min - tolerance;
+                                    } ),
+                    open.end( ) );
+      }
+
+      // The hull of the open boxes is where the minimum can still be
+      auto hull_low  = to_point( params_at_min );
+      auto hull_high = hull_low;
+      for ( const auto& box : open )
+      {
+        for ( st k = 0; k != 4; k++ )
+        {
+          hull_low[ k ]  = std::min( hull_low[ k ], box.low[ k ] );
+          hull_high[ k ] = std::max( hull_high[ k ], box.high[ k ] );
+        }
+      }
+
+      callback( params_at_min, to_params( hull_low ), to_params( hull_high ) );
+
+      progress_callback( std::min( evaluations, max_evaluations ), max_evaluations );
+    }
+
+    branch_and_bound_t< T > result;
+    result.estimate    = params_at_min;
+    result.objective   = objective_min;
+    result.utilization = utilization_at_min;
+    result.evaluations = evaluations;
+
+    if ( utilization_at_min >= 1.0 )
+    {
+      // Discarded boxes only bound the minimum to within tolerance
+      result.gap = tolerance;
+      for ( const auto& box : open )
+      {
+        result.gap = std::max( result.gap, objective_min - box.lower_bound );
+      }
+
+      result.certified = open.empty( );
+    }
+
+    return result;
+  }
+}
+
+} // namespace detail
+
+// Global minimum of the ordinary or ordinary Huber norm, certified to within tolerance (in the
+// units of the objective) unless max_evaluations runs out first. callback receives the incumbent
+// and the hull of the boxes that may still contain a better minimum.
+template< class T, class Container_t >
+branch_and_bound_t< T > fit_branch_and_bound(
+  parameters< T >     search_space_min,
+  parameters< T >     search_space_max,
+  Container_t         test_set,
+  const T&            tolerance,
+  std::size_t         max_evaluations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested                           = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_branch_and_bound< decltype( norm_policy ) >( search_space_min,
+                                                                    search_space_max,
+                                                                    test_set,
+                                                                    tolerance,
+                                                                    max_evaluations,
+                                                                    callback,
+                                                                    progress_callback,
+                                                                    stop_requested,
+                                                                    per_thread_callback );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// Engines of fit_race
+enum class engine_t
+{
+  grid,
+  direct,
+  cmaes,
+  differential_evolution,
+  surrogate,
+  nelder_mead
+};
+
+namespace detail
+{
+
+// Runs the engines at once, each on an equal share of the cores, and refers them to the best
+// minimum among them. An engine that has not improved on its own minimum within patience
+// evaluations while another holds a better one is cancelled, and the race is over once the engine
+// that holds the best minimum has converged or max_evaluations have been spent altogether.
+template< class Norm, class T, class Container_t >
+parameters< T > fit_race( parameters< T >                          search_space_min,
+                          parameters< T >                          search_space_max,
+                          const Container_t&                       test_set,
+                          const std::vector< engine_t >&           engines,
+                          const std::size_t                        subdivisions,
+                          const double&                            amortization,
+                          std::size_t                              max_evaluations,
+                          callback_t< T >                          callback,
+                          progress_callback_t                      progress_callback,
+                          const bool&                              stop_requested,
+                          std::function< void( parameters< T > ) > per_thread_callback )
+{
+  using st       = std::size_t;
+  using params_t = parameters< T >;
+
+  if ( engines.empty( ) )
+  {
+    throw std::runtime_error( "The race needs at least one engine." );
+  }
+
+  const st count    = engines.size( );
+  const st patience = std::max( st( 500 ), max_evaluations / 10 );
+
+  // Threads of each engine
+  const st num_threads = std::max( st( 1 ), detail::thread_count( ) / count );
+
+  // Updated by the engines without a lock
+  struct standing_t
+  {
+    std::atomic< st >     evaluations { 0 };
+    std::atomic< st >     last_improvement { 0 };
+    std::atomic< double > best { std::numeric_limits< double >::max( ) };
+    std::atomic< bool >   stop { false }; // Referenced by the engine as its stop flag
+    std::atomic< bool >   finished { false };
+  };
+
+  std::vector< standing_t > standings( count );
+
+  // The incumbent is guarded by mutex, which is taken only for values no worse than its hint
+  std::mutex            mutex;
+  T                     incumbent           = std::numeric_limits< T >::max( );
+  params_t              params_at_incumbent = search_space_min;
+  std::atomic< double > incumbent_hint { std::numeric_limits< double >::max( ) };
+  std::atomic< st >     leader { count };
+
+  // set_params stores the parameters of a new incumbent in params_at_incumbent
+  auto offer = [ & ]( st e, const T& value, auto&& set_params ) {
+    auto&        standing = standings[ e ];
+    const double v        = double( value );
+
+    for ( double best = standing.best; v < best; )
+    {
+      if ( standing.best.compare_exchange_weak( best, v ) )
+      {
+        if ( v < best - 1.0e-6 * std::fabs( best ) )
+        {
+          standing.last_improvement = standing.evaluations.load( );
+        }
+        break;
+      }
+    }
+
+    if ( v <= incumbent_hint )
+    {
+      std::lock_guard< std::mutex > lock( mutex );
+      if ( value < incumbent )
+      {
+        incumbent      = value;
+        incumbent_hint = v;
+        leader         = e;
+        set_params( );
+        callback( params_at_incumbent, params_at_incumbent, params_at_incumbent );
+      }
+    }
+  };
+
+  std::vector< std::thread > threads;
+
+  std::vector< st > box_engines;
+  for ( st e = 0; e != count; e++ )
+  {
+    if ( engines[ e ] != engine_t::grid )
+    {
+      box_engines.push_back( e );
+      continue;
+    }
+
+    threads.push_back( std::thread( [ &, e ]( ) {
+      fit< Norm, T >(
+        search_space_min,
+        search_space_max,
+        test_set,
+        subdivisions,
+        amortization,
+        0,
+        [ & ]( const params_t& params,
+               const params_t&,
+               const params_t&,
+               const Model_Distance_t< T >& d ) {
+          offer( e, detail::penalized( d ), [ & ]( ) {
+            params_at_incumbent = params;
+          } );
+        },
+        []( std::size_t, std::size_t ) {},
+        standings[ e ].stop,
+        [ & ]( params_t params ) {
+          per_thread_callback( params );
+          standings[ e ].evaluations++;
+        },
+        cuhyso::sampler_t::grid,
+        0,
+        num_threads );
+
+      standings[ e ].finished = true;
+    } ) );
+  }
+
+  if ( !box_engines.empty( ) )
+  {
+    threads.push_back( std::thread( [ & ]( ) {
+      params_t reported;
+
+      fit_box_search< Norm, T >(
+        search_space_min,
+        search_space_max,
+        test_set,
+        num_threads * box_engines.size( ),
+        [ & ]( params_t params, params_t, params_t ) { reported = params; },
+        per_thread_callback,
+        [ & ]( auto& objective, auto& low, auto& high, auto& report ) {
+          auto no_callback = []( std::vector< T >, std::vector< T >, std::vector< T > ) {};
+          auto no_progress = []( std::size_t, std::size_t ) {};
+
+          std::vector< std::thread > box_threads;
+          for ( st k = 0; k != box_engines.size( ); k++ )
+          {
+            box_threads.push_back( std::thread( [ &, k ]( ) {
+              const st    e    = box_engines[ k ];
+              const auto& stop = standings[ e ].stop;
+
+              // Each engine on its own range of the scratches of fit_box_search
+              auto f = [ &, e, k ]( const std::vector< T >& x, std::size_t thread ) {
+                const T value = objective( x, k * num_threads + thread );
+
+                standings[ e ].evaluations++;
+                offer( e, value, [ & ]( ) {
+                  report( x, x, x );
+                  params_at_incumbent = reported;
+                } );
+
+                return value;
+              };
+
+              switch ( engines[ e ] )
+              {
+              case engine_t::direct:
+              {
+                nelder_mead::direct_options_t< T > options;
+                options.max_evaluations = max_evaluations;
+                options.size_threshold  = 1e-6;
+                options.num_threads     = num_threads;
+
+                nelder_mead::search< T >(
+                  f, low, high, options, no_callback, no_progress, stop );
+                break;
+              }
+              case engine_t::cmaes:
+              {
+                cmaes::options_t< T > options;
+                options.max_evaluations = max_evaluations;
+                options.num_threads     = num_threads;
+
+                cmaes::minimize< T >(
+                  f, low, high, { }, options, no_callback, no_progress, stop );
+                break;
+              }
+              case engine_t::differential_evolution:
+              {
+                differential_evolution::options_t< T > options;
+                options.max_evaluations = max_evaluations;
+                options.num_threads     = num_threads;
+
+                differential_evolution::minimize< T >(
+                  f, low, high, { }, options, no_callback, no_progress, stop );
+                break;
+              }
+              case engine_t::surrogate:
+              {
+                surrogate::options_t< T > options;
+                options.max_evaluations = max_evaluations;
+                options.num_threads     = num_threads;
+
+                surrogate::minimize< T >(
+                  f, low, high, { }, options, no_callback, no_progress, stop );
+                break;
+              }
+              case engine_t::nelder_mead:
+              {
+                // A simplex from the center of the box and the others from random points, each on
+                // one thread
+                nelder_mead::simplex_options_t< T > options;
+                options.max_evaluations = max_evaluations;
+                options.size_threshold  = 1e-8;
+                options.simplices       = num_threads;
+                options.num_threads     = num_threads;
+
+                std::vector< T > center( low.size( ) );
+                for ( st j = 0; j != low.size( ); j++ )
+                {
+                  center[ j ] = ( low[ j ] + high[ j ] ) / 2;
+                }
+
+                nelder_mead::minimize< T >(
+                  f, center, low, high, options, no_callback, no_progress, stop );
+                break;
+              }
+              case engine_t::grid:
+                break;
+              }
+
+              standings[ e ].finished = true;
+            } ) );
+          }
+
+          for ( auto& thread : box_threads )
+          {
+            thread.join( );
+          }
+
+          return low;
+        } );
+    } ) );
+  }
+
+  // Referee
+  for ( bool running = true; running; )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+
+    st spent = 0;
+    for ( const auto& standing : standings )
+    {
+      spent += standing.evaluations;
+    }
+    progress_callback( std::min( spent, max_evaluations ), max_evaluations );
+
+    const st     first = leader;
+    const double hint  = incumbent_hint;
+
+    // Over once the leader has converged by itself
+    const bool settled
+      = first != count && standings[ first ].finished && !standings[ first ].stop;
+    const bool over = stop_requested || spent >= max_evaluations || settled;
+
+    running = false;
+
+    for ( st e = 0; e != count; e++ )
+    {
+      auto& standing = standings[ e ];
+
+      // Read before the evaluations, which only grow, so that the difference cannot wrap
+      const st since = standing.last_improvement;
+
+      const bool stale = e != first && standing.best > hint
+                         && standing.evaluations - since > patience;
+
+      if ( over || stale )
+      {
+        standing.stop = true;
+      }
+
+      running = running || !standing.finished;
+    }
+  }
+
+  for ( auto& thread : threads )
+  {
+    thread.join( );
+  }
+
+  return params_at_incumbent;
+}
+
+} // namespace detail
+
+// Races the engines at once on the search box, for when it is not known which one suits the data
+// best. subdivisions and amortization are those of the grid engine, and max_evaluations the budget
+// of all of them together. callback receives each new minimum among them.
+template< class T, class Container_t >
+parameters< T > fit_race(
+  parameters< T >         search_space_min,
+  parameters< T >         search_space_max,
+  Container_t             test_set,
+  std::vector< engine_t > engines,
+  const std::size_t       subdivisions,
+  const double&           amortization,
+  std::size_t             max_evaluations,
+  norm_t                  norm,
+  callback_t< T >         callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t     progress_callback                    = []( std::size_t, std::size_t ) {},
+  const bool&             stop_requested                       = false,
+  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_race< decltype( norm_policy ) >( search_space_min,
+                                                        search_space_max,
+                                                        test_set,
+                                                        engines,
+                                                        subdivisions,
+                                                        amortization,
+                                                        max_evaluations,
+                                                        callback,
+                                                        progress_callback,
+                                                        stop_requested,
+                                                        per_thread_callback );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+namespace detail
+{
+
+// Solves ( H + lambda diag( H ) ) x = -g, H row-major n x n, by Gaussian elimination with partial
+// pivoting. False if the damped matrix is singular.
+template< class T >
+bool damped_step( std::vector< T > H, std::vector< T > g, const T& lambda, std::vector< T >& x )
+{
+  const auto n = g.size( );
+
+  for ( std::size_t i = 0; i != n; i++ )
+  {
+    H[ i * n + i ] *= 1.0 + lambda;
+    g[ i ] = -g[ i ];
+  }
+
+  for ( std::size_t k = 0; k != n; k++ )
+  {
+    std::size_t pivot = k;
+    for ( std::size_t i = k + 1; i != n; i++ )
+    {
+      if ( std::fabs( H[ i * n + k ] ) > std::fabs( H[ pivot * n + k ] ) )
+      {
+        pivot = i;
+      }
+    }
+
+    if ( !( std::fabs( H[ pivot * n + k ] ) > 0 ) )
+    {
+      return false;
+    }
+
+    for ( std::size_t j = 0; j != n; j++ )
+    {
+      std::swap( H[ k * n + j ], H[ pivot * n + j ] );
+    }
+    std::swap( g[ k ], g[ pivot ] );
+
+    for ( std::size_t i = k + 1; i != n; i++ )
+    {
+      const T factor = H[ i * n + k ] / H[ k * n + k ];
+      for ( std::size_t j = k; j != n; j++ )
+      {
+        H[ i * n + j ] -= factor * H[ k * n + j ];
+      }
+      g[ i ] -= factor * g[ k ];
+    }
+  }
+
+  x.assign( n, 0.0 );
+  for ( std::size_t k = n; k-- != 0; )
+  {
+    T sum = g[ k ];
+    for ( std::size_t j = k + 1; j != n; j++ )
+    {
+      sum -= H[ k * n + j ] * x[ j ];
+    }
+    x[ k ] = sum / H[ k * n + k ];
+  }
+
+  return true;
+}
+
+// Levenberg-Marquardt from start over ( log10 D, p, DeltaK_thr, A ), the axes with an empty range
+// held fixed and the steps clamped to the box. The residuals are the log10 da/dN residuals of the
+// points, at their DeltaK for the ordinary norms and at their foot points for the geometric ones,
+// where the distance depends on the parameters only through them. There the curvature is scaled
+// by the squared cosine of the curve slope, which accounts for the foot points moving. The
+// Jacobian comes from evaluate instantiated with dual numbers, DeltaK being the last variable.
+// The ordinary norms are not sums of squares, so each iteration reweights the residuals by the
+// derivative of their loss over their magnitude (iteratively reweighted least squares). Axes at a
+// bound that the gradient pushes out of are held for the iteration. A step is accepted if it
+// lowers the objective itself.
+template< class Norm, class T, class Container_t >
+parameters< T > fit_levenberg_marquardt( parameters< T >     search_space_min,
+                                         parameters< T >     search_space_max,
+                                         const Container_t&  test_set,
+                                         parameters< T >     start,
+                                         std::size_t         max_iterations,
+                                         callback_t< T >     callback,
+                                         progress_callback_t progress_callback,
+                                         const bool&         stop_requested )
+{
+  using params_t = parameters< T >;
+  using st       = std::size_t;
+
+  if constexpr ( !( Norm::aggregation == aggregation_t::mean
+                    || Norm::aggregation == aggregation_t::huber ) )
+  {
+    throw std::runtime_error(
+      "Levenberg-Marquardt is available for the mean and Huber aggregations only." );
+  }
+  else
+  {
+    using number_t = dual::dual_t< T, 5 >;
+
+    const auto scale = detail::checked_scale< T >( test_set );
+
+    const auto prepared = prepare_test_set< T >( test_set );
+
+    std::vector< T > Rs( prepared.points.size( ) );
+    for ( const auto& block : prepared.blocks )
+    {
+      std::fill( Rs.begin( ) + block.begin, Rs.begin( ) + block.end, block.R );
+    }
+
+    auto to_array = []( const params_t& params ) {
+      return std::array< T, 4 > {
+        std::log10( params.D ), params.p, params.DeltaK_thr, params.A };
+    };
+
+    auto to_params = []( const std::array< T, 4 >& x ) {
+      return params_t { std::pow( 10.0, x[ 0 ] ), x[ 1 ], x[ 2 ], x[ 3 ] };
+    };
+
+    const auto low  = to_array( search_space_min );
+    const auto high = to_array( search_space_max );
+
+    std::vector< st > axes;
+    for ( st k = 0; k != 4; k++ )
+    {
+      if ( std::fabs( high[ k ] - low[ k ] ) >= 1e-19 )
+      {
+        axes.push_back( k );
+      }
+    }
+
+    auto x = to_array( start );
+    for ( st k = 0; k != 4; k++ )
+    {
+      x[ k ] = std::clamp( x[ k ], low[ k ], high[ k ] );
+    }
+
+    distance_scratch_t< T > scratch, foot_scratch;
+
+    auto objective = [ & ]( const std::array< T, 4 >& point ) {
+      auto d = objective_function< Norm >( to_params( point ), prepared, scale, scratch );
+      return detail::penalized( d );
+    };
+
+    T value = objective( x );
+
+    const st num_threads = detail::thread_count( );
+
+    const st m      = axes.size( );
+    T        lambda = 1.0e-3;
+
+    st iteration = 0;
+    for ( ; iteration != max_iterations && !stop_requested && m != 0; iteration++ )
+    {
+      // Foot points of the current parameters
+      if constexpr ( Norm::geometric )
+      {
+        objective_function< geometric_norm >( to_params( x ), prepared, scale, foot_scratch );
+      }
+
+      // Normal equations of the reweighted residuals, accumulated per thread
+      std::vector< std::vector< T > > Hs( num_threads, std::vector< T >( m * m, 0.0 ) );
+      std::vector< std::vector< T > > gs( num_threads, std::vector< T >( m, 0.0 ) );
+
+      std::vector< std::thread > threads;
+      for ( st tid = 0; tid != num_threads; tid++ )
+      {
+        threads.push_back( std::thread( [ &, tid ]( ) {
+          std::array< number_t, 4 > theta;
+          for ( st k = 0; k != 4; k++ )
+          {
+            theta[ k ] = number_t( x[ k ] );
+          }
+          for ( st a = 0; a != m; a++ )
+          {
+            theta[ axes[ a ] ] = number_t::variable( x[ axes[ a ] ], a );
+          }
+
+          const number_t D = exp( theta[ 0 ] * T( 2.302585092994045684 ) );
+
+          auto& H = Hs[ tid ];
+          auto& g = gs[ tid ];
+
+          for ( auto i = tid; i < prepared.points.size( ); i += num_threads )
+          {
+            const auto& point = prepared.points[ i ];
+
+            const T Kmax = x[ 3 ] * ( 1.0 - Rs[ i ] );
+
+            // Natural log residual at DeltaK
+            auto log_residual = [ & ]( const T& DeltaK ) {
+              return log( evaluate< number_t >( D,
+                                                theta[ 1 ],
+                                                theta[ 2 ],
+                                                theta[ 3 ],
+                                                number_t( Rs[ i ] ),
+                                                number_t::variable( DeltaK, 4 ) ) )
+                     - point.log_dadN;
+            };
+
+            T DeltaK = point.DeltaK;
+
+            if constexpr ( Norm::geometric )
+            {
+              // The gradient is that of the distance at the exact foot points, but the solver's
+              // are only as exact as its tolerance. Gauss-Newton projections onto the tangent
+              // refine them.
+              DeltaK = foot_scratch.foot_points[ i ];
+
+              for ( int refinement = 0; refinement != 4; refinement++ )
+              {
+                if ( !( DeltaK > x[ 2 ] ) || !( DeltaK < Kmax ) )
+                {
+                  break;
+                }
+
+                const auto r     = log_residual( DeltaK );
+                const T    slope = scale * r.gradient[ 4 ] * DeltaK;
+                const T    moved = DeltaK
+                                * std::exp( -( std::log( DeltaK ) - point.log_DeltaK
+                                               + slope * scale * r.value )
+                                            / ( 1.0 + slope * slope ) );
+
+                if ( !( moved > x[ 2 ] ) || !( moved < Kmax ) )
+                {
+                  break;
+                }
+
+                DeltaK = moved;
+              }
+            }
+
+            if ( !( DeltaK > x[ 2 ] ) || !( DeltaK < Kmax ) )
+            {
+              continue;
+            }
+
+            number_t residual = log_residual( DeltaK ) * T( 0.43429448190325182 );
+
+            // Weight of the squared residual whose gradient is that of the loss
+            T weight = point.weight;
+            T cosine = 1.0;
+            if constexpr ( Norm::geometric )
+            {
+              const T slope = scale * residual.gradient[ 4 ] * DeltaK / T( 0.43429448190325182 );
+
+              residual *= scale;
+              cosine = 1.0 / ( 1.0 + slope * slope );
+            }
+            else if constexpr ( Norm::aggregation == aggregation_t::huber )
+            {
+              weight /= std::max( std::fabs( residual.value ), T( Norm::huber_delta ) );
+            }
+            else
+            {
+              weight /= std::max( std::fabs( residual.value ), T( 1.0e-9 ) );
+            }
+
+            if ( !std::isfinite( residual.value ) )
+            {
+              continue;
+            }
+
+            for ( st a = 0; a != m; a++ )
+            {
+              g[ a ] += weight * residual.value * residual.gradient[ a ];
+              for ( st b = 0; b != m; b++ )
+              {
+                H[ a * m + b ] += weight * cosine * residual.gradient[ a ] * residual.gradient[ b ];
+              }
+            }
+          }
+        } ) );
+      }
+
+      for ( auto& thread : threads )
+      {
+        thread.join( );
+      }
+
+      for ( st tid = 1; tid != num_threads; tid++ )
+      {
+        for ( st a = 0; a != m * m; a++ )
+        {
+          Hs[ 0 ][ a ] += Hs[ tid ][ a ];
+        }
+        for ( st a = 0; a != m; a++ )
+        {
+          gs[ 0 ][ a ] += gs[ tid ][ a ];
+        }
+      }
+
+      std::vector< st > free;
+      for ( st a = 0; a != m; a++ )
+      {
+        const auto k = axes[ a ];
+        if ( !( x[ k ] <= low[ k ] && gs[ 0 ][ a ] > 0 )
+             && !( x[ k ] >= high[ k ] && gs[ 0 ][ a ] < 0 ) )
+        {
+          free.push_back( a );
+        }
+      }
+
+      std::vector< T > H( free.size( ) * free.size( ) ), g( free.size( ) );
+      for ( st a = 0; a != free.size( ); a++ )
+      {
+        g[ a ] = gs[ 0 ][ free[ a ] ];
+        for ( st b = 0; b != free.size( ); b++ )
+        {
+          H[ a * free.size( ) + b ] = Hs[ 0 ][ free[ a ] * m + free[ b ] ];
+        }
+      }
+
+      // Damped until a step lowers the objective
+      bool             accepted = false;
+      T                previous = value;
+      std::vector< T > step;
+
+      for ( ; !accepted && !free.empty( ) && lambda < 1.0e10 && !stop_requested; )
+      {
+        if ( !damped_step( H, g, lambda, step ) )
+        {
+          lambda *= 10;
+          continue;
+        }
+
+        auto trial = x;
+        for ( st a = 0; a != free.size( ); a++ )
+        {
+          const auto k = axes[ free[ a ] ];
+          trial[ k ]   = std::clamp( x[ k ] + step[ a ], low[ k ], high[ k ] );
+        }
+
+        const T trial_value = objective( trial );
+
+        if ( trial_value < value )
+        {
+          accepted = true;
+          x        = trial;
+          value    = trial_value;
+          lambda   = std::max( lambda / 10, T( 1.0e-12 ) );
+
+          const auto params = to_params( x );
+          callback( params, params, params );
+        }
+        else
+        {
+          lambda *= 10;
+        }
+      }
+
+      progress_callback( iteration + 1, max_iterations );
+
+      if ( !accepted || previous - value <= T( 1.0e-12 ) * std::fabs( value ) )
+      {
+        iteration++;
+        break;
+      }
+    }
+
+    return to_params( x );
+  }
+}
+
+} // namespace detail
+
+// Local refinement of start, typically the incumbent of a coarse fit, by Levenberg-Marquardt in
+// ( log10 D, p, DeltaK_thr, A ) within the search box. Each iteration costs one Jacobian of the
+// residuals, by forward automatic differentiation, and a few objective evaluations. callback
+// receives each accepted step.
+template< class T, class Container_t >
+parameters< T > fit_levenberg_marquardt(
   parameters< T >     search_space_min,
   parameters< T >     search_space_max,
   Container_t         test_set,
-  const std::size_t   subdivisions  = 7,
-  const double&       amortization  = 1.02,
-  std::size_t         iterations    = 0,
-  bool                use_geometric = false,
-  callback_t< T >     callback      = []( parameters< T >, parameters< T >, parameters< T > ) {},
-  progress_callback_t progress_callback                        = []( std::size_t, std::size_t ) {},
-  const bool&         stop_requested                           = false,
-  std::function< void( parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
+  parameters< T >     start,
+  std::size_t         max_iterations,
+  norm_t              norm,
+  callback_t< T >     callback = []( parameters< T >, parameters< T >, parameters< T > ) {},
+  progress_callback_t progress_callback = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested    = false )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_levenberg_marquardt< decltype( norm_policy ) >( search_space_min,
+                                                                       search_space_max,
+                                                                       test_set,
+                                                                       start,
+                                                                       max_iterations,
+                                                                       callback,
+                                                                       progress_callback,
+                                                                       stop_requested );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+template< class T >
+using joint_callback_t = std::function< void( std::vector< parameters< T > > ) >;
+
+namespace detail
+{
+
+// Joint fit of the tests of test_set, the parameters common among them shared and the others fitted
+// per test. The mean and Huber aggregations of all the points are the means of those of the tests
+// weighted by their utilized weight. The trimmed and median ones are replaced by the weighted
+// means of the per test values. A grid over the shared axes is contracted around its incumbent as
+// in fit, and at each grid point the per test parameters are fitted by bounded Nelder-Mead from
+// their incumbents, the first round from the center of the box. These sub-problems are
+// independent, so all the grid points of a round times the tests are shared among the threads.
+// The cost grows with the grid over the shared axes only, not with a grid over all parameters of
+// all tests.
+template< class Norm, class T, class Container_t >
+std::vector< parameters< T > > fit_joint( const common_among_tests& common,
+                                          parameters< T >           search_space_min,
+                                          parameters< T >           search_space_max,
+                                          const Container_t&        test_set,
+                                          const std::size_t         subdivisions,
+                                          const double&             amortization,
+                                          std::size_t               iterations,
+                                          joint_callback_t< T >     callback,
+                                          progress_callback_t       progress_callback,
+                                          const bool&               stop_requested )
+{
+  using params_t = parameters< T >;
+  using point_t  = std::array< T, 4 >;
+  using st       = std::size_t;
+
+  const st num_tests = test_set.size( );
+
+  if ( num_tests == 0 )
+  {
+    throw std::runtime_error( "The test set is empty." );
+  }
+
+  auto replicate = [ num_tests ]( const params_t& params ) {
+    return std::vector< params_t >( num_tests, params );
+  };
+
+  if ( common.all_common( ) )
+  {
+    return replicate( fit< Norm, T >(
+      search_space_min,
+      search_space_max,
+      test_set,
+      subdivisions,
+      amortization,
+      iterations,
+      [ & ]( params_t params, params_t, params_t ) { callback( replicate( params ) ); },
+      progress_callback,
+      stop_requested,
+      []( params_t ) {},
+      cuhyso::sampler_t::grid,
+      0 ) );
+  }
+
+  // Contracted a hundredfold
+  if ( iterations == 0 )
+  {
+    iterations = std::max( 1.0, std::log( 100.0 ) / std::log( amortization ) );
+  }
+
+  const auto scale = detail::checked_scale< T >( test_set );
+
+  std::vector< prepared_test_set_t< T > > prepared;
+  std::vector< T >                        test_weights;
+  for ( const auto& test : test_set )
+  {
+    prepared.push_back(
+      prepare_test_set< T >( std::vector< typename Container_t::value_type > { test } ) );
+
+    T weight = 0.0;
+    for ( const auto& point : test.points )
+    {
+      weight += point.weight;
+    }
+    test_weights.push_back( weight );
+  }
+
+  auto to_array = []( const params_t& params ) {
+    return point_t { std::log10( params.D ), params.p, params.DeltaK_thr, params.A };
+  };
+
+  auto to_params = []( const point_t& x ) {
+    return params_t { std::pow( 10.0, x[ 0 ] ), x[ 1 ], x[ 2 ], x[ 3 ] };
+  };
+
+  const auto low  = to_array( search_space_min );
+  const auto high = to_array( search_space_max );
+
+  const std::array< bool, 4 > is_common { common.D, common.p, common.DeltaK_thr, common.A };
+
+  std::vector< st > shared, local;
+  for ( st k = 0; k != 4; k++ )
+  {
+    if ( std::fabs( high[ k ] - low[ k ] ) >= 1e-19 )
+    {
+      ( is_common[ k ] ? shared : local ).push_back( k );
+    }
+  }
+
+  // Utilization is preferred over minimization
+  auto is_better = []( const Model_Distance_t< T >& d, const Model_Distance_t< T >& best ) {
+    return d.utilization > best.utilization
+           || ( best.distance > d.distance && d.utilization >= best.utilization );
+  };
+
+  point_t center;
+  for ( st k = 0; k != 4; k++ )
+  {
+    center[ k ] = ( low[ k ] + high[ k ] ) / 2;
+  }
+
+  std::vector< point_t > incumbents( num_tests, center );
+  auto                   box_low  = low;
+  auto                   box_high = high;
+
+  const st num_threads = detail::thread_count( );
+
+  // Per thread and test, as the foot points of the scratches are bound to a test set
+  std::vector< std::vector< distance_scratch_t< T > > > scratches(
+    num_threads, std::vector< distance_scratch_t< T > >( num_tests ) );
+
+  // Fits the per test parameters at each of candidates, the shared ones taken from it. The
+  // solutions and distances are those of each candidate and test, test fastest.
+  auto solve = [ & ]( const std::vector< point_t >&        candidates,
+                      const T&                             initial_size,
+                      const st                             simplices,
+                      std::vector< point_t >&              solutions,
+                      std::vector< Model_Distance_t< T > >& distances ) {
+    const st num_tasks = candidates.size( ) * num_tests;
+
+    solutions.assign( num_tasks, point_t { } );
+    distances.assign( num_tasks, Model_Distance_t< T >( 0.0, 0.0 ) );
+
+    std::vector< std::thread > threads;
+    for ( st tid = 0; tid != std::min( num_threads, num_tasks ); tid++ )
+    {
+      threads.push_back( std::thread( [ &, tid ]( ) {
+        for ( auto task = tid; task < num_tasks && !stop_requested; task += num_threads )
+        {
+          const auto test = task % num_tests;
+
+          auto x = incumbents[ test ];
+          for ( auto k : shared )
+          {
+            x[ k ] = candidates[ task / num_tests ][ k ];
+          }
+
+          auto& scratch = scratches[ tid ][ test ];
+
+          auto evaluate = [ & ]( const point_t& point ) {
+            return objective_function< Norm >(
+              to_params( point ), prepared[ test ], scale, scratch );
+          };
+
+          if ( !local.empty( ) )
+          {
+            std::vector< T > x0, local_low, local_high;
+            for ( auto k : local )
+            {
+              x0.push_back( x[ k ] );
+              local_low.push_back( low[ k ] );
+              local_high.push_back( high[ k ] );
+            }
+
+            nelder_mead::simplex_options_t< T > options;
+            options.max_evaluations = 30 * ( local.size( ) + 1 ) * simplices;
+            options.size_threshold  = initial_size / 100;
+            options.initial_size    = initial_size;
+            options.simplices       = simplices;
+            options.num_threads     = 1;
+            options.seed            = unsigned( task + 1 );
+
+            const auto y = nelder_mead::minimize< T >(
+              [ & ]( const std::vector< T >& v, std::size_t ) {
+                auto point = x;
+                for ( st a = 0; a != local.size( ); a++ )
+                {
+                  point[ local[ a ] ] = v[ a ];
+                }
+                return detail::penalized( evaluate( point ) );
+              },
+              x0,
+              local_low,
+              local_high,
+              options,
+              []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+              []( std::size_t, std::size_t ) {},
+              stop_requested );
+
+            for ( st a = 0; a != local.size( ); a++ )
+            {
+              x[ local[ a ] ] = y[ a ];
+            }
+          }
+
+          solutions[ task ] = x;
+          distances[ task ] = evaluate( x );
+        }
+      } ) );
+    }
+
+    for ( auto& thread : threads )
+    {
+      thread.join( );
+    }
+  };
+
+  // Of the c-th candidate over all the tests
+  auto joint_distance = [ & ]( const std::vector< Model_Distance_t< T > >& distances, st c ) {
+    T sum = 0.0, utilized = 0.0, total = 0.0;
+    for ( st test = 0; test != num_tests; test++ )
+    {
+      const auto& d      = distances[ c * num_tests + test ];
+      const T     weight = T( d.utilization ) * test_weights[ test ];
+
+      sum += weight * d.distance;
+      utilized += weight;
+      total += test_weights[ test ];
+    }
+
+    return Model_Distance_t< T >( utilized > 0 ? sum / utilized : T( 1000000.0 ),
+                                  double( utilized / total ) );
+  };
+
+  auto report = [ & ]( ) {
+    std::vector< params_t > params;
+    for ( const auto& incumbent : incumbents )
+    {
+      params.push_back( to_params( incumbent ) );
+    }
+    callback( params );
+
+    return params;
+  };
+
+  Model_Distance_t< T > best( std::numeric_limits< T >::max( ), 0.0 );
+
+  std::vector< point_t >               solutions;
+  std::vector< Model_Distance_t< T > > distances;
+
+  T initial_size = 0.2;
+
+  for ( st t = 0; t != iterations && !stop_requested; t++ )
+  {
+    // The incumbent and the grid over the shared axes
+    std::vector< point_t > candidates( 1, incumbents[ 0 ] );
+    if ( !shared.empty( ) )
+    {
+      std::vector< point_t > grid( 1, incumbents[ 0 ] );
+      for ( auto k : shared )
+      {
+        std::vector< point_t > expanded;
+        for ( const auto& candidate : grid )
+        {
+          for ( st j = 0; j != subdivisions; j++ )
+          {
+            expanded.push_back( candidate );
+            expanded.back( )[ k ]
+              = cuhyso::sample_parameter( box_low[ k ], box_high[ k ], subdivisions, j );
+          }
+        }
+        grid = std::move( expanded );
+      }
+      candidates.insert( candidates.end( ), grid.begin( ), grid.end( ) );
+    }
+
+    // The first round starts from the center, so it restarts from random points too. The
+    // simplices shrink with the box.
+    solve( candidates, initial_size, t == 0 ? 4 : 1, solutions, distances );
+    initial_size = std::max( initial_size / T( amortization ), T( 1.0e-3 ) );
+
+    if ( stop_requested )
+    {
+      break;
+    }
+
+    st best_candidate = 0;
+    for ( st c = 0; c != candidates.size( ); c++ )
+    {
+      const auto d = joint_distance( distances, c );
+      if ( c == 0 || is_better( d, best ) )
+      {
+        best           = d;
+        best_candidate = c;
+      }
+    }
+
+    for ( st test = 0; test != num_tests; test++ )
+    {
+      incumbents[ test ] = solutions[ best_candidate * num_tests + test ];
+    }
+
+    for ( auto k : shared )
+    {
+      std::tie( box_low[ k ], box_high[ k ] ) = cuhyso::contract_range(
+        box_low[ k ], box_high[ k ], incumbents[ 0 ][ k ], T( amortization ) );
+    }
+
+    report( );
+
+    progress_callback( t + 1, iterations );
+  }
+
+  // The grid resolves the shared parameters to its spacing only. Nelder-Mead over them refines
+  // them within the last box, each of its points solving the tests in parallel.
+  if ( !shared.empty( ) && !stop_requested )
+  {
+    std::vector< T > x0, shared_low, shared_high;
+    for ( auto k : shared )
+    {
+      x0.push_back( incumbents[ 0 ][ k ] );
+      shared_low.push_back( box_low[ k ] );
+      shared_high.push_back( box_high[ k ] );
+    }
+
+    nelder_mead::simplex_options_t< T > options;
+    options.max_evaluations = 50 * ( shared.size( ) + 1 );
+    options.size_threshold  = 1e-4;
+    options.initial_size    = 0.25;
+    options.num_threads     = 1;
+
+    nelder_mead::minimize< T >(
+      [ & ]( const std::vector< T >& v, std::size_t ) {
+        auto candidate = incumbents[ 0 ];
+        for ( st a = 0; a != shared.size( ); a++ )
+        {
+          candidate[ shared[ a ] ] = v[ a ];
+        }
+
+        solve( { candidate }, initial_size, 1, solutions, distances );
+
+        const auto d = joint_distance( distances, 0 );
+        if ( !stop_requested && is_better( d, best ) )
+        {
+          best = d;
+          for ( st test = 0; test != num_tests; test++ )
+          {
+            incumbents[ test ] = solutions[ test ];
+          }
+          report( );
+        }
+
+        return detail::penalized( d );
+      },
+      x0,
+      shared_low,
+      shared_high,
+      options,
+      []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+      []( std::size_t, std::size_t ) {},
+      stop_requested );
+  }
+
+  return report( );
+}
+
+} // namespace detail
+
+// Fits one set of parameters per test of test_set, those marked in common being the same for all
+// tests. The result is in the order of test_set. callback receives the incumbents of each round.
+template< class T, class Container_t >
+std::vector< parameters< T > > fit_joint(
+  const common_among_tests& common,
+  parameters< T >           search_space_min,
+  parameters< T >           search_space_max,
+  Container_t               test_set,
+  const std::size_t         subdivisions      = 7,
+  const double&             amortization      = 1.2,
+  std::size_t               iterations        = 0,
+  norm_t                    norm              = norm_t::ordinary,
+  joint_callback_t< T >     callback          = []( std::vector< parameters< T > > ) {},
+  progress_callback_t       progress_callback = []( std::size_t, std::size_t ) {},
+  const bool&               stop_requested    = false )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit_joint< decltype( norm_policy ), T >( common,
+                                                           search_space_min,
+                                                           search_space_max,
+                                                           test_set,
+                                                           subdivisions,
+                                                           amortization,
+                                                           iterations,
+                                                           callback,
+                                                           progress_callback,
+                                                           stop_requested );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// What a bootstrap replicate resamples with replacement: the points of each test, each test keeping
+// its number of points, or whole tests
+enum class resampling_t
+{
+  points,
+  tests
+};
+
+// Bootstrap of the fitted parameters from the replicates completed so far. lower and upper are the
+// percentile interval of each parameter. correlation is that of ( log10 D, p, DeltaK_thr, A ),
+// zero for parameters that do not vary. at_bound counts the replicates that ended on the boundary
+// of their search box, which is then too small for the interval.
+template< class T >
+struct bootstrap_t
+{
+  std::size_t replicates = 0;
+  std::size_t at_bound   = 0;
+
+  parameters< T > estimate;
+  parameters< T > lower;
+  parameters< T > upper;
+
+  std::array< std::array< T, 4 >, 4 > correlation { };
+};
+
+template< class T >
+using bootstrap_callback_t = std::function< void( bootstrap_t< T > ) >;
+
+namespace detail
+{
+
+// Refits every replicate by bounded Nelder-Mead from estimate, within a box of box_fraction the
+// width of the search box centered on it, D in the log10 space. The replicates carry the number
+// of times each point is drawn as its weight, so a replicate is prepared without copying the
+// points drawn repeatedly. They are refitted on all threads, each seeded from seed and its index
+// so that the result does not depend on the order they complete in.
+template< class Norm, class T, class Container_t >
+bootstrap_t< T > bootstrap( parameters< T >           search_space_min,
+                            parameters< T >           search_space_max,
+                            const Container_t&        test_set,
+                            parameters< T >           estimate,
+                            std::size_t               replicates,
+                            resampling_t              resampling,
+                            const double&             confidence,
+                            const double&             box_fraction,
+                            bootstrap_callback_t< T > callback,
+                            progress_callback_t       progress_callback,
+                            const bool&               stop_requested,
+                            unsigned                  seed )
+{
+  using params_t = parameters< T >;
+  using point_t  = std::array< T, 4 >;
+  using st       = std::size_t;
+
+  if ( test_set.empty( ) )
+  {
+    throw std::runtime_error( "The test set is empty." );
+  }
+
+  for ( const auto& test : test_set )
+  {
+    if ( test.points.empty( ) )
+    {
+      throw std::runtime_error( "Every test of the bootstrap needs at least one point." );
+    }
+  }
+
+  if ( resampling == resampling_t::tests && test_set.size( ) < 2 )
+  {
+    throw std::runtime_error( "Resampling the tests needs two tests or more." );
+  }
+
+  const auto scale = detail::checked_scale< T >( test_set );
+
+  auto to_array = []( const params_t& params ) {
+    return point_t { std::log10( params.D ), params.p, params.DeltaK_thr, params.A };
+  };
+
+  auto to_params = []( const point_t& x ) {
+    return params_t { std::pow( 10.0, x[ 0 ] ), x[ 1 ], x[ 2 ], x[ 3 ] };
+  };
+
+  const auto low    = to_array( search_space_min );
+  const auto high   = to_array( search_space_max );
+  const auto center = to_array( estimate );
+
+  std::vector< st > axes;
+  std::vector< T >  x0, box_low, box_high;
+  for ( st k = 0; k != 4; k++ )
+  {
+    const T width = high[ k ] - low[ k ];
+    if ( std::fabs( width ) >= 1e-19 )
+    {
+      axes.push_back( k );
+      x0.push_back( std::clamp( center[ k ], low[ k ], high[ k ] ) );
+      box_low.push_back( std::max( low[ k ], x0.back( ) - T( box_fraction ) * width / 2 ) );
+      box_high.push_back( std::min( high[ k ], x0.back( ) + T( box_fraction ) * width / 2 ) );
+    }
+  }
+
+  if ( axes.empty( ) )
+  {
+    throw std::runtime_error( "The search box is empty." );
+  }
+
+  bootstrap_t< T > result;
+  result.estimate = estimate;
+
+  // Sorted samples of every parameter, and the sums of the deviations from the estimate and of
+  // their products
+  std::array< std::vector< T >, 4 >   sorted;
+  point_t                             sums { };
+  std::array< std::array< T, 4 >, 4 > products { };
+
+  std::mutex results_mutex;
+
+  auto summarize = [ & ]( ) {
+    auto quantile = [ & ]( const std::vector< T >& values, const double& q ) {
+      const T  position = q * ( values.size( ) - 1 );
+      const st i        = std::min( st( position ), values.size( ) - 1 );
+      const st j        = std::min( i + 1, values.size( ) - 1 );
+
+      return values[ i ] + ( position - i ) * ( values[ j ] - values[ i ] );
+    };
+
+    point_t lower, upper;
+    for ( st k = 0; k != 4; k++ )
+    {
+      lower[ k ] = quantile( sorted[ k ], ( 1.0 - confidence ) / 2.0 );
+      upper[ k ] = quantile( sorted[ k ], ( 1.0 + confidence ) / 2.0 );
+    }
+    result.lower = to_params( lower );
+    result.upper = to_params( upper );
+
+    const T n = result.replicates;
+    for ( st a = 0; a != 4; a++ )
+    {
+      for ( st b = 0; b != 4; b++ )
+      {
+        const T covariance = products[ a ][ b ] / n - sums[ a ] * sums[ b ] / ( n * n );
+        const T variances  = ( products[ a ][ a ] / n - sums[ a ] * sums[ a ] / ( n * n ) )
+                            * ( products[ b ][ b ] / n - sums[ b ] * sums[ b ] / ( n * n ) );
+
+        result.correlation[ a ][ b ] = variances > 0 ? covariance / std::sqrt( variances ) : 0.0;
+      }
+    }
+  };
+
+  std::atomic< st > next { 0 };
+
+  const st num_threads = detail::thread_count( );
+
+  std::vector< std::thread > threads;
+  for ( st tid = 0; tid != std::min( num_threads, replicates ); tid++ )
+  {
+    threads.push_back( std::thread( [ & ]( ) {
+      distance_scratch_t< T > scratch;
+
+      for ( st r = next++; r < replicates && !stop_requested; r = next++ )
+      {
+        std::seed_seq seeds { seed, unsigned( r ) };
+        std::mt19937  random( seeds );
+
+        auto replicate = test_set;
+
+        if ( resampling == resampling_t::points )
+        {
+          for ( auto& test : replicate )
+          {
+            std::vector< st > counts( test.points.size( ), 0 );
+            std::uniform_int_distribution< st > draw( 0, test.points.size( ) - 1 );
+            for ( st i = 0; i != test.points.size( ); i++ )
+            {
+              counts[ draw( random ) ]++;
+            }
+
+            auto points = std::move( test.points );
+            test.points.clear( );
+            for ( st i = 0; i != points.size( ); i++ )
+            {
+              if ( counts[ i ] != 0 )
+              {
+                points[ i ].weight *= counts[ i ];
+                test.points.push_back( points[ i ] );
+              }
+            }
+          }
+        }
+        else
+        {
+          std::vector< st > counts( test_set.size( ), 0 );
+          std::uniform_int_distribution< st > draw( 0, test_set.size( ) - 1 );
+          for ( st i = 0; i != test_set.size( ); i++ )
+          {
+            counts[ draw( random ) ]++;
+          }
+
+          replicate.clear( );
+          for ( st i = 0; i != test_set.size( ); i++ )
+          {
+            if ( counts[ i ] != 0 )
+            {
+              replicate.push_back( test_set[ i ] );
+              for ( auto& point : replicate.back( ).points )
+              {
+                point.weight *= counts[ i ];
+              }
+            }
+          }
+        }
+
+        const auto prepared = prepare_test_set< T >( replicate );
+
+        // The foot points of the previous replicate are of other points
+        scratch.foot_points.clear( );
+
+        nelder_mead::simplex_options_t< T > options;
+        options.max_evaluations = 200 * ( axes.size( ) + 1 );
+        options.size_threshold  = 1e-6;
+        options.initial_size    = 0.1;
+        options.num_threads     = 1;
+
+        const auto y = nelder_mead::minimize< T >(
+          [ & ]( const std::vector< T >& v, std::size_t ) {
+            auto x = center;
+            for ( st a = 0; a != axes.size( ); a++ )
+            {
+              x[ axes[ a ] ] = v[ a ];
+            }
+            return detail::penalized(
+              objective_function< Norm >( to_params( x ), prepared, scale, scratch ) );
+          },
+          x0,
+          box_low,
+          box_high,
+          options,
+          []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+          []( std::size_t, std::size_t ) {},
+          stop_requested );
+
+        if ( stop_requested )
+        {
+          break;
+        }
+
+        auto x        = center;
+        bool at_bound = false;
+        for ( st a = 0; a != axes.size( ); a++ )
+        {
+          const auto k      = axes[ a ];
+          const T    margin = T( 1e-6 ) * ( box_high[ a ] - box_low[ a ] );
+
+          x[ k ] = y[ a ];
+          at_bound |= ( y[ a ] <= box_low[ a ] + margin && box_low[ a ] > low[ k ] )
+                      || ( y[ a ] >= box_high[ a ] - margin && box_high[ a ] < high[ k ] );
+        }
+
+        std::lock_guard< std::mutex > lock( results_mutex );
+
+        for ( st a = 0; a != 4; a++ )
+        {
+          sorted[ a ].insert( std::upper_bound( sorted[ a ].begin( ), sorted[ a ].end( ), x[ a ] ),
+                              x[ a ] );
+
+          sums[ a ] += x[ a ] - center[ a ];
+          for ( st b = 0; b != 4; b++ )
+          {
+            products[ a ][ b ] += ( x[ a ] - center[ a ] ) * ( x[ b ] - center[ b ] );
+          }
+        }
+
+        result.replicates++;
+        result.at_bound += at_bound;
+
+        summarize( );
+
+        callback( result );
+        progress_callback( result.replicates, replicates );
+      }
+    } ) );
+  }
+
+  for ( auto& thread : threads )
+  {
+    thread.join( );
+  }
+
+  return result;
+}
+
+} // namespace detail
+
+// Percentile intervals and correlations of the parameters fitted at estimate, by refitting
+// replicates of test_set resampled with replacement. callback receives the summary as every
+// replicate completes.
+template< class T, class Container_t >
+bootstrap_t< T > bootstrap(
+  parameters< T >           search_space_min,
+  parameters< T >           search_space_max,
+  Container_t               test_set,
+  parameters< T >           estimate,
+  std::size_t               replicates        = 1000,
+  resampling_t              resampling        = resampling_t::points,
+  norm_t                    norm              = norm_t::ordinary,
+  const double&             confidence        = 0.95,
+  const double&             box_fraction      = 0.25,
+  bootstrap_callback_t< T > callback          = []( bootstrap_t< T > ) {},
+  progress_callback_t       progress_callback = []( std::size_t, std::size_t ) {},
+  const bool&               stop_requested    = false,
+  unsigned                  seed              = 1 )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::bootstrap< decltype( norm_policy ), T >( search_space_min,
+                                                           search_space_max,
+                                                           test_set,
+                                                           estimate,
+                                                           replicates,
+                                                           resampling,
+                                                           confidence,
+                                                           box_fraction,
+                                                           callback,
+                                                           progress_callback,
+                                                           stop_requested,
+                                                           seed );
+  };
+
+  return dispatch_norm( norm, run );
+}
+
+// Covariance of the fitted parameters in ( log10 D, p, DeltaK_thr, A ) from the linearization of
+// the log10 da/dN residuals at the estimate. Parameters held fixed, on a bound of the search box or
+// not identified by the data have zero rows and columns and are not identified.
+// residual_variance is that of the residuals over the degrees of freedom.
+template< class T >
+struct covariance_t
+{
+  std::array< std::array< T, 4 >, 4 > matrix { };
+  std::array< bool, 4 >               identified { };
+
+  T           residual_variance  = 0.0;
+  std::size_t degrees_of_freedom = 0;
+};
+
+// The covariance of the parameters is the residual variance times the inverse of J^T W J, J the
+// Jacobian of the log10 residuals of the points within the domain of the model, by evaluate
+// instantiated with dual numbers, accumulated by the points on all threads. Whichever norm the fit
+// minimized, the residuals are the ordinary ones. A parameter whose column of J^T W J, scaled to a
+// unit diagonal, depends on those before it to a relative 1e-10 is not identified. A is known only
+// from the few points near the asymptote, where the model is far from linear in it, and its
+// variance is only good to a factor of several. Prefer the intervals of bootstrap for A.
+template< class T, class Container_t >
+covariance_t< T > covariance( parameters< T >    search_space_min,
+                              parameters< T >    search_space_max,
+                              const Container_t& test_set,
+                              parameters< T >    estimate )
 {
-  using params_t = parameters< T >;
+  using st       = std::size_t;
+  using number_t = dual::dual_t< T, 4 >;
+
+  const std::array< T, 4 > low {
+    std::log10( search_space_min.D ), search_space_min.p, search_space_min.DeltaK_thr,
+    search_space_min.A };
+  const std::array< T, 4 > high {
+    std::log10( search_space_max.D ), search_space_max.p, search_space_max.DeltaK_thr,
+    search_space_max.A };
+  const std::array< T, 4 > x {
+    std::log10( estimate.D ), estimate.p, estimate.DeltaK_thr, estimate.A };
+
+  std::vector< st > axes;
+  for ( st k = 0; k != 4; k++ )
+  {
+    const T margin = T( 1e-9 ) * ( std::fabs( high[ k ] - low[ k ] ) + std::fabs( x[ k ] ) );
+    if ( std::fabs( high[ k ] - low[ k ] ) >= 1e-19 && x[ k ] > low[ k ] + margin
+         && x[ k ] < high[ k ] - margin )
+    {
+      axes.push_back( k );
+    }
+  }
 
-  auto contract_range
-    = []( const T& lower, const T& upper, const T& new_center, const T& amortization ) {
-        auto dif    = upper - lower;
-        auto newdif = dif / amortization;
+  const auto prepared = prepare_test_set< T >( test_set );
 
-        auto new_lower = new_center - newdif / 2;
-        auto new_upper = new_center + newdif / 2;
+  std::vector< T > Rs( prepared.points.size( ) );
+  for ( const auto& block : prepared.blocks )
+  {
+    std::fill( Rs.begin( ) + block.begin, Rs.begin( ) + block.end, block.R );
+  }
 
-        if ( new_upper > upper )
+  const st m = axes.size( );
+
+  const st num_threads = detail::thread_count( );
+
+  // Per thread J^T W J, sum of the weighted squared residuals and sum of the weights
+  std::vector< std::vector< T > > Hs( num_threads, std::vector< T >( m * m, 0.0 ) );
+  std::vector< T >                squares( num_threads, 0.0 ), weights( num_threads, 0.0 );
+
+  std::vector< std::thread > threads;
+  for ( st tid = 0; tid != num_threads; tid++ )
+  {
+    threads.push_back( std::thread( [ &, tid ]( ) {
+      std::array< number_t, 4 > theta;
+      for ( st k = 0; k != 4; k++ )
+      {
+        theta[ k ] = number_t( x[ k ] );
+      }
+      for ( st a = 0; a != m; a++ )
+      {
+        theta[ axes[ a ] ] = number_t::variable( x[ axes[ a ] ], a );
+      }
+
+      const number_t D = exp( theta[ 0 ] * T( 2.302585092994045684 ) );
+
+      for ( auto i = tid; i < prepared.points.size( ); i += num_threads )
+      {
+        const auto& point = prepared.points[ i ];
+
+        if ( !( point.DeltaK > x[ 2 ] ) || !( point.DeltaK < x[ 3 ] * ( 1.0 - Rs[ i ] ) ) )
         {
-          new_upper = upper;
-          new_lower = new_upper - newdif;
+          continue;
         }
-        else if ( new_lower < lower )
+
+        const number_t residual
+          = ( log( evaluate< number_t >( D,
+                                         theta[ 1 ],
+                                         theta[ 2 ],
+                                         theta[ 3 ],
+                                         number_t( Rs[ i ] ),
+                                         number_t( point.DeltaK ) ) )
+              - point.log_dadN )
+            * T( 0.43429448190325182 );
+
+        if ( !isfinite( residual ) )
         {
-          new_lower = lower;
-          new_upper = new_lower + newdif;
+          continue;
         }
 
-        return std::make_tuple( new_lower, new_upper );
-      };
+        squares[ tid ] += point.weight * residual.value * residual.value;
+        weights[ tid ] += point.weight;
 
-  using st = std::size_t;
+        for ( st a = 0; a != m; a++ )
+        {
+          for ( st b = 0; b != m; b++ )
+          {
+            Hs[ tid ][ a * m + b ]
+              += point.weight * residual.gradient[ a ] * residual.gradient[ b ];
+          }
+        }
+      }
+    } ) );
+  }
 
-  auto objective_min = std::numeric_limits< T >::max( );
-  auto params_at_min = params_t { 0.0, 0.0, 0.0, 0.0 };
+  for ( auto& thread : threads )
+  {
+    thread.join( );
+  }
 
-  if ( iterations == 0 )
+  for ( st tid = 1; tid != num_threads; tid++ )
   {
-    iterations = std::log( 4000.0 ) / std::log( amortization );
+    for ( st a = 0; a != m * m; a++ )
+    {
+      Hs[ 0 ][ a ] += Hs[ tid ][ a ];
+    }
+    squares[ 0 ] += squares[ tid ];
+    weights[ 0 ] += weights[ tid ];
   }
 
-  auto subd = subdivisions;
+  const auto& H = Hs[ 0 ];
 
-  auto subdD = subd;
-  if ( std::fabs( search_space_max.D - search_space_min.D ) < 1e-19 )
+  // Cholesky factorization of the scaled matrix, skipping the dependent columns
+  std::vector< st > identified;
   {
-    subdD = 1;
-  }
+    std::vector< T > L( m * m, 0.0 );
+    for ( st a = 0; a != m; a++ )
+    {
+      if ( !( H[ a * m + a ] > 0 ) )
+      {
+        continue;
+      }
 
-  st num_threads = std::max( ( unsigned int )( 4 ), std::thread::hardware_concurrency( ) );
-  num_threads    = std::min( num_threads, subdD );
+      auto scaled = [ & ]( st i, st j ) {
+        return H[ i * m + j ] / std::sqrt( H[ i * m + i ] * H[ j * m + j ] );
+      };
 
-  std::cout << "Num threads: " << num_threads << std::endl;
+      T pivot = 1.0;
+      for ( auto b : identified )
+      {
+        pivot -= L[ a * m + b ] * L[ a * m + b ];
+      }
 
-  std::vector< double >   max_utilization_mins( num_threads, 0.0 );
-  std::vector< T >        objective_mins( num_threads );
-  std::vector< params_t > params_mins( num_threads );
+      if ( !( pivot > T( 1e-10 ) ) )
+      {
+        continue;
+      }
 
-  for ( st i = 0; i != num_threads; i++ )
-  {
-    objective_mins[ i ] = std::numeric_limits< T >::max( );
-    params_mins[ i ]    = params_t { 0.0, 0.0, 0.0, 0.0 };
+      L[ a * m + a ] = std::sqrt( pivot );
+      for ( st c = a + 1; c != m; c++ )
+      {
+        T sum = scaled( c, a );
+        for ( auto b : identified )
+        {
+          sum -= L[ c * m + b ] * L[ a * m + b ];
+        }
+        L[ c * m + a ] = sum / L[ a * m + a ];
+      }
+
+      identified.push_back( a );
+    }
   }
 
-  auto scale = crack_growth::computeAxesScale< T >( test_set );
+  covariance_t< T > result;
 
-  if ( scale < 1.0e-10 || scale > 1.0e10 )
+  const T  n = weights[ 0 ];
+  const st q = identified.size( );
+  if ( n > T( q ) )
   {
-    throw std::runtime_error( "Test data relative scales vary orders of magnitude." );
+    result.degrees_of_freedom = st( std::floor( n ) ) - q;
+    result.residual_variance  = squares[ 0 ] / ( n - T( q ) );
   }
 
-  for ( st t = 0; t != iterations && !stop_requested; t++ )
+  std::vector< T > reduced( q * q );
+  for ( st a = 0; a != q; a++ )
   {
-    std::vector< std::thread > threads;
+    for ( st b = 0; b != q; b++ )
+    {
+      reduced[ a * q + b ] = H[ identified[ a ] * m + identified[ b ] ];
+    }
+  }
 
-    auto D_index_span = std::floor( ( subdD ) / num_threads );
+  for ( st b = 0; b != q; b++ )
+  {
+    std::vector< T > unit( q, 0.0 ), column;
+    unit[ b ] = -1.0;
 
-    for ( st tid = 0; tid != num_threads; tid++ )
+    if ( detail::damped_step( reduced, unit, T( 0.0 ), column ) )
     {
-      threads.push_back( std::thread( [ per_thread_callback,
-                                        D_index_span,
-                                        subd,
-                                        subdD,
-                                        tid,
-                                        num_threads,
-                                        stop_requested,
-                                        search_space_min,
-                                        search_space_max,
-                                        use_geometric,
-                                        &max_utilization_mins,
-                                        &objective_mins,
-                                        &params_mins,
-                                        subdivisions,
-                                        &test_set,
-                                        scale ]( ) {
-        auto start  = D_index_span * tid;
-        auto finish = ( tid == num_threads - 1 ) ? subdD : start + D_index_span;
+      for ( st a = 0; a != q; a++ )
+      {
+        result.matrix[ axes[ identified[ a ] ] ][ axes[ identified[ b ] ] ]
+          = result.residual_variance * column[ a ];
+      }
+      result.identified[ axes[ identified[ b ] ] ] = true;
+    }
+  }
 
-        for ( auto dj = start; dj != finish && !stop_requested; dj++ )
-        {
-          params_t obj_params;
+  return result;
+}
 
-          // Span of D in the log10 space.
-          auto low = search_space_min.D;
-          auto hi  = search_space_max.D;
+// Pointwise band of sigmas standard deviations of log10 da/dN about the curve of params at R, by
+// the delta method. The prediction band includes the residual variance, the confidence band of
+// the curve does not.
+template< class T, class Container_t >
+std::tuple< Container_t, Container_t > prediction_band( const parameters< T >&   params,
+                                                        const covariance_t< T >& covariance,
+                                                        const T&                 R,
+                                                        const Container_t&       DeltaKs,
+                                                        const T&                 sigmas = 2.0,
+                                                        bool prediction = true )
+{
+  using number_t = dual::dual_t< T, 4 >;
 
-          auto lowl = std::log10( low );
-          auto hil  = std::log10( hi );
+  const number_t D
+    = exp( number_t::variable( std::log10( params.D ), 0 ) * T( 2.302585092994045684 ) );
+  const number_t p          = number_t::variable( params.p, 1 );
+  const number_t DeltaK_thr = number_t::variable( params.DeltaK_thr, 2 );
+  const number_t A          = number_t::variable( params.A, 3 );
 
-          auto dl      = cuhyso::sample_parameter( lowl, hil, subdD, dj );
-          obj_params.D = std::pow( 10.0, dl );
+  Container_t lower, upper;
+  for ( const auto& DeltaK : DeltaKs )
+  {
+    const number_t log_dadN
+      = log( evaluate< number_t >( D, p, DeltaK_thr, A, number_t( R ), number_t( DeltaK ) ) )
+        * T( 0.43429448190325182 );
 
-          auto subdp = subd;
-          if ( std::fabs( search_space_max.p - search_space_min.p ) < 1e-19 )
-          {
-            subdp = 1;
-          }
+    T variance = prediction ? covariance.residual_variance : T( 0.0 );
+    for ( std::size_t a = 0; a != 4; a++ )
+    {
+      for ( std::size_t b = 0; b != 4; b++ )
+      {
+        variance += log_dadN.gradient[ a ] * covariance.matrix[ a ][ b ] * log_dadN.gradient[ b ];
+      }
+    }
 
-          for ( st pj = 0; pj != subdp && !stop_requested; pj++ )
-          {
-            auto low = search_space_min.p;
-            auto hi  = search_space_max.p;
+    const T deviation = sigmas * std::sqrt( std::max( variance, T( 0.0 ) ) );
 
-            obj_params.p = cuhyso::sample_parameter( low, hi, subd, pj );
+    lower.push_back( std::pow( T( 10.0 ), log_dadN.value - deviation ) );
+    upper.push_back( std::pow( T( 10.0 ), log_dadN.value + deviation ) );
+  }
 
-            auto subdDeltaKj = subd;
-            if ( std::fabs( search_space_max.DeltaK_thr - search_space_min.DeltaK_thr ) < 1e-19 )
-            {
-              subdDeltaKj = 1;
-            }
+  return std::make_tuple( lower, upper );
+}
 
-            for ( st DeltaKj = 0; DeltaKj != subdDeltaKj && !stop_requested; DeltaKj++ )
-            {
-              auto low = search_space_min.DeltaK_thr;
-              auto hi  = search_space_max.DeltaK_thr;
+// Profile of one parameter of a fit: the penalized objective with the parameter held at each of
+// values, D not in log10, and the others refitted. deviances are 2 n log( distance / minimum ), n
+// the weight of the points and the minimum that of all the profiles, which for the ordinary norm is
+// the deviance of the likelihood of residuals with a Laplace distribution of unknown scale, and for
+// the others a pseudo-likelihood. lower and upper bound the values whose deviance is within
+// threshold, the chi-squared quantile of confidence, and are open when the scan ends first.
+template< class T >
+struct profile_t
+{
+  std::vector< T >               values;
+  std::vector< T >               distances;
+  std::vector< T >               deviances;
+  std::vector< parameters< T > > estimates;
+
+  T    threshold  = 0.0;
+  T    lower      = 0.0;
+  T    upper      = 0.0;
+  bool lower_open = true;
+  bool upper_open = true;
+};
 
-              obj_params.DeltaK_thr = cuhyso::sample_parameter( low, hi, subd, DeltaKj );
+template< class T >
+using profile_callback_t = std::function< void( std::array< profile_t< T >, 4 > ) >;
 
-              auto subdA = subd;
-              if ( std::fabs( search_space_max.A - search_space_min.A ) < 1e-19 )
-              {
-                subdA = 1;
-              }
+namespace detail
+{
 
-              for ( st Aj = 0; Aj != subdA && !stop_requested; Aj++ )
-              {
-                auto low = search_space_min.A;
-                auto hi  = search_space_max.A;
+// Scans every parameter of non-zero width over points values evenly spaced within box_fraction the
+// width of the search box centered on estimate, D in the log10 space. The values on either side of
+// the estimate form a chain walking away from it, each refitted by bounded Nelder-Mead from the
+// solution of the value before it. The values of a chain are then sequential, and the up to eight
+// chains run on all threads.
+template< class Norm, class T, class Container_t >
+std::array< profile_t< T >, 4 > profile( parameters< T >         search_space_min,
+                                         parameters< T >         search_space_max,
+                                         const Container_t&      test_set,
+                                         parameters< T >         estimate,
+                                         std::size_t             points,
+                                         const double&           confidence,
+                                         const double&           box_fraction,
+                                         profile_callback_t< T > callback,
+                                         progress_callback_t     progress_callback,
+                                         const bool&             stop_requested )
+{
+  using params_t = parameters< T >;
+  using point_t  = std::array< T, 4 >;
+  using st       = std::size_t;
+
+  if ( points < 2 )
+  {
+    throw std::runtime_error( "A profile needs two points or more." );
+  }
 
-                obj_params.A = cuhyso::sample_parameter( low, hi, subd, Aj );
+  const auto scale = detail::checked_scale< T >( test_set );
 
-                per_thread_callback( obj_params );
+  auto to_array = []( const params_t& params ) {
+    return point_t { std::log10( params.D ), params.p, params.DeltaK_thr, params.A };
+  };
 
-                // auto d = objective_function( obj_params, use_geometric, test_set );
+  auto to_params = []( const point_t& x ) {
+    return params_t { std::pow( 10.0, x[ 0 ] ), x[ 1 ], x[ 2 ], x[ 3 ] };
+  };
 
-                auto d = objective_function( obj_params, use_geometric, test_set, scale );
-                totalevals++;
-                if ( d.utilization > max_utilization_mins[ tid ]
-                     || // prefer utilization over minimization
-                     ( objective_mins[ tid ] > d.distance
-                       && d.utilization >= max_utilization_mins[ tid ] ) )
-                {
-                  objective_mins[ tid ]       = d.distance;
-                  params_mins[ tid ]          = obj_params;
-                  max_utilization_mins[ tid ] = d.utilization;
-                }
-              }
-            }
-          }
-        }
-      } ) );
-    }
+  const auto low  = to_array( search_space_min );
+  const auto high = to_array( search_space_max );
 
-    for ( st tid = 0; tid != num_threads; tid++ )
+  auto center = to_array( estimate );
+
+  // The values of every parameter, ascending and including the estimate
+  std::vector< st >                 axes;
+  std::array< std::vector< T >, 4 > values;
+  std::array< st, 4 >               at_estimate { };
+  for ( st k = 0; k != 4; k++ )
+  {
+    const T width = high[ k ] - low[ k ];
+    if ( std::fabs( width ) < 1e-19 )
     {
-      threads[ tid ].join( );
+      continue;
     }
 
-    double max_utlization_at_min = 0;
+    center[ k ] = std::clamp( center[ k ], low[ k ], high[ k ] );
 
-    for ( st tid = 0; tid != num_threads; tid++ )
-    {
-      if ( max_utilization_mins[ tid ] > max_utlization_at_min
-           || ( objective_min > objective_mins[ tid ]
-                && max_utilization_mins[ tid ] >= max_utlization_at_min ) )
-      {
+    const T from = std::max( low[ k ], center[ k ] - T( box_fraction ) * width / 2 );
+    const T to   = std::min( high[ k ], center[ k ] + T( box_fraction ) * width / 2 );
 
-        objective_min         = objective_mins[ tid ];
-        params_at_min         = params_mins[ tid ];
-        max_utlization_at_min = max_utilization_mins[ tid ];
-      }
+    for ( st j = 0; j != points; j++ )
+    {
+      values[ k ].push_back( from + ( to - from ) * T( j ) / T( points - 1 ) );
     }
 
-    for ( st tid = 0; tid != num_threads; tid++ )
+    auto position    = std::lower_bound( values[ k ].begin( ), values[ k ].end( ), center[ k ] );
+    at_estimate[ k ] = position - values[ k ].begin( );
+    if ( position == values[ k ].end( ) || *position != center[ k ] )
     {
-      objective_mins[ tid ]       = objective_min;
-      params_mins[ tid ]          = params_at_min;
-      max_utilization_mins[ tid ] = max_utlization_at_min;
+      values[ k ].insert( position, center[ k ] );
     }
 
-    // std::cout << "Max util: " << max_utlization_at_min << std::endl;
+    axes.push_back( k );
+  }
 
-    callback( params_at_min, search_space_min, search_space_max );
+  if ( axes.empty( ) )
+  {
+    throw std::runtime_error( "The search box is empty." );
+  }
 
-    const T a = amortization;
+  // Chains from the estimate down and up
+  std::vector< std::tuple< st, bool > > chains;
+  for ( auto k : axes )
+  {
+    if ( at_estimate[ k ] != 0 )
+    {
+      chains.push_back( { k, false } );
+    }
+    if ( at_estimate[ k ] + 1 != values[ k ].size( ) )
+    {
+      chains.push_back( { k, true } );
+    }
+  }
 
-    T Dlmin                  = 0;
-    T Dlmax                  = 0;
-    std::tie( Dlmin, Dlmax ) = contract_range( std::log10( search_space_min.D ),
-                                               std::log10( search_space_max.D ),
-                                               std::log10( params_at_min.D ),
-                                               a );
+  const auto prepared = prepare_test_set< T >( test_set );
 
-    search_space_min.D = std::pow( 10.0, Dlmin );
-    search_space_max.D = std::pow( 10.0, Dlmax );
+  T weight = 0.0;
+  for ( const auto& point : prepared.points )
+  {
+    weight += point.weight;
+  }
 
-    std::tie( search_space_min.p, search_space_max.p )
-      = contract_range( search_space_min.p, search_space_max.p, params_at_min.p, a );
+  // Quantile of chi-squared with one degree of freedom, the square of that of the normal
+  // distribution at ( 1 + confidence ) / 2, by bisection
+  T threshold = 0.0;
+  {
+    double a = 0.0, b = 10.0;
+    for ( int i = 0; i != 100; i++ )
+    {
+      const double z = ( a + b ) / 2.0;
+      ( std::erf( z / std::sqrt( 2.0 ) ) < confidence ? a : b ) = z;
+    }
+    threshold = T( a * a );
+  }
 
-    std::tie( search_space_min.DeltaK_thr, search_space_max.DeltaK_thr ) = contract_range(
-      search_space_min.DeltaK_thr, search_space_max.DeltaK_thr, params_at_min.DeltaK_thr, a );
+  const T at_center = [ & ]( ) {
+    distance_scratch_t< T > scratch;
+    return detail::penalized(
+      objective_function< Norm >( to_params( center ), prepared, scale, scratch ) );
+  }( );
 
-    std::tie( search_space_min.A, search_space_max.A )
-      = contract_range( search_space_min.A, search_space_max.A, params_at_min.A, a );
+  // Distance and solution at every value, NaN until refitted
+  std::array< std::vector< T >, 4 >       distances;
+  std::array< std::vector< point_t >, 4 > solutions;
 
-    progress_callback( t, iterations );
+  st total = 0;
+  for ( auto k : axes )
+  {
+    distances[ k ].assign( values[ k ].size( ), std::numeric_limits< T >::quiet_NaN( ) );
+    solutions[ k ].assign( values[ k ].size( ), center );
 
-//    std::cout << search_space_min.D << " " << search_space_max.D << " " << params_at_min.D << " "
-//              << objective_min << std::endl;
+    distances[ k ][ at_estimate[ k ] ] = at_center;
+    total += values[ k ].size( ) - 1;
   }
 
-  // TODO: Is this correct? For some reason it was not here
-  return params_at_min;
-}
+  std::array< profile_t< T >, 4 > result;
+  std::mutex                      results_mutex;
+  st                              done = 0;
 
-// template< class T, class Container_t >
-// parameters< T > fit3(
-//  const common_among_tests& common,
-//  parameters< T >           search_space_min,
-//  parameters< T >           search_space_max,
-//  Container_t               test_set,
-//  const std::size_t         subdivisions  = 7,
-//  const double&             amortization  = 1.02,
-//  std::size_t               iterations    = 0,
-//  bool                      use_geometric = false,
-//  callback_t< T >           callback = []( parameters< T >, parameters< T >, parameters< T > )
-//  {}, progress_callback_t       progress_callback                  = []( std::size_t,
-//  std::size_t )
-//  {}, const bool&               stop_requested                     = false, std::function< void(
-//  parameters< T > ) > per_thread_callback = []( parameters< T > ) {} )
-//{
-//  using params_t = parameters< T >;
+  auto summarize = [ & ]( ) {
+    T minimum = at_center;
+    for ( auto k : axes )
+    {
+      for ( const auto& d : distances[ k ] )
+      {
+        minimum = std::min( minimum, std::isnan( d ) ? minimum : d );
+      }
+    }
+
+    for ( auto k : axes )
+    {
+      auto& profile     = result[ k ];
+      profile           = profile_t< T > { };
+      profile.threshold = threshold;
 
-//  auto contract_range
-//    = []( const T& lower, const T& upper, const T& new_center, const T& amortization ) {
-//        auto dif    = upper - lower;
-//        auto newdif = dif / amortization;
+      std::vector< T > xs;
+      st               best = 0;
+      for ( st j = 0; j != values[ k ].size( ); j++ )
+      {
+        if ( std::isnan( distances[ k ][ j ] ) )
+        {
+          continue;
+        }
 
-//        auto new_lower = new_center - newdif / 2;
-//        auto new_upper = new_center + newdif / 2;
+        xs.push_back( values[ k ][ j ] );
+        profile.values.push_back( k == 0 ? std::pow( T( 10.0 ), xs.back( ) ) : xs.back( ) );
+        profile.distances.push_back( distances[ k ][ j ] );
+        profile.deviances.push_back( 2 * weight * std::log( distances[ k ][ j ] / minimum ) );
+        profile.estimates.push_back( to_params( solutions[ k ][ j ] ) );
 
-//        if ( new_upper > upper )
-//        {
-//          new_upper = upper;
-//          new_lower = new_upper - newdif;
-//        }
-//        else if ( new_lower < lower )
-//        {
-//          new_lower = lower;
-//          new_upper = new_lower + newdif;
-//        }
+        if ( profile.deviances.back( ) < profile.deviances[ best ] )
+        {
+          best = profile.deviances.size( ) - 1;
+        }
+      }
 
-//        return std::make_tuple( new_lower, new_upper );
-//      };
-
-//  using st = std::size_t;
-
-//  auto objective_min = std::numeric_limits< T >::max( );
-//  if ( iterations == 0 )
-//  {
-//    iterations = std::log( 4000.0 ) / std::log( amortization );
-//  }
-
-//  auto num_tests = test_set.size( );
-
-//  auto subd = subdivisions;
-
-//  std::vector< params_t > params_at_min;
-//  params_at_min.push_back( params_t { 0.0, 0.0, 0.0, 0.0 } );
-
-//  if ( !common.all_common( ) )
-//  {
-//    for ( std::size_t i = 0; i != test_set.size( ) - 1; i++ )
-//    {
-//      params_at_min.push_back( params_t { 0.0, 0.0, 0.0, 0.0 } );
-//    }
-//  }
-
-//  auto subdD = subd;
-//  if ( std::fabs( search_space_max.D - search_space_min.D ) < 1e-19 )
-//  {
-//    subdD = 1;
-//  }
-
-//  std::size_t num_threads = num_tests;
-
-//  std::cout << "Num threads: " << num_threads << std::endl;
-
-//  std::vector< T >        objective_mins( num_tests );
-//  std::vector< params_t > params_mins( num_tests );
-
-//  for ( st i = 0; i != num_tests; i++ )
-//  {
-//    objective_mins[ i ] = std::numeric_limits< T >::max( );
-//    params_mins[ i ]    = params_t { 0.0, 0.0, 0.0, 0.0 };
-//  }
-
-//  auto scale = crack_growth::computeAxesScale< T >( test_set );
-
-//  if ( scale < 1.0e-10 || scale > 1.0e10 )
-//  {
-//    throw std::runtime_error( "Test data relative scales vary orders of magnitude." );
-//  }
-
-//  for ( st t = 0; t != iterations && !stop_requested; t++ )
-//  {
-//    std::vector< std::thread > threads;
-
-//    auto D_index_span = std::floor( ( subdD ) / num_threads );
-
-//    for ( st tid = 0; tid != num_threads; tid++ )
-//    {
-//      threads.push_back( std::thread( [ per_thread_callback,
-//                                        D_index_span,
-//                                        subd,
-//                                        subdD,
-//                                        tid,
-//                                        num_threads,
-//                                        stop_requested,
-//                                        search_space_min,
-//                                        search_space_max,
-//                                        use_geometric,
-//                                        &max_utilization_mins,
-//                                        &objective_mins,
-//                                        &params_mins,
-//                                        subdivisions,
-//                                        &test_set,
-//                                        scale ]( ) {
-//        auto start  = D_index_span * tid;
-//        auto finish = ( tid == num_threads - 1 ) ? subdD : start + D_index_span;
-
-//        std::cout << start << " " << finish << std::endl;
-
-//        for ( auto dj = start; dj != finish && !stop_requested; dj++ )
-//        {
-//          params_t obj_params;
+      // Where the deviance first crosses the threshold on either side of its least value,
+      // interpolating its square root, which is close to linear about the minimum
+      const auto& deviances = profile.deviances;
+
+      auto crossing = [ & ]( st outer, st inner ) {
+        const T root_outer = std::sqrt( deviances[ outer ] );
+        const T root_inner = std::sqrt( std::max( deviances[ inner ], T( 0.0 ) ) );
+
+        const T x = xs[ outer ]
+                    + ( std::sqrt( threshold ) - root_outer ) * ( xs[ inner ] - xs[ outer ] )
+                        / ( root_inner - root_outer );
+        return k == 0 ? std::pow( T( 10.0 ), x ) : x;
+      };
+
+      profile.lower = profile.values.front( );
+      for ( st j = best; j-- != 0; )
+      {
+        if ( deviances[ j ] > threshold )
+        {
+          profile.lower      = crossing( j, j + 1 );
+          profile.lower_open = false;
+          break;
+        }
+      }
+
+      profile.upper = profile.values.back( );
+      for ( st j = best + 1; j < deviances.size( ); j++ )
+      {
+        if ( deviances[ j ] > threshold )
+        {
+          profile.upper      = crossing( j, j - 1 );
+          profile.upper_open = false;
+          break;
+        }
+      }
+    }
+  };
 
-//          // Span of D in the log10 space.
-//          auto low = search_space_min.D;
-//          auto hi  = search_space_max.D;
+  summarize( );
 
-//          auto lowl = std::log10( low );
-//          auto hil  = std::log10( hi );
+  std::atomic< st > next { 0 };
 
-//          auto dl      = sample_parameter( lowl, hil, subdD, dj );
-//          obj_params.D = std::pow( 10.0, dl );
+  const st num_threads = detail::thread_count( );
 
-//          auto subdp = subd;
-//          if ( std::fabs( search_space_max.p - search_space_min.p ) < 1e-19 )
-//          {
-//            subdp = 1;
-//          }
+  std::vector< std::thread > threads;
+  for ( st tid = 0; tid != std::min( num_threads, chains.size( ) ); tid++ )
+  {
+    threads.push_back( std::thread( [ & ]( ) {
+      distance_scratch_t< T > scratch;
 
-//          for ( st pj = 0; pj != subdp && !stop_requested; pj++ )
-//          {
-//            auto low = search_space_min.p;
-//            auto hi  = search_space_max.p;
-
-//            obj_params.p = sample_parameter( low, hi, subd, pj );
-
-//            auto subdDeltaKj = subd;
-//            if ( std::fabs( search_space_max.DeltaK_thr - search_space_min.DeltaK_thr ) < 1e-19
-//            )
-//            {
-//              subdDeltaKj = 1;
-//            }
-
-//            for ( st DeltaKj = 0; DeltaKj != subdDeltaKj && !stop_requested; DeltaKj++ )
-//            {
-//              auto low = search_space_min.DeltaK_thr;
-//              auto hi  = search_space_max.DeltaK_thr;
-
-//              obj_params.DeltaK_thr = sample_parameter( low, hi, subd, DeltaKj );
-
-//              auto subdA = subd;
-//              if ( std::fabs( search_space_max.A - search_space_min.A ) < 1e-19 )
-//              {
-//                subdA = 1;
-//              }
-
-//              for ( st Aj = 0; Aj != subdA && !stop_requested; Aj++ )
-//              {
-//                auto low = search_space_min.A;
-//                auto hi  = search_space_max.A;
-
-//                obj_params.A = sample_parameter( low, hi, subd, Aj );
-
-//                per_thread_callback( obj_params );
-
-//                // auto d = objective_function( obj_params, use_geometric, test_set );
-
-//                auto d = objective_function2( obj_params, use_geometric, test_set, scale );
-//                totalevals++;
-//                if ( d.utilization > max_utilization_mins[ tid ]
-//                     || // prefer utilization over minimization
-//                     ( objective_mins[ tid ] > d.distance
-//                       && d.utilization >= max_utilization_mins[ tid ] ) )
-//                {
-//                  objective_mins[ tid ]       = d.distance;
-//                  params_mins[ tid ]          = obj_params;
-//                  max_utilization_mins[ tid ] = d.utilization;
-//                }
-//              }
-//            }
-//          }
-//        }
-//      } ) );
-//    }
+      for ( st c = next++; c < chains.size( ) && !stop_requested; c = next++ )
+      {
+        const auto [ k, up ] = chains[ c ];
+
+        std::vector< st > others;
+        std::vector< T >  box_low, box_high;
+        for ( auto a : axes )
+        {
+          if ( a != k )
+          {
+            others.push_back( a );
+            box_low.push_back( low[ a ] );
+            box_high.push_back( high[ a ] );
+          }
+        }
+
+        // The foot points of the previous chain are of other curves
+        scratch.foot_points.clear( );
+
+        auto x = center;
 
-//    for ( st tid = 0; tid != num_threads; tid++ )
-//    {
-//      threads[ tid ].join( );
-//    }
+        const st end = up ? values[ k ].size( ) - 1 : 0;
+        for ( st j = at_estimate[ k ]; j != end && !stop_requested; )
+        {
+          j      = up ? j + 1 : j - 1;
+          x[ k ] = values[ k ][ j ];
 
-//    double max_utlization_at_min = 0;
+          auto distance = [ & ]( const std::vector< T >& v ) {
+            auto y = x;
+            for ( st a = 0; a != others.size( ); a++ )
+            {
+              y[ others[ a ] ] = v[ a ];
+            }
+            return detail::penalized(
+              objective_function< Norm >( to_params( y ), prepared, scale, scratch ) );
+          };
 
-//    for ( st tid = 0; tid != num_threads; tid++ )
-//    {
-//      if ( max_utilization_mins[ tid ] > max_utlization_at_min
-//           || ( objective_min > objective_mins[ tid ]
-//                && max_utilization_mins[ tid ] >= max_utlization_at_min ) )
-//      {
+          std::vector< T > x0;
+          for ( auto a : others )
+          {
+            x0.push_back( x[ a ] );
+          }
 
-//        objective_min         = objective_mins[ tid ];
-//        params_at_min         = params_mins[ tid ];
-//        max_utlization_at_min = max_utilization_mins[ tid ];
-//      }
-//    }
+          if ( !others.empty( ) )
+          {
+            nelder_mead::simplex_options_t< T > options;
+            options.max_evaluations = 200 * ( others.size( ) + 1 );
+            options.size_threshold  = 1e-6;
+            options.initial_size    = 0.05;
+            options.num_threads     = 1;
+
+            x0 = nelder_mead::minimize< T >(
+              [ & ]( const std::vector< T >& v, std::size_t ) { return distance( v ); },
+              x0,
+              box_low,
+              box_high,
+              options,
+              []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+              []( std::size_t, std::size_t ) {},
+              stop_requested );
+
+            for ( st a = 0; a != others.size( ); a++ )
+            {
+              x[ others[ a ] ] = x0[ a ];
+            }
+          }
 
-//    for ( st tid = 0; tid != num_threads; tid++ )
-//    {
-//      objective_mins[ tid ]       = objective_min;
-//      params_mins[ tid ]          = params_at_min;
-//      max_utilization_mins[ tid ] = max_utlization_at_min;
-//    }
+          if ( stop_requested )
+          {
+            break;
+          }
 
-//    callback( params_at_min, search_space_min, search_space_max );
+          const T d = distance( x0 );
 
-//    const T a = amortization;
+          std::lock_guard< std::mutex > lock( results_mutex );
 
-//    T Dlmin                  = 0;
-//    T Dlmax                  = 0;
-//    std::tie( Dlmin, Dlmax ) = contract_range( std::log10( search_space_min.D ),
-//                                               std::log10( search_space_max.D ),
-//                                               std::log10( params_at_min.D ),
-//                                               a );
+          distances[ k ][ j ] = d;
+          solutions[ k ][ j ] = x;
+          done++;
 
-//    search_space_min.D = std::pow( 10.0, Dlmin );
-//    search_space_max.D = std::pow( 10.0, Dlmax );
+          summarize( );
 
-//    std::tie( search_space_min.p, search_space_max.p )
-//      = contract_range( search_space_min.p, search_space_max.p, params_at_min.p, a );
+          callback( result );
+          progress_callback( done, total );
+        }
+      }
+    } ) );
+  }
 
-//    std::tie( search_space_min.DeltaK_thr, search_space_max.DeltaK_thr ) = contract_range(
-//      search_space_min.DeltaK_thr, search_space_max.DeltaK_thr, params_at_min.DeltaK_thr, a );
+  for ( auto& thread : threads )
+  {
+    thread.join( );
+  }
 
-//    std::tie( search_space_min.A, search_space_max.A )
-//      = contract_range( search_space_min.A, search_space_max.A, params_at_min.A, a );
+  return result;
+}
 
-//    progress_callback( t, iterations );
+} // namespace detail
 
-//    std::cout << search_space_min.D << " " << search_space_max.D << " " << params_at_min.D << "
-//    "
-//              << objective_min << std::endl;
-//  }
+// Profiles of the parameters fitted at estimate, each held at a sequence of values about it while
+// the others are refitted, and the intervals of their likelihood ratio. callback receives the
+// profiles as every value completes.
+template< class T, class Container_t >
+std::array< profile_t< T >, 4 > profile(
+  parameters< T >         search_space_min,
+  parameters< T >         search_space_max,
+  const Container_t&      test_set,
+  parameters< T >         estimate,
+  std::size_t             points            = 41,
+  norm_t                  norm              = norm_t::ordinary,
+  const double&           confidence        = 0.95,
+  const double&           box_fraction      = 0.5,
+  profile_callback_t< T > callback          = []( std::array< profile_t< T >, 4 > ) {},
+  progress_callback_t     progress_callback = []( std::size_t, std::size_t ) {},
+  const bool&             stop_requested    = false )
+{
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::profile< decltype( norm_policy ), T >( search_space_min,
+                                                         search_space_max,
+                                                         test_set,
+                                                         estimate,
+                                                         points,
+                                                         confidence,
+                                                         box_fraction,
+                                                         callback,
+                                                         progress_callback,
+                                                         stop_requested );
+  };
 
-//  // TODO: Is this correct? For some reason it was not here
-//  return params_at_min;
-//}
+  return dispatch_norm( norm, run );
+}
 
 template< class T, class Container_t >
 parameters< T > fit(
@@ -0,0 +1,484 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include "search_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Covariance matrix adaptation evolution strategy (Hansen, "The CMA evolution strategy: a
+// tutorial"), with the IPOP and BIPOP restart schemes. The search runs in the unit cube mapped onto
+// the box, linearly or logarithmically per dimension, and the population of each generation is
+// evaluated in parallel.
+namespace cmaes
+{
+
+enum class restarts_t
+{
+  none,
+  ipop, // Population doubled on every restart
+  bipop // Interleaves the doubled populations with small ones of smaller step sizes
+};
+
+template< class T = double >
+struct options_t
+{
+  std::size_t max_evaluations = 10000;
+  std::size_t population      = 0; // 4 + 3 ln( dimensions ) if 0
+  T           sigma           = 0.3; // Initial step size, relative to the box
+  T           tolerance_x     = 1.0e-9; // Of the step size, relative to the box
+  T           tolerance_fun   = 1.0e-12; // Of the range of the recent best values
+  restarts_t  restarts        = restarts_t::bipop;
+  std::size_t max_restarts    = 9;
+  std::size_t num_threads     = std::max( 1u, std::thread::hardware_concurrency( ) );
+  unsigned    seed            = 1;
+};
+
+using search::callback_t;
+using search::progress_callback_t;
+
+namespace detail
+{
+
+template< class T >
+using matrix_t = std::vector< std::vector< T > >;
+
+// Eigen decomposition of the symmetric a by cyclic Jacobi rotations. The columns of vectors are
+// the eigenvectors.
+template< class T >
+void symmetric_eigen( matrix_t< T > a, std::vector< T >& values, matrix_t< T >& vectors )
+{
+  const auto n = a.size( );
+
+  vectors.assign( n, std::vector< T >( n, 0.0 ) );
+  for ( std::size_t i = 0; i != n; i++ )
+  {
+    vectors[ i ][ i ] = 1.0;
+  }
+
+  for ( int sweep = 0; sweep != 50; sweep++ )
+  {
+    T off = 0.0;
+    for ( std::size_t i = 0; i != n; i++ )
+    {
+      for ( std::size_t j = i + 1; j != n; j++ )
+      {
+        off += a[ i ][ j ] * a[ i ][ j ];
+      }
+    }
+
+    if ( off < std::numeric_limits< T >::min( ) )
+    {
+      break;
+    }
+
+    for ( std::size_t p = 0; p != n; p++ )
+    {
+      for ( std::size_t q = p + 1; q != n; q++ )
+      {
+        if ( a[ p ][ q ] == 0.0 )
+        {
+          continue;
+        }
+
+        const T theta = ( a[ q ][ q ] - a[ p ][ p ] ) / ( 2.0 * a[ p ][ q ] );
+        const T t     = ( theta >= 0 ? 1.0 : -1.0 )
+                    / ( std::abs( theta ) + std::sqrt( theta * theta + 1.0 ) );
+        const T c = 1.0 / std::sqrt( t * t + 1.0 );
+        const T s = t * c;
+
+        for ( std::size_t k = 0; k != n; k++ )
+        {
+          const T akp = a[ k ][ p ];
+          const T akq = a[ k ][ q ];
+          a[ k ][ p ] = c * akp - s * akq;
+          a[ k ][ q ] = s * akp + c * akq;
+        }
+
+        for ( std::size_t k = 0; k != n; k++ )
+        {
+          const T apk = a[ p ][ k ];
+          const T aqk = a[ q ][ k ];
+          a[ p ][ k ] = c * apk - s * aqk;
+          a[ q ][ k ] = s * apk + c * aqk;
+        }
+
+        for ( std::size_t k = 0; k != n; k++ )
+        {
+          const T vkp = vectors[ k ][ p ];
+          const T vkq = vectors[ k ][ q ];
+          vectors[ k ][ p ] = c * vkp - s * vkq;
+          vectors[ k ][ q ] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  values.resize( n );
+  for ( std::size_t i = 0; i != n; i++ )
+  {
+    values[ i ] = a[ i ][ i ];
+  }
+}
+
+// Reflects x into [ 0, 1 ]
+template< class T >
+T reflect( T x )
+{
+  x = std::fmod( std::abs( x ), T( 2.0 ) );
+  return x > 1.0 ? 2.0 - x : x;
+}
+
+template< class T >
+struct run_result_t
+{
+  std::vector< T > x;
+  T                value = std::numeric_limits< T >::max( );
+};
+
+} // namespace detail
+
+// Minimizes f over the box [ low, high ]. Dimensions with log_scale set are searched in the
+// logarithm of x, which then must be positive. f( x, thread ) is called from num_threads threads at
+// once with the index of the calling thread. callback receives each new minimum and the box of two
+// standard deviations of the search distribution around its mean, progress_callback the
+// evaluations so far and the budget of them.
+template< class T, class F, class Stop = bool >
+std::vector< T > minimize(
+  F&&                 f,
+  std::vector< T >    low,
+  std::vector< T >    high,
+  std::vector< bool > log_scale = { },
+  options_t< T >      options   = options_t< T > { },
+  callback_t< T >     callback  = []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+  progress_callback_t progress_callback = []( std::size_t, std::size_t ) {},
+  const Stop&         stop_requested    = false )
+{
+  using st = std::size_t;
+
+  const search::unit_box_t< T > to_box( low, high, std::move( log_scale ) );
+
+  const st n = to_box.size( );
+
+  if ( options.max_evaluations == 0 )
+  {
+    throw std::runtime_error( "CMA-ES needs a positive number of evaluations." );
+  }
+
+  std::mt19937                      random( options.seed );
+  std::normal_distribution< T >     normal;
+  std::uniform_real_distribution< T > uniform;
+
+  const st default_population
+    = options.population > 0 ? options.population : 4 + st( 3.0 * std::log( T( n ) ) );
+
+  st evaluations = 0;
+
+  detail::run_result_t< T > best;
+
+  // One run of CMA-ES from a mean, step size and population
+  auto run = [ & ]( std::vector< T > mean, T sigma, st lambda ) {
+    const st mu = lambda / 2;
+
+    std::vector< T > weights( mu );
+    for ( st i = 0; i != mu; i++ )
+    {
+      weights[ i ] = std::log( mu + 0.5 ) - std::log( T( i + 1 ) );
+    }
+    const T weight_sum = std::accumulate( weights.begin( ), weights.end( ), T( 0.0 ) );
+
+    T weight_sq_sum = 0.0;
+    for ( auto& w : weights )
+    {
+      w /= weight_sum;
+      weight_sq_sum += w * w;
+    }
+    const T mueff = 1.0 / weight_sq_sum;
+
+    const T nd    = T( n );
+    const T cc    = ( 4.0 + mueff / nd ) / ( nd + 4.0 + 2.0 * mueff / nd );
+    const T cs    = ( mueff + 2.0 ) / ( nd + mueff + 5.0 );
+    const T c1    = 2.0 / ( ( nd + 1.3 ) * ( nd + 1.3 ) + mueff );
+    const T cmu   = std::min( 1.0 - c1,
+                            2.0 * ( mueff - 2.0 + 1.0 / mueff )
+                              / ( ( nd + 2.0 ) * ( nd + 2.0 ) + mueff ) );
+    const T damps
+      = 1.0 + 2.0 * std::max( T( 0.0 ), std::sqrt( ( mueff - 1.0 ) / ( nd + 1.0 ) ) - 1.0 ) + cs;
+    const T chiN  = std::sqrt( nd ) * ( 1.0 - 1.0 / ( 4.0 * nd ) + 1.0 / ( 21.0 * nd * nd ) );
+
+    detail::matrix_t< T > C( n, std::vector< T >( n, 0.0 ) ), B;
+    for ( st i = 0; i != n; i++ )
+    {
+      C[ i ][ i ] = 1.0;
+    }
+
+    std::vector< T > eigenvalues, D( n, 1.0 ), pc( n, 0.0 ), ps( n, 0.0 );
+
+    detail::run_result_t< T > run_best;
+
+    std::vector< T > recent_best;
+
+    for ( st generation = 0; evaluations < options.max_evaluations && !stop_requested;
+          generation++ )
+    {
+      detail::symmetric_eigen( C, eigenvalues, B );
+
+      for ( st i = 0; i != n; i++ )
+      {
+        D[ i ] = std::sqrt( std::max( eigenvalues[ i ], T( 1.0e-20 ) ) );
+      }
+
+      // Samples reflected into the unit cube, and their steps y = ( x - mean ) / sigma
+      std::vector< std::vector< T > > xs( lambda, std::vector< T >( n ) ), ys = xs;
+      for ( st k = 0; k != lambda; k++ )
+      {
+        std::vector< T > z( n );
+        for ( auto& zi : z )
+        {
+          zi = normal( random );
+        }
+
+        for ( st i = 0; i != n; i++ )
+        {
+          T y = 0.0;
+          for ( st j = 0; j != n; j++ )
+          {
+            y += B[ i ][ j ] * D[ j ] * z[ j ];
+          }
+
+          xs[ k ][ i ] = detail::reflect( mean[ i ] + sigma * y );
+          ys[ k ][ i ] = ( xs[ k ][ i ] - mean[ i ] ) / sigma;
+        }
+      }
+
+      std::vector< T > values( lambda );
+
+      search::parallel_for( lambda, options.num_threads, [ & ]( st k, st tid ) {
+        values[ k ] = f( to_box( xs[ k ] ), tid );
+      } );
+
+      evaluations += lambda;
+
+      std::vector< st > order( lambda );
+      std::iota( order.begin( ), order.end( ), 0 );
+      std::stable_sort(
+        order.begin( ), order.end( ), [ & ]( st a, st b ) { return values[ a ] < values[ b ]; } );
+
+      // Recombination
+      std::vector< T > yw( n, 0.0 );
+      for ( st r = 0; r != mu; r++ )
+      {
+        for ( st i = 0; i != n; i++ )
+        {
+          yw[ i ] += weights[ r ] * ys[ order[ r ] ][ i ];
+        }
+      }
+
+      for ( st i = 0; i != n; i++ )
+      {
+        mean[ i ] = detail::reflect( mean[ i ] + sigma * yw[ i ] );
+      }
+
+      // C^-1/2 yw
+      std::vector< T > Btyw( n, 0.0 ), invsqrtCyw( n, 0.0 );
+      for ( st j = 0; j != n; j++ )
+      {
+        for ( st i = 0; i != n; i++ )
+        {
+          Btyw[ j ] += B[ i ][ j ] * yw[ i ];
+        }
+        Btyw[ j ] /= D[ j ];
+      }
+      for ( st i = 0; i != n; i++ )
+      {
+        for ( st j = 0; j != n; j++ )
+        {
+          invsqrtCyw[ i ] += B[ i ][ j ] * Btyw[ j ];
+        }
+      }
+
+      T ps_norm = 0.0;
+      for ( st i = 0; i != n; i++ )
+      {
+        ps[ i ] = ( 1.0 - cs ) * ps[ i ] + std::sqrt( cs * ( 2.0 - cs ) * mueff ) * invsqrtCyw[ i ];
+        ps_norm += ps[ i ] * ps[ i ];
+      }
+      ps_norm = std::sqrt( ps_norm );
+
+      const bool hsig = ps_norm / std::sqrt( 1.0 - std::pow( 1.0 - cs, 2.0 * ( generation + 1 ) ) )
+                          / chiN
+                        < 1.4 + 2.0 / ( nd + 1.0 );
+
+      for ( st i = 0; i != n; i++ )
+      {
+        pc[ i ] = ( 1.0 - cc ) * pc[ i ]
+                  + ( hsig ? std::sqrt( cc * ( 2.0 - cc ) * mueff ) : 0.0 ) * yw[ i ];
+      }
+
+      for ( st i = 0; i != n; i++ )
+      {
+        for ( st j = 0; j <= i; j++ )
+        {
+          T rank_mu = 0.0;
+          for ( st r = 0; r != mu; r++ )
+          {
+            rank_mu += weights[ r ] * ys[ order[ r ] ][ i ] * ys[ order[ r ] ][ j ];
+          }
+
+          const T rank_one
+            = pc[ i ] * pc[ j ] + ( hsig ? 0.0 : cc * ( 2.0 - cc ) * C[ i ][ j ] );
+
+          C[ i ][ j ] = ( 1.0 - c1 - cmu ) * C[ i ][ j ] + c1 * rank_one + cmu * rank_mu;
+          C[ j ][ i ] = C[ i ][ j ];
+        }
+      }
+
+      sigma *= std::exp( ( cs / damps ) * ( ps_norm / chiN - 1.0 ) );
+
+      const auto& generation_best = order[ 0 ];
+      if ( values[ generation_best ] < run_best.value )
+      {
+        run_best = { xs[ generation_best ], values[ generation_best ] };
+      }
+
+      if ( run_best.value < best.value )
+      {
+        best = run_best;
+
+        std::vector< T > lower( n ), upper( n );
+        for ( st i = 0; i != n; i++ )
+        {
+          lower[ i ] = std::max( T( 0.0 ), mean[ i ] - 2.0 * sigma * std::sqrt( C[ i ][ i ] ) );
+          upper[ i ] = std::min( T( 1.0 ), mean[ i ] + 2.0 * sigma * std::sqrt( C[ i ][ i ] ) );
+        }
+
+        callback( to_box( best.x ), to_box( lower ), to_box( upper ) );
+      }
+
+      progress_callback( std::min( evaluations, options.max_evaluations ),
+                         options.max_evaluations );
+
+      // Stop when the steps or the recent best values stall, or C becomes ill conditioned
+      recent_best.push_back( values[ generation_best ] );
+      const st history = 10 + st( 30.0 * nd / lambda );
+      if ( recent_best.size( ) > history )
+      {
+        recent_best.erase( recent_best.begin( ) );
+      }
+
+      const auto [ min_recent, max_recent ]
+        = std::minmax_element( recent_best.begin( ), recent_best.end( ) );
+
+      const auto [ min_D, max_D ] = std::minmax_element( D.begin( ), D.end( ) );
+
+      const bool stalled
+        = recent_best.size( ) == history && *max_recent - *min_recent < options.tolerance_fun;
+
+      if ( sigma * *max_D < options.tolerance_x || stalled || *max_D > 1.0e7 * *min_D )
+      {
+        break;
+      }
+    }
+  };
+
+  auto random_mean = [ & ]( ) {
+    std::vector< T > mean( n );
+    for ( auto& m : mean )
+    {
+      m = uniform( random );
+    }
+    return mean;
+  };
+
+  run( std::vector< T >( n, 0.5 ), options.sigma, default_population );
+
+  // Evaluations spent by the large and the small population regimes of BIPOP
+  st large_evaluations = evaluations;
+  st small_evaluations = 0;
+  st large_population  = default_population;
+
+  for ( st restart = 0; restart != options.max_restarts && options.restarts != restarts_t::none
+                        && evaluations < options.max_evaluations && !stop_requested;
+        restart++ )
+  {
+    const auto before = evaluations;
+
+    if ( options.restarts == restarts_t::ipop || large_evaluations <= small_evaluations )
+    {
+      large_population *= 2;
+      run( random_mean( ), options.sigma, large_population );
+      large_evaluations += evaluations - before;
+    }
+    else
+    {
+      const T u = uniform( random );
+
+      const auto small_population = std::max(
+        default_population,
+        st( default_population
+            * std::pow( 0.5 * T( large_population ) / default_population, u * u ) ) );
+
+      const T sigma = options.sigma * std::pow( 10.0, -2.0 * uniform( random ) );
+
+      run( random_mean( ), sigma, small_population );
+      small_evaluations += evaluations - before;
+    }
+  }
+
+  // Stopped before the first generation was evaluated
+  if ( best.x.empty( ) )
+  {
+    best.x.assign( n, 0.5 );
+  }
+
+  return to_box( best.x );
+}
+
+} // namespace cmaes
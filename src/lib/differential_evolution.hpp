@@ -0,0 +1,510 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include "search_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Differential evolution (Storn and Price) with the DE/rand/1/bin and the JADE (Zhang and
+// Sanderson) strategies. The search runs in the unit cube mapped onto the box, linearly or
+// logarithmically per dimension. In the synchronous mode each generation of trial vectors is
+// evaluated in parallel and replaces the population at once. In the asynchronous mode every thread
+// pulls the next target, builds its trial from the current population, evaluates it and writes it
+// back, so that no thread waits for the slowest candidate of a generation.
+namespace differential_evolution
+{
+
+enum class strategy_t
+{
+  rand_1_bin,
+  jade // current-to-pbest/1 with an archive and adaptive F and CR
+};
+
+enum class mode_t
+{
+  synchronous,
+  asynchronous
+};
+
+template< class T = double >
+struct options_t
+{
+  std::size_t max_evaluations = 10000;
+  std::size_t population      = 0; // max( 20, 10 dimensions ) if 0
+  strategy_t  strategy        = strategy_t::jade;
+  mode_t      mode            = mode_t::asynchronous;
+  T           F               = 0.5; // Initial mean for jade
+  T           CR              = 0.9; // Initial mean for jade
+  T           p_best          = 0.1; // Fraction of the population the pbest of jade is drawn from
+  T           adaptation      = 0.1; // Rate c of the adaptation of the means of jade
+  T           tolerance_x     = 1.0e-9; // Of the spread of the population, relative to the box
+  std::size_t num_threads     = std::max( 1u, std::thread::hardware_concurrency( ) );
+  unsigned    seed            = 1;
+};
+
+using search::callback_t;
+using search::progress_callback_t;
+
+namespace detail
+{
+
+template< class T >
+struct member_t
+{
+  std::vector< T > x;
+  T                value = std::numeric_limits< T >::max( );
+};
+
+// Population and strategy state, shared by the threads under the mutex of minimize
+template< class T >
+struct state_t
+{
+  std::vector< member_t< T > >   population;
+  std::vector< std::vector< T > > archive;
+
+  T mean_F;
+  T mean_CR;
+
+  // Successful F and CR since the last adaptation
+  std::vector< T > success_F;
+  std::vector< T > success_CR;
+
+  std::size_t best = 0;
+};
+
+template< class T >
+struct trial_t
+{
+  std::size_t      target;
+  std::vector< T > x;
+  T                F;
+  T                CR;
+};
+
+// Random index below size, other than the except ones
+inline std::size_t pick( std::mt19937&                        random,
+                         std::size_t                          size,
+                         std::initializer_list< std::size_t > except )
+{
+  std::uniform_int_distribution< std::size_t > index( 0, size - 1 );
+
+  std::size_t r;
+  do
+  {
+    r = index( random );
+  } while ( std::find( except.begin( ), except.end( ), r ) != except.end( ) );
+
+  return r;
+}
+
+template< class T >
+trial_t< T > make_trial( const state_t< T >&   state,
+                         std::size_t            target,
+                         const options_t< T >& options,
+                         std::mt19937&          random )
+{
+  const auto& population = state.population;
+
+  const auto np = population.size( );
+  const auto n  = population[ target ].x.size( );
+
+  std::uniform_real_distribution< T > uniform;
+
+  trial_t< T > trial { target, population[ target ].x, options.F, options.CR };
+
+  std::vector< T > mutant( n );
+
+  switch ( options.strategy )
+  {
+  case strategy_t::rand_1_bin:
+  {
+    const auto r1 = pick( random, np, { target } );
+    const auto r2 = pick( random, np, { target, r1 } );
+    const auto r3 = pick( random, np, { target, r1, r2 } );
+
+    for ( std::size_t j = 0; j != n; j++ )
+    {
+      mutant[ j ] = population[ r1 ].x[ j ]
+                    + trial.F * ( population[ r2 ].x[ j ] - population[ r3 ].x[ j ] );
+    }
+    break;
+  }
+  case strategy_t::jade:
+  {
+    std::normal_distribution< T > normal( state.mean_CR, 0.1 );
+    trial.CR = std::clamp( normal( random ), T( 0.0 ), T( 1.0 ) );
+
+    std::cauchy_distribution< T > cauchy( state.mean_F, 0.1 );
+    do
+    {
+      trial.F = cauchy( random );
+    } while ( !( trial.F > 0 ) );
+    trial.F = std::min( trial.F, T( 1.0 ) );
+
+    // pbest among the best p_best of the population
+    std::vector< std::size_t > order( np );
+    std::iota( order.begin( ), order.end( ), 0 );
+
+    const auto top = std::max( std::size_t( 2 ), std::size_t( options.p_best * np ) );
+    std::partial_sort( order.begin( ), order.begin( ) + top, order.end( ), [ & ]( auto a, auto b ) {
+      return population[ a ].value < population[ b ].value;
+    } );
+
+    const auto pbest
+      = order[ std::uniform_int_distribution< std::size_t >( 0, top - 1 )( random ) ];
+
+    const auto  r1 = pick( random, np, { target } );
+    const auto  r2 = pick( random, np + state.archive.size( ), { target, r1 } );
+    const auto& x2 = r2 < np ? population[ r2 ].x : state.archive[ r2 - np ];
+
+    const auto& xi = population[ target ].x;
+    for ( std::size_t j = 0; j != n; j++ )
+    {
+      mutant[ j ] = xi[ j ] + trial.F * ( population[ pbest ].x[ j ] - xi[ j ] )
+                    + trial.F * ( population[ r1 ].x[ j ] - x2[ j ] );
+    }
+    break;
+  }
+  }
+
+  // Binomial crossover. Mutants outside the cube are pulled halfway from the parent to the bound.
+  const auto forced = std::uniform_int_distribution< std::size_t >( 0, n - 1 )( random );
+  for ( std::size_t j = 0; j != n; j++ )
+  {
+    if ( j == forced || uniform( random ) < trial.CR )
+    {
+      const auto& parent = population[ target ].x[ j ];
+
+      if ( mutant[ j ] < 0.0 )
+      {
+        mutant[ j ] = parent / 2;
+      }
+      else if ( mutant[ j ] > 1.0 )
+      {
+        mutant[ j ] = ( parent + 1.0 ) / 2;
+      }
+
+      trial.x[ j ] = mutant[ j ];
+    }
+  }
+
+  return trial;
+}
+
+// Selection of a trial against the current member of its target. Returns whether it replaced it.
+template< class T >
+bool select( state_t< T >&          state,
+             const trial_t< T >&    trial,
+             const T&               value,
+             const options_t< T >& options,
+             std::mt19937&          random )
+{
+  auto& member = state.population[ trial.target ];
+
+  if ( !( value <= member.value ) )
+  {
+    return false;
+  }
+
+  if ( options.strategy == strategy_t::jade && value < member.value )
+  {
+    state.success_F.push_back( trial.F );
+    state.success_CR.push_back( trial.CR );
+
+    state.archive.push_back( member.x );
+    if ( state.archive.size( ) > state.population.size( ) )
+    {
+      std::uniform_int_distribution< std::size_t > index( 0, state.archive.size( ) - 1 );
+
+      state.archive[ index( random ) ] = state.archive.back( );
+      state.archive.pop_back( );
+    }
+  }
+
+  member = { trial.x, value };
+
+  if ( value < state.population[ state.best ].value )
+  {
+    state.best = trial.target;
+  }
+
+  return true;
+}
+
+// Adaptation of the means of F ( Lehmer mean ) and CR ( arithmetic mean ) of jade
+template< class T >
+void adapt( state_t< T >& state, const options_t< T >& options )
+{
+  if ( state.success_F.empty( ) )
+  {
+    return;
+  }
+
+  const T c = options.adaptation;
+
+  T sum_F = 0.0, sum_F2 = 0.0;
+  for ( const auto& F : state.success_F )
+  {
+    sum_F += F;
+    sum_F2 += F * F;
+  }
+
+  const T mean_CR
+    = std::accumulate( state.success_CR.begin( ), state.success_CR.end( ), T( 0.0 ) )
+      / state.success_CR.size( );
+
+  state.mean_F  = ( 1.0 - c ) * state.mean_F + c * sum_F2 / sum_F;
+  state.mean_CR = ( 1.0 - c ) * state.mean_CR + c * mean_CR;
+
+  state.success_F.clear( );
+  state.success_CR.clear( );
+}
+
+} // namespace detail
+
+// Minimizes f over the box [ low, high ]. Dimensions with log_scale set are searched in the
+// logarithm of x, which then must be positive. f( x, thread ) is called from num_threads threads at
+// once with the index of the calling thread. callback receives each new minimum and the bounding
+// box of the population, progress_callback the evaluations so far and the budget of them.
+template< class T, class F, class Stop = bool >
+std::vector< T > minimize(
+  F&&                 f,
+  std::vector< T >    low,
+  std::vector< T >    high,
+  std::vector< bool > log_scale = { },
+  options_t< T >      options   = options_t< T > { },
+  callback_t< T >     callback  = []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+  progress_callback_t progress_callback = []( std::size_t, std::size_t ) {},
+  const Stop&         stop_requested    = false )
+{
+  using st = std::size_t;
+
+  const search::unit_box_t< T > to_box( low, high, std::move( log_scale ) );
+
+  const st n = to_box.size( );
+
+  const st np
+    = std::max( options.population > 0 ? options.population : std::max( st( 20 ), 10 * n ), st( 4 ) );
+
+  const st num_threads = std::max( st( 1 ), std::min( options.num_threads, np ) );
+
+  std::mt19937                        random( options.seed );
+  std::uniform_real_distribution< T > uniform;
+
+  detail::state_t< T > state;
+  state.mean_F  = options.F;
+  state.mean_CR = options.CR;
+
+  state.population.resize( np );
+  for ( auto& member : state.population )
+  {
+    member.x.resize( n );
+    for ( auto& xj : member.x )
+    {
+      xj = uniform( random );
+    }
+  }
+
+  search::parallel_for( np, num_threads, [ & ]( st i, st tid ) {
+    state.population[ i ].value = f( to_box( state.population[ i ].x ), tid );
+  } );
+
+  for ( st i = 0; i != np; i++ )
+  {
+    if ( state.population[ i ].value < state.population[ state.best ].value )
+    {
+      state.best = i;
+    }
+  }
+
+  st evaluations = np;
+
+  // Called after a change of the best member
+  auto report = [ & ]( ) {
+    std::vector< T > lower( n, 1.0 ), upper( n, 0.0 );
+    for ( const auto& member : state.population )
+    {
+      for ( st j = 0; j != n; j++ )
+      {
+        lower[ j ] = std::min( lower[ j ], member.x[ j ] );
+        upper[ j ] = std::max( upper[ j ], member.x[ j ] );
+      }
+    }
+
+    callback( to_box( state.population[ state.best ].x ), to_box( lower ), to_box( upper ) );
+  };
+
+  auto converged = [ & ]( ) {
+    for ( st j = 0; j != n; j++ )
+    {
+      auto [ lowest, highest ] = std::minmax_element(
+        state.population.begin( ), state.population.end( ), [ j ]( const auto& a, const auto& b ) {
+          return a.x[ j ] < b.x[ j ];
+        } );
+
+      if ( highest->x[ j ] - lowest->x[ j ] > options.tolerance_x )
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  report( );
+
+  switch ( options.mode )
+  {
+  case mode_t::synchronous:
+  {
+    while ( evaluations < options.max_evaluations && !stop_requested && !converged( ) )
+    {
+      std::vector< detail::trial_t< T > > trials;
+      for ( st i = 0; i != np; i++ )
+      {
+        trials.push_back( detail::make_trial( state, i, options, random ) );
+      }
+
+      std::vector< T > values( np );
+      search::parallel_for( np, num_threads, [ & ]( st i, st tid ) {
+        values[ i ] = f( to_box( trials[ i ].x ), tid );
+      } );
+
+      evaluations += np;
+
+      const auto previous_value = state.population[ state.best ].value;
+      for ( st i = 0; i != np; i++ )
+      {
+        detail::select( state, trials[ i ], values[ i ], options, random );
+      }
+
+      detail::adapt( state, options );
+
+      if ( state.population[ state.best ].value < previous_value )
+      {
+        report( );
+      }
+
+      progress_callback( std::min( evaluations, options.max_evaluations ),
+                         options.max_evaluations );
+    }
+    break;
+  }
+  case mode_t::asynchronous:
+  {
+    std::mutex mutex;
+
+    st   next_target      = 0;
+    st   since_adaptation = 0;
+    bool done             = converged( );
+
+    std::vector< std::thread > threads;
+    for ( st tid = 0; tid != num_threads; tid++ )
+    {
+      threads.push_back( std::thread( [ &, tid ]( ) {
+        for ( ;; )
+        {
+          detail::trial_t< T > trial;
+          {
+            std::lock_guard< std::mutex > lock( mutex );
+
+            if ( done || evaluations >= options.max_evaluations || stop_requested )
+            {
+              return;
+            }
+
+            // Counted when pulled, so that the threads stop at the budget
+            evaluations++;
+
+            trial       = detail::make_trial( state, next_target, options, random );
+            next_target = ( next_target + 1 ) % np;
+          }
+
+          const T value = f( to_box( trial.x ), tid );
+
+          std::lock_guard< std::mutex > lock( mutex );
+
+          const auto previous_value = state.population[ state.best ].value;
+
+          detail::select( state, trial, value, options, random );
+
+          if ( state.population[ state.best ].value < previous_value )
+          {
+            report( );
+          }
+
+          // One generation's worth of trials per adaptation and convergence check
+          if ( ++since_adaptation == np )
+          {
+            since_adaptation = 0;
+
+            detail::adapt( state, options );
+            done = converged( );
+
+            progress_callback( std::min( evaluations, options.max_evaluations ),
+                               options.max_evaluations );
+          }
+        }
+      } ) );
+    }
+
+    for ( auto& thread : threads )
+    {
+      thread.join( );
+    }
+    break;
+  }
+  }
+
+  return to_box( state.population[ state.best ].x );
+}
+
+} // namespace differential_evolution
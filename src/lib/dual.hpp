@@ -0,0 +1,255 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+// Forward mode automatic differentiation. A dual number carries a value and its gradient with
+// respect to N variables. The functions below are found by argument dependent lookup, so that code
+// templated on the number type and calling them unqualified, such as fast_math::std_math, is
+// differentiated by instantiating it with dual_t.
+namespace dual
+{
+
+template< class U >
+using if_scalar_t = std::enable_if_t< std::is_arithmetic_v< U > >;
+
+template< class T, std::size_t N >
+struct dual_t
+{
+  dual_t( ) = default;
+
+  // A constant
+  template< class U, class = if_scalar_t< U > >
+  dual_t( const U& value ) : value( T( value ) )
+  {
+  }
+
+  // The variable of index i
+  static dual_t variable( const T& value, std::size_t i )
+  {
+    dual_t x( value );
+    x.gradient[ i ] = 1.0;
+    return x;
+  }
+
+  explicit operator T( ) const { return value; }
+
+  dual_t& operator+=( const dual_t& b )
+  {
+    value += b.value;
+    for ( std::size_t i = 0; i != N; i++ )
+    {
+      gradient[ i ] += b.gradient[ i ];
+    }
+    return *this;
+  }
+
+  dual_t& operator-=( const dual_t& b )
+  {
+    value -= b.value;
+    for ( std::size_t i = 0; i != N; i++ )
+    {
+      gradient[ i ] -= b.gradient[ i ];
+    }
+    return *this;
+  }
+
+  dual_t& operator*=( const dual_t& b )
+  {
+    for ( std::size_t i = 0; i != N; i++ )
+    {
+      gradient[ i ] = gradient[ i ] * b.value + value * b.gradient[ i ];
+    }
+    value *= b.value;
+    return *this;
+  }
+
+  dual_t& operator/=( const dual_t& b )
+  {
+    const T inverse = T( 1.0 ) / b.value;
+    value *= inverse;
+    for ( std::size_t i = 0; i != N; i++ )
+    {
+      gradient[ i ] = ( gradient[ i ] - value * b.gradient[ i ] ) * inverse;
+    }
+    return *this;
+  }
+
+  T                  value = 0.0;
+  std::array< T, N > gradient { };
+};
+
+// f( x ) with f' = derivative
+template< class T, std::size_t N >
+dual_t< T, N > chain( const dual_t< T, N >& x, const T& f, const T& derivative )
+{
+  dual_t< T, N > y( f );
+  for ( std::size_t i = 0; i != N; i++ )
+  {
+    y.gradient[ i ] = derivative * x.gradient[ i ];
+  }
+  return y;
+}
+
+template< class T, std::size_t N >
+dual_t< T, N > operator-( const dual_t< T, N >& x )
+{
+  return chain( x, -x.value, T( -1.0 ) );
+}
+
+#define DUAL_BINARY_OPERATOR( op )                                                                 \
+  template< class T, std::size_t N >                                                               \
+  dual_t< T, N > operator op( dual_t< T, N > a, const dual_t< T, N >& b )                          \
+  {                                                                                                \
+    return a op## = b;                                                                             \
+  }                                                                                                \
+                                                                                                   \
+  template< class T, std::size_t N, class U, class = if_scalar_t< U > >                            \
+  dual_t< T, N > operator op( dual_t< T, N > a, const U& b )                                       \
+  {                                                                                                \
+    return a op## = dual_t< T, N >( b );                                                           \
+  }                                                                                                \
+                                                                                                   \
+  template< class T, std::size_t N, class U, class = if_scalar_t< U > >                            \
+  dual_t< T, N > operator op( const U& a, const dual_t< T, N >& b )                                \
+  {                                                                                                \
+    return dual_t< T, N >( a ) op## = b;                                                           \
+  }
+
+DUAL_BINARY_OPERATOR( + )
+DUAL_BINARY_OPERATOR( - )
+DUAL_BINARY_OPERATOR( * )
+DUAL_BINARY_OPERATOR( / )
+
+#undef DUAL_BINARY_OPERATOR
+
+// Comparisons are on the values, so that branches take the path of the value
+#define DUAL_COMPARISON( op )                                                                      \
+  template< class T, std::size_t N >                                                               \
+  bool operator op( const dual_t< T, N >& a, const dual_t< T, N >& b )                             \
+  {                                                                                                \
+    return a.value op b.value;                                                                     \
+  }                                                                                                \
+                                                                                                   \
+  template< class T, std::size_t N, class U, class = if_scalar_t< U > >                            \
+  bool operator op( const dual_t< T, N >& a, const U& b )                                          \
+  {                                                                                                \
+    return a.value op T( b );                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  template< class T, std::size_t N, class U, class = if_scalar_t< U > >                            \
+  bool operator op( const U& a, const dual_t< T, N >& b )                                          \
+  {                                                                                                \
+    return T( a ) op b.value;                                                                      \
+  }
+
+DUAL_COMPARISON( < )
+DUAL_COMPARISON( > )
+DUAL_COMPARISON( <= )
+DUAL_COMPARISON( >= )
+DUAL_COMPARISON( == )
+DUAL_COMPARISON( != )
+
+#undef DUAL_COMPARISON
+
+template< class T, std::size_t N >
+dual_t< T, N > exp( const dual_t< T, N >& x )
+{
+  const T e = std::exp( x.value );
+  return chain( x, e, e );
+}
+
+template< class T, std::size_t N >
+dual_t< T, N > log( const dual_t< T, N >& x )
+{
+  return chain( x, std::log( x.value ), T( 1.0 ) / x.value );
+}
+
+template< class T, std::size_t N >
+dual_t< T, N > sqrt( const dual_t< T, N >& x )
+{
+  const T s = std::sqrt( x.value );
+  return chain( x, s, T( 0.5 ) / s );
+}
+
+template< class T, std::size_t N >
+dual_t< T, N > fabs( const dual_t< T, N >& x )
+{
+  return x.value < 0 ? -x : x;
+}
+
+template< class T, std::size_t N >
+dual_t< T, N > abs( const dual_t< T, N >& x )
+{
+  return fabs( x );
+}
+
+// x^y for x > 0
+template< class T, std::size_t N >
+dual_t< T, N > pow( const dual_t< T, N >& x, const dual_t< T, N >& y )
+{
+  return exp( y * log( x ) );
+}
+
+template< class T, std::size_t N, class U, class = if_scalar_t< U > >
+dual_t< T, N > pow( const dual_t< T, N >& x, const U& y )
+{
+  const T p = std::pow( x.value, T( y ) );
+  return chain( x, p, T( y ) * std::pow( x.value, T( y ) - T( 1.0 ) ) );
+}
+
+template< class T, std::size_t N, class U, class = if_scalar_t< U > >
+dual_t< T, N > pow( const U& x, const dual_t< T, N >& y )
+{
+  return exp( y * std::log( T( x ) ) );
+}
+
+template< class T, std::size_t N >
+bool isfinite( const dual_t< T, N >& x )
+{
+  return std::isfinite( x.value );
+}
+
+} // namespace dual
@@ -0,0 +1,418 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Branch free approximations of the transcendental functions of the HS kernels, for float and
+// double. Every function is built from integer operations on the representation and polynomials,
+// so that loops over arrays of arguments vectorize (see the array overloads at the end). Outside of
+// the domain the results follow libm: NaN for negative or NaN arguments of log2, log, log10, rsqrt,
+// sqrt and pow, and the limits of libm at zero and infinity. Unlike libm, pow of a negative x is
+// NaN even for an integral y. exp2 and exp saturate at the smallest normal and the largest finite
+// power of two instead of becoming subnormal, zero or infinite. Errors measured against libm over
+// the ranges used by fit (08_test_fast_math):
+//
+//                          double      float
+//   log2, log, log10      <= 4 ulp    <= 5 ulp
+//   exp2, exp             <= 2 ulp    <= 2 ulp
+//   rsqrt, sqrt           <= 3 ulp    <= 3 ulp
+//   pow( x, y )           <= 4 + 2 | y log2( x ) | ulp
+namespace fast_math
+{
+
+namespace detail
+{
+
+template< class T >
+struct float_traits;
+
+template<>
+struct float_traits< float >
+{
+  using bits_t = std::uint32_t;
+
+  static constexpr int    mantissa_bits  = 23;
+  static constexpr int    exponent_bias  = 127;
+  static constexpr bits_t one_bits       = 0x3f800000;
+  static constexpr bits_t sqrt_half_bits = 0x3f3504f3;
+  static constexpr bits_t rsqrt_magic    = 0x5f375a86;
+  static constexpr int    newton_steps   = 3;
+
+  // log( 2 ) split so that n * ln2_hi is exact for any exponent n
+  static constexpr float ln2_hi = 0.693145751953125f;
+  static constexpr float ln2_lo = 1.428606765330187045e-06f;
+};
+
+template<>
+struct float_traits< double >
+{
+  using bits_t = std::uint64_t;
+
+  static constexpr int    mantissa_bits  = 52;
+  static constexpr int    exponent_bias  = 1023;
+  static constexpr bits_t one_bits       = 0x3ff0000000000000;
+  static constexpr bits_t sqrt_half_bits = 0x3fe6a09e667f3bcd;
+  static constexpr bits_t rsqrt_magic    = 0x5fe6eb50c7b537a9;
+  static constexpr int    newton_steps   = 4;
+
+  static constexpr double ln2_hi = 6.93147180369123816490e-01;
+  static constexpr double ln2_lo = 1.90821492927058770002e-10;
+};
+
+template< class To, class From >
+inline To bit_cast( const From& from )
+{
+  static_assert( sizeof( To ) == sizeof( From ) );
+
+  To to;
+  std::memcpy( &to, &from, sizeof( To ) );
+  return to;
+}
+
+// Number of terms of the series below for a truncation error under half an ulp
+template< class T >
+constexpr int log_terms = sizeof( T ) == sizeof( float ) ? 6 : 11;
+
+template< class T >
+constexpr int exp_terms = sizeof( T ) == sizeof( float ) ? 8 : 14;
+
+// 2 atanh( t ) = log( ( 1 + t ) / ( 1 - t ) ) for | t | <= 3 - 2 sqrt( 2 )
+template< class T >
+inline T log_series( const T& t )
+{
+  const T s = t * t;
+
+  T sum = T( 1.0 ) / T( 2 * log_terms< T > - 1 );
+  for ( int k = log_terms< T > - 2; k >= 0; k-- )
+  {
+    sum = sum * s + T( 1.0 ) / T( 2 * k + 1 );
+  }
+
+  return T( 2.0 ) * t * sum;
+}
+
+// exp( r ) for | r | <= log( 2 ) / 2
+template< class T >
+inline T exp_series( const T& r )
+{
+  constexpr double inverse_factorials[] = { 1.0,
+                                            1.0,
+                                            1.0 / 2,
+                                            1.0 / 6,
+                                            1.0 / 24,
+                                            1.0 / 120,
+                                            1.0 / 720,
+                                            1.0 / 5040,
+                                            1.0 / 40320,
+                                            1.0 / 362880,
+                                            1.0 / 3628800,
+                                            1.0 / 39916800,
+                                            1.0 / 479001600,
+                                            1.0 / 6227020800 };
+
+  T sum = T( inverse_factorials[ exp_terms< T > - 1 ] );
+  for ( int k = exp_terms< T > - 2; k >= 0; k-- )
+  {
+    sum = sum * r + T( inverse_factorials[ k ] );
+  }
+
+  return sum;
+}
+
+// Rounds to the nearest integer, for | x | < 2^( mantissa_bits - 1 )
+template< class T >
+inline T round_nearest( const T& x )
+{
+  constexpr T shifter = T( 1.5 ) * T( typename float_traits< T >::bits_t( 1 )
+                                       << float_traits< T >::mantissa_bits );
+
+  return ( x + shifter ) - shifter;
+}
+
+// 2^n for an integral n within the exponent range of T
+template< class T >
+inline T pow2( const T& n )
+{
+  using traits = float_traits< T >;
+  using bits_t = typename traits::bits_t;
+
+  return bit_cast< T >( bits_t( std::int64_t( n ) + traits::exponent_bias )
+                        << traits::mantissa_bits );
+}
+
+// 2^n exp( r ), n clamped to the normal exponent range
+template< class T >
+inline T scale_exp( T n, const T& r )
+{
+  using traits = float_traits< T >;
+
+  constexpr T max_exponent = T( traits::exponent_bias );
+  constexpr T min_exponent = T( 1 - traits::exponent_bias );
+
+  n = n < min_exponent ? min_exponent : ( n > max_exponent ? max_exponent : n );
+
+  return pow2( n ) * exp_series( r );
+}
+
+// condition ? a : b on the representation. A ternary operator lets the compiler compute a only if
+// the condition holds, and that branch keeps the array loops from vectorizing.
+template< class T >
+inline T select( bool condition, const T& a, const T& b )
+{
+  using bits_t = typename float_traits< T >::bits_t;
+
+  const bits_t mask = bits_t( 0 ) - bits_t( condition );
+
+  return bit_cast< T >( ( bit_cast< bits_t >( a ) & mask ) | ( bit_cast< bits_t >( b ) & ~mask ) );
+}
+
+// x clamped to the range of exponents of T, 0 if x is NaN, so that the reductions stay in range
+template< class T >
+inline T exponent_argument( const T& x )
+{
+  constexpr T bound = T( 2 * float_traits< T >::exponent_bias );
+
+  return select( x == x, x < -bound ? -bound : ( x > bound ? bound : x ), T( 0.0 ) );
+}
+
+template< class T >
+inline bool positive_finite( const T& x )
+{
+  return ( x > 0 ) & ( x < std::numeric_limits< T >::infinity( ) );
+}
+
+} // namespace detail
+
+template< class T >
+inline T log2( const T& x )
+{
+  using traits = detail::float_traits< T >;
+  using bits_t = typename traits::bits_t;
+
+  constexpr bits_t mantissa_mask = ( bits_t( 1 ) << traits::mantissa_bits ) - 1;
+
+  // x = 2^e m with m in [ sqrt( 1/2 ), sqrt( 2 ) )
+  const bits_t bits
+    = detail::bit_cast< bits_t >( x ) + ( traits::one_bits - traits::sqrt_half_bits );
+
+  const T e = T( std::int64_t( bits >> traits::mantissa_bits ) - traits::exponent_bias );
+  const T m = detail::bit_cast< T >( ( bits & mantissa_mask ) + traits::sqrt_half_bits );
+
+  const T y
+    = e + detail::log_series( ( m - T( 1.0 ) ) / ( m + T( 1.0 ) ) ) * T( 1.4426950408889634074 );
+
+  // log2( +inf ) = +inf, log2( 0 ) = -inf, NaN below 0
+  const T limit = detail::select(
+    x == 0,
+    -std::numeric_limits< T >::infinity( ),
+    detail::select( x > 0, x, std::numeric_limits< T >::quiet_NaN( ) ) );
+
+  return detail::select( detail::positive_finite( x ), y, limit );
+}
+
+template< class T >
+inline T log( const T& x )
+{
+  return log2( x ) * T( 0.69314718055994530942 );
+}
+
+template< class T >
+inline T log10( const T& x )
+{
+  return log2( x ) * T( 0.30102999566398119521 );
+}
+
+template< class T >
+inline T exp2( const T& x )
+{
+  const T a = detail::exponent_argument( x );
+  const T n = detail::round_nearest( a );
+
+  const T y = detail::scale_exp( n, ( a - n ) * T( 0.69314718055994530942 ) );
+
+  return detail::select( x == x, y, x );
+}
+
+template< class T >
+inline T exp( const T& x )
+{
+  using traits = detail::float_traits< T >;
+
+  // Cody-Waite reduction
+  const T a = detail::exponent_argument( x );
+  const T n = detail::round_nearest( a * T( 1.4426950408889634074 ) );
+
+  const T y = detail::scale_exp( n, ( a - n * traits::ln2_hi ) - n * traits::ln2_lo );
+
+  return detail::select( x == x, y, x );
+}
+
+template< class T >
+inline T pow( const T& x, const T& y )
+{
+  const T z = exp2( y * log2( x ) );
+
+  // 0^y and inf^y are 0, 1 or inf by the sign of y
+  const T limit = detail::select(
+    y > 0, x, detail::select( y < 0, T( 1.0 ) / x, detail::select( y == 0, T( 1.0 ), y ) ) );
+
+  return detail::select( detail::positive_finite( x ),
+                         z,
+                         detail::select( x >= 0, limit, std::numeric_limits< T >::quiet_NaN( ) ) );
+}
+
+template< class T >
+inline T rsqrt( const T& x )
+{
+  using traits = detail::float_traits< T >;
+  using bits_t = typename traits::bits_t;
+
+  T y = detail::bit_cast< T >( traits::rsqrt_magic - ( detail::bit_cast< bits_t >( x ) >> 1 ) );
+
+  const T half_x = T( 0.5 ) * x;
+  for ( int i = 0; i != traits::newton_steps; i++ )
+  {
+    y = y * ( T( 1.5 ) - half_x * y * y );
+  }
+
+  // 1 / sqrt( 0 ) = inf, 1 / sqrt( inf ) = 0
+  return detail::select(
+    detail::positive_finite( x ),
+    y,
+    detail::select( x >= 0, T( 1.0 ) / x, std::numeric_limits< T >::quiet_NaN( ) ) );
+}
+
+template< class T >
+inline T sqrt( const T& x )
+{
+  return detail::select( detail::positive_finite( x ),
+                         x * rsqrt( x ),
+                         detail::select( x >= 0, x, std::numeric_limits< T >::quiet_NaN( ) ) );
+}
+
+// Array versions, y[ i ] = f( x[ i ] ). These are the loops that the compiler vectorizes.
+#define FAST_MATH_ARRAY_FUNCTION( name )                                                         \
+  template< class T >                                                                            \
+  inline void name( const T* x, T* y, std::size_t n )                                            \
+  {                                                                                              \
+    for ( std::size_t i = 0; i != n; i++ )                                                       \
+    {                                                                                            \
+      y[ i ] = name( x[ i ] );                                                                   \
+    }                                                                                            \
+  }
+
+FAST_MATH_ARRAY_FUNCTION( log2 )
+FAST_MATH_ARRAY_FUNCTION( log )
+FAST_MATH_ARRAY_FUNCTION( log10 )
+FAST_MATH_ARRAY_FUNCTION( exp2 )
+FAST_MATH_ARRAY_FUNCTION( exp )
+FAST_MATH_ARRAY_FUNCTION( rsqrt )
+FAST_MATH_ARRAY_FUNCTION( sqrt )
+
+#undef FAST_MATH_ARRAY_FUNCTION
+
+template< class T >
+inline void pow( const T* x, const T& y, T* z, std::size_t n )
+{
+  for ( std::size_t i = 0; i != n; i++ )
+  {
+    z[ i ] = pow( x[ i ], y );
+  }
+}
+
+// Math policies of the HS kernels (evaluate, DistanceScaled and DistanceDeriv)
+struct std_math
+{
+  // Unqualified, so that number types such as dual::dual_t find theirs
+  template< class T >
+  static T log( const T& x )
+  {
+    using std::log;
+    return log( x );
+  }
+
+  template< class T >
+  static T pow( const T& x, const T& y )
+  {
+    using std::pow;
+    return pow( x, y );
+  }
+
+  template< class T >
+  static T sqrt( const T& x )
+  {
+    using std::sqrt;
+    return sqrt( x );
+  }
+};
+
+// long double is evaluated in double
+struct approximate_math
+{
+  template< class T >
+  using working_t = std::conditional_t< std::is_same_v< T, float >, float, double >;
+
+  template< class T >
+  static T log( const T& x )
+  {
+    return T( fast_math::log( working_t< T >( x ) ) );
+  }
+
+  template< class T >
+  static T pow( const T& x, const T& y )
+  {
+    return T( fast_math::pow( working_t< T >( x ), working_t< T >( y ) ) );
+  }
+
+  template< class T >
+  static T sqrt( const T& x )
+  {
+    return T( fast_math::sqrt( working_t< T >( x ) ) );
+  }
+};
+
+} // namespace fast_math
@@ -0,0 +1,841 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include "cgrow.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace crack_growth
+{
+
+// Crack growth models as traits, and a fit that is instantiated for each of them at compile time.
+// A model is a struct of static members:
+//
+//   num_parameters, names and log_scaled: the parameters, and whether they are searched in log10
+//   evaluate< T, Math >( params, R, DeltaK ): da/dN through a Math policy of fast_math.hpp
+//   domain( params, R ): the DeltaK interval where da/dN is finite and positive
+//   bounds< T >( test_set ): a search box guessed from the data
+//
+// and optionally log_slope( params, R, DeltaK ), d log( da/dN ) / d log( DeltaK ) for the
+// geometric norm, which is otherwise obtained by instantiating evaluate with dual numbers.
+namespace models
+{
+
+template< class Model, class T >
+using parameters_t = std::array< T, Model::num_parameters >;
+
+template< class Model, class T >
+using callback_t = std::function< void(
+  parameters_t< Model, T >, parameters_t< Model, T >, parameters_t< Model, T > ) >;
+
+using progress_callback_t = Hartman_Schijve::progress_callback_t;
+
+template< class Model, class T >
+using box_t = std::pair< parameters_t< Model, T >, parameters_t< Model, T > >;
+
+namespace detail
+{
+
+constexpr double log10_e = 0.43429448190325182;
+
+// Range of the coefficient C of da/dN = C * f( R, DeltaK ) over the data. factors( R, DeltaK )
+// returns log10( f ) for the extreme values of the other parameters. The range is widened by a
+// decade on each side.
+template< class T, class Container_t, class F >
+std::pair< T, T > coefficient_range( const Container_t& test_set, F&& factors )
+{
+  T low  = std::numeric_limits< T >::max( );
+  T high = -std::numeric_limits< T >::max( );
+
+  for ( const auto& test : test_set )
+  {
+    for ( const auto& point : test.points )
+    {
+      for ( const T& factor : factors( T( test.R ), T( point.DeltaK ) ) )
+      {
+        const T C = std::log10( T( point.dadN ) ) - factor;
+
+        low  = std::min( low, C );
+        high = std::max( high, C );
+      }
+    }
+  }
+
+  return { std::pow( T( 10.0 ), low - 1 ), std::pow( T( 10.0 ), high + 1 ) };
+}
+
+// Smallest DeltaK, and largest DeltaK and K_max = DeltaK / ( 1 - R ) of the data
+template< class T, class Container_t >
+std::array< T, 3 > data_extent( const Container_t& test_set )
+{
+  std::array< T, 3 > extent { std::numeric_limits< T >::max( ), 0.0, 0.0 };
+
+  for ( const auto& test : test_set )
+  {
+    for ( const auto& point : test.points )
+    {
+      extent[ 0 ] = std::min( extent[ 0 ], T( point.DeltaK ) );
+      extent[ 1 ] = std::max( extent[ 1 ], T( point.DeltaK ) );
+      extent[ 2 ] = std::max( extent[ 2 ], T( point.DeltaK / ( 1.0 - test.R ) ) );
+    }
+  }
+
+  return extent;
+}
+
+} // namespace detail
+
+// da/dN = C DeltaK^m
+struct paris
+{
+  static constexpr std::size_t                  num_parameters = 2;
+  static constexpr std::array< const char*, 2 > names          = { "C", "m" };
+  static constexpr std::array< bool, 2 >        log_scaled     = { true, false };
+
+  template< class T, class Math = fast_math::std_math >
+  static T evaluate( const std::array< T, 2 >& params, const T&, const T& DeltaK )
+  {
+    return params[ 0 ] * Math::pow( DeltaK, params[ 1 ] );
+  }
+
+  template< class T >
+  static T log_slope( const std::array< T, 2 >& params, const T&, const T& )
+  {
+    return params[ 1 ];
+  }
+
+  template< class T >
+  static std::pair< T, T > domain( const std::array< T, 2 >&, const T& )
+  {
+    return { T( 0.0 ), std::numeric_limits< T >::infinity( ) };
+  }
+
+  template< class T, class Container_t >
+  static box_t< paris, T > bounds( const Container_t& test_set )
+  {
+    const T m_low  = 1.0;
+    const T m_high = 8.0;
+
+    auto [ C_low, C_high ] = detail::coefficient_range< T >(
+      test_set, [ & ]( const T&, const T& DeltaK ) {
+        return std::array< T, 2 > { m_low * std::log10( DeltaK ), m_high * std::log10( DeltaK ) };
+      } );
+
+    return { { C_low, m_low }, { C_high, m_high } };
+  }
+};
+
+// da/dN = C ( DeltaK ( 1 - R )^( gamma - 1 ) )^m
+struct walker
+{
+  static constexpr std::size_t                  num_parameters = 3;
+  static constexpr std::array< const char*, 3 > names          = { "C", "m", "gamma" };
+  static constexpr std::array< bool, 3 >        log_scaled     = { true, false, false };
+
+  template< class T, class Math = fast_math::std_math >
+  static T evaluate( const std::array< T, 3 >& params, const T& R, const T& DeltaK )
+  {
+    const T effective = DeltaK * Math::pow( T { 1.0 } - R, params[ 2 ] - T { 1.0 } );
+
+    return params[ 0 ] * Math::pow( effective, params[ 1 ] );
+  }
+
+  template< class T >
+  static T log_slope( const std::array< T, 3 >& params, const T&, const T& )
+  {
+    return params[ 1 ];
+  }
+
+  template< class T >
+  static std::pair< T, T > domain( const std::array< T, 3 >&, const T& )
+  {
+    return { T( 0.0 ), std::numeric_limits< T >::infinity( ) };
+  }
+
+  template< class T, class Container_t >
+  static box_t< walker, T > bounds( const Container_t& test_set )
+  {
+    const std::array< T, 3 > low { 0.0, 1.0, 0.2 };
+    const std::array< T, 3 > high { 0.0, 8.0, 1.0 };
+
+    auto [ C_low, C_high ] = detail::coefficient_range< T >(
+      test_set, [ & ]( const T& R, const T& DeltaK ) {
+        std::array< T, 4 > factors;
+        for ( std::size_t k = 0; k != 4; k++ )
+        {
+          const T m     = k % 2 ? high[ 1 ] : low[ 1 ];
+          const T gamma = k / 2 ? high[ 2 ] : low[ 2 ];
+
+          factors[ k ] = m * ( std::log10( DeltaK ) + ( gamma - 1.0 ) * std::log10( 1.0 - R ) );
+        }
+        return factors;
+      } );
+
+    return { { C_low, low[ 1 ], low[ 2 ] }, { C_high, high[ 1 ], high[ 2 ] } };
+  }
+};
+
+// da/dN = C DeltaK^n / ( ( 1 - R ) K_c - DeltaK )
+struct forman
+{
+  static constexpr std::size_t                  num_parameters = 3;
+  static constexpr std::array< const char*, 3 > names          = { "C", "n", "K_c" };
+  static constexpr std::array< bool, 3 >        log_scaled     = { true, false, false };
+
+  template< class T, class Math = fast_math::std_math >
+  static T evaluate( const std::array< T, 3 >& params, const T& R, const T& DeltaK )
+  {
+    return params[ 0 ] * Math::pow( DeltaK, params[ 1 ] )
+           / ( ( T { 1.0 } - R ) * params[ 2 ] - DeltaK );
+  }
+
+  template< class T >
+  static T log_slope( const std::array< T, 3 >& params, const T& R, const T& DeltaK )
+  {
+    return params[ 1 ] + DeltaK / ( ( 1.0 - R ) * params[ 2 ] - DeltaK );
+  }
+
+  template< class T >
+  static std::pair< T, T > domain( const std::array< T, 3 >& params, const T& R )
+  {
+    return { T( 0.0 ), ( 1.0 - R ) * params[ 2 ] };
+  }
+
+  template< class T, class Container_t >
+  static box_t< forman, T > bounds( const Container_t& test_set )
+  {
+    const auto extent = detail::data_extent< T >( test_set );
+
+    const std::array< T, 3 > low { 0.0, 1.0, T( 1.01 ) * extent[ 2 ] };
+    const std::array< T, 3 > high { 0.0, 8.0, T( 10.0 ) * extent[ 2 ] };
+
+    auto [ C_low, C_high ] = detail::coefficient_range< T >(
+      test_set, [ & ]( const T& R, const T& DeltaK ) {
+        std::array< T, 4 > factors;
+        for ( std::size_t k = 0; k != 4; k++ )
+        {
+          const T n   = k % 2 ? high[ 1 ] : low[ 1 ];
+          const T K_c = k / 2 ? high[ 2 ] : low[ 2 ];
+
+          factors[ k ] = n * std::log10( DeltaK ) - std::log10( ( 1.0 - R ) * K_c - DeltaK );
+        }
+        return factors;
+      } );
+
+    return { { C_low, low[ 1 ], low[ 2 ] }, { C_high, high[ 1 ], high[ 2 ] } };
+  }
+};
+
+// da/dN = C ( ( 1 - f ) K_max )^n ( 1 - DeltaK_thr / DeltaK )^p / ( 1 - K_max / K_c )^q with
+// K_max = DeltaK / ( 1 - R ) and Newman's crack opening function f. Its constraint factor
+// and ratio of the maximum to the flow stress are those of the trait. The derivative is left to
+// automatic differentiation.
+struct nasgro
+{
+  static constexpr std::size_t num_parameters = 6;
+
+  static constexpr std::array< const char*, 6 > names
+    = { "C", "n", "p", "q", "DeltaK_thr", "K_c" };
+  static constexpr std::array< bool, 6 > log_scaled = { true, false, false, false, false, false };
+
+  static constexpr double alpha        = 2.0;
+  static constexpr double stress_ratio = 0.3;
+
+  template< class T >
+  static T closure( const T& R )
+  {
+    const double A0 = ( 0.825 - 0.34 * alpha + 0.05 * alpha * alpha )
+                      * std::pow( std::cos( 1.5707963267948966 * stress_ratio ), 1.0 / alpha );
+    const double A1 = ( 0.415 - 0.071 * alpha ) * stress_ratio;
+    const double A3 = 2.0 * A0 + A1 - 1.0;
+    const double A2 = 1.0 - A0 - A1 - A3;
+
+    if ( R < 0.0 )
+    {
+      return A0 + A1 * R;
+    }
+
+    const T f = A0 + R * ( A1 + R * ( A2 + R * A3 ) );
+
+    return f > R ? f : R;
+  }
+
+  template< class T, class Math = fast_math::std_math >
+  static T evaluate( const std::array< T, 6 >& params, const T& R, const T& DeltaK )
+  {
+    const T one { 1.0 };
+    const T K_max = DeltaK / ( one - R );
+
+    return params[ 0 ] * Math::pow( ( one - closure( R ) ) * K_max, params[ 1 ] )
+           * Math::pow( one - params[ 4 ] / DeltaK, params[ 2 ] )
+           / Math::pow( one - K_max / params[ 5 ], params[ 3 ] );
+  }
+
+  template< class T >
+  static std::pair< T, T > domain( const std::array< T, 6 >& params, const T& R )
+  {
+    return { params[ 4 ], ( 1.0 - R ) * params[ 5 ] };
+  }
+
+  template< class T, class Container_t >
+  static box_t< nasgro, T > bounds( const Container_t& test_set )
+  {
+    const auto extent = detail::data_extent< T >( test_set );
+
+    const std::array< T, 6 > low { 0.0, 1.0, 0.0, 0.0, 0.0, T( 1.01 ) * extent[ 2 ] };
+    const std::array< T, 6 > high { 0.0, 6.0, 1.0, 1.0, extent[ 0 ], T( 10.0 ) * extent[ 2 ] };
+
+    // Without the threshold and instability terms
+    auto [ C_low, C_high ] = detail::coefficient_range< T >(
+      test_set, [ & ]( const T& R, const T& DeltaK ) {
+        const T effective = std::log10( ( 1.0 - closure( R ) ) * DeltaK / ( 1.0 - R ) );
+        return std::array< T, 2 > { low[ 1 ] * effective, high[ 1 ] * effective };
+      } );
+
+    return { { C_low, low[ 1 ], low[ 2 ], low[ 3 ], low[ 4 ], low[ 5 ] },
+             { C_high, high[ 1 ], high[ 2 ], high[ 3 ], high[ 4 ], high[ 5 ] } };
+  }
+};
+
+// The model of Hartman_Schijve::evaluate, with the parameters in the order of
+// Hartman_Schijve::parameters
+struct hartman_schijve
+{
+  static constexpr std::size_t                  num_parameters = 4;
+  static constexpr std::array< const char*, 4 > names          = { "D", "p", "DeltaK_thr", "A" };
+  static constexpr std::array< bool, 4 >        log_scaled     = { true, false, false, false };
+
+  template< class T, class Math = fast_math::std_math >
+  static T evaluate( const std::array< T, 4 >& params, const T& R, const T& DeltaK )
+  {
+    return Hartman_Schijve::evaluate< T, Math >(
+      params[ 0 ], params[ 1 ], params[ 2 ], params[ 3 ], R, DeltaK );
+  }
+
+  template< class T >
+  static T log_slope( const std::array< T, 4 >& params, const T& R, const T& DeltaK )
+  {
+    const T K_max = params[ 3 ] * ( 1.0 - R );
+
+    return params[ 1 ] * DeltaK * ( 1.0 / ( DeltaK - params[ 2 ] ) + 0.5 / ( K_max - DeltaK ) );
+  }
+
+  template< class T >
+  static std::pair< T, T > domain( const std::array< T, 4 >& params, const T& R )
+  {
+    return { params[ 2 ], params[ 3 ] * ( 1.0 - R ) };
+  }
+
+  template< class T, class Container_t >
+  static box_t< hartman_schijve, T > bounds( const Container_t& test_set )
+  {
+    const auto extent = detail::data_extent< T >( test_set );
+
+    const std::array< T, 4 > low { 0.0, 1.5, 0.0, T( 1.01 ) * extent[ 2 ] };
+    const std::array< T, 4 > high { 0.0, 2.5, extent[ 0 ], T( 10.0 ) * extent[ 2 ] };
+
+    // Without the threshold and instability terms
+    auto [ D_low, D_high ] = detail::coefficient_range< T >(
+      test_set, [ & ]( const T&, const T& DeltaK ) {
+        return std::array< T, 2 > { low[ 1 ] * std::log10( DeltaK ),
+                                    high[ 1 ] * std::log10( DeltaK ) };
+      } );
+
+    return { { D_low, low[ 1 ], low[ 2 ], low[ 3 ] }, { D_high, high[ 1 ], high[ 2 ], high[ 3 ] } };
+  }
+};
+
+namespace detail
+{
+
+template< class Model, class T, class = void >
+struct has_log_slope : std::false_type
+{
+};
+
+template< class Model, class T >
+struct has_log_slope< Model,
+                      T,
+                      std::void_t< decltype( Model::log_slope(
+                        std::declval< parameters_t< Model, T > >( ), T( ), T( ) ) ) > >
+  : std::true_type
+{
+};
+
+template< class Model, class T >
+T log_slope( const parameters_t< Model, T >& params, const T& R, const T& DeltaK )
+{
+  if constexpr ( has_log_slope< Model, T >::value )
+  {
+    return Model::log_slope( params, R, DeltaK );
+  }
+  else
+  {
+    using number_t = dual::dual_t< T, 1 >;
+
+    parameters_t< Model, number_t > constants;
+    for ( std::size_t k = 0; k != Model::num_parameters; k++ )
+    {
+      constants[ k ] = number_t( params[ k ] );
+    }
+
+    const auto rate = Model::template evaluate< number_t >(
+      constants, number_t( R ), number_t::variable( DeltaK, 0 ) );
+
+    return rate.gradient[ 0 ] * DeltaK / rate.value;
+  }
+}
+
+// Search coordinates, the log_scaled parameters in log10
+template< class Model, class T >
+parameters_t< Model, T > to_search( parameters_t< Model, T > params )
+{
+  for ( std::size_t k = 0; k != Model::num_parameters; k++ )
+  {
+    if ( Model::log_scaled[ k ] )
+    {
+      params[ k ] = std::log10( params[ k ] );
+    }
+  }
+  return params;
+}
+
+template< class Model, class T >
+parameters_t< Model, T > from_search( parameters_t< Model, T > x )
+{
+  for ( std::size_t k = 0; k != Model::num_parameters; k++ )
+  {
+    if ( Model::log_scaled[ k ] )
+    {
+      x[ k ] = std::pow( T( 10.0 ), x[ k ] );
+    }
+  }
+  return x;
+}
+
+// The curve of a candidate of Model on a block of the prepared test set, for the kernels of
+// Hartman_Schijve in the place of its curve_t. The curve is tabulated uniformly in log( DeltaK ) at
+// first, within the domain and within a decade of the DeltaK of the block, where the foot points
+// lie.
+template< class Model, class Math, class T >
+struct model_curve_t
+{
+  model_curve_t( const parameters_t< Model, T >& params, const T& R, const T& first, const T& last )
+    : params( params ), R( R ), first( first ), last( last )
+  {
+    std::tie( DKlow, DKhigh ) = Model::domain( params, R );
+  }
+
+  static constexpr double min_dt = 1.0e-9;
+
+  static constexpr bool vanishing_rate_at_threshold = false;
+
+  T rate( const T& DeltaK ) const
+  {
+    return Model::template evaluate< T, Math >( params, R, DeltaK );
+  }
+
+  T log_rate( const T& DeltaK ) const
+  {
+    if ( !( DeltaK > DKlow && DeltaK < DKhigh ) )
+    {
+      return std::numeric_limits< T >::quiet_NaN( );
+    }
+    return Math::log( rate( DeltaK ) );
+  }
+
+  bool tabulation_range( T& t_first, T& t_last ) const
+  {
+    constexpr T beta = 1.0e-4;
+
+    const T low  = std::max( DKlow * ( 1.0 + beta ), first / 10 );
+    const T high = std::min( DKhigh * ( 1.0 - beta ), last * 10 );
+
+    if ( !( low < high ) )
+    {
+      return false;
+    }
+
+    t_first = std::log( low );
+    t_last  = std::log( high );
+
+    return true;
+  }
+
+  auto sampler( const T& scale ) const
+  {
+    return [ this, scale ]( const T& log_DeltaK ) {
+      return Hartman_Schijve::curve_sample_t< T > {
+        log_DeltaK,
+        log_DeltaK,
+        log_DeltaK * T( log10_e ),
+        scale * Math::log( rate( std::exp( log_DeltaK ) ) ) * T( log10_e ) };
+    };
+  }
+
+  T log_model_slope( const T& log_DeltaK, T& slope ) const
+  {
+    const T DeltaK = std::exp( log_DeltaK );
+
+    slope = log_slope< Model >( params, R, DeltaK );
+
+    return Math::log( rate( DeltaK ) );
+  }
+
+  const parameters_t< Model, T >& params;
+
+  T R;
+  T first; // DeltaK of the block
+  T last;
+  T DKlow;
+  T DKhigh;
+};
+
+// Objective of the norms of Hartman_Schijve::objective_function for any model. The geometric norm
+// sweeps the tabulated curve, there being no closed form foot points in general. For the mean and
+// Huber aggregations, the evaluation is abandoned as soon as it will exceed bound.
+template< class Model, class Norm, class Math, class T >
+Hartman_Schijve::Model_Distance_t< T >
+objective_function( const parameters_t< Model, T >&                  params,
+                    const Hartman_Schijve::prepared_test_set_t< T >& prepared,
+                    const T&                                         scale,
+                    Hartman_Schijve::distance_scratch_t< T >&        scratch,
+                    const T& bound = std::numeric_limits< T >::infinity( ) )
+{
+  static_assert( !Norm::geometric || Norm::sweep );
+
+  return Hartman_Schijve::curve_objective_function< Norm >(
+    prepared,
+    scale,
+    scratch,
+    [ & ]( const auto& block ) {
+      return model_curve_t< Model, Math, T >( params,
+                                              block.R,
+                                              prepared.points[ block.begin ].DeltaK,
+                                              prepared.points[ block.end - 1 ].DeltaK );
+    },
+    bound );
+}
+
+// The engines of Hartman_Schijve over the search coordinates of Model, the parameters with an
+// empty range held fixed. Utilization is preferred over minimization through a penalty on the
+// rejected weight. The grid contraction, which only needs to know whether a candidate improves
+// on the incumbent, abandons the others early.
+template< class Model, class Norm, class Math, class T, class Container_t >
+parameters_t< Model, T > fit( const parameters_t< Model, T >& search_space_min,
+                              const parameters_t< Model, T >& search_space_max,
+                              const Container_t&              test_set,
+                              Hartman_Schijve::engine_t       engine,
+                              std::size_t                     subdivisions,
+                              double                          amortization,
+                              std::size_t                     max_evaluations,
+                              callback_t< Model, T >          callback,
+                              progress_callback_t             progress_callback,
+                              const bool&                     stop_requested )
+{
+  using Hartman_Schijve::engine_t;
+  using Hartman_Schijve::detail::penalized;
+  using params_t = parameters_t< Model, T >;
+  using st       = std::size_t;
+
+  constexpr st N = Model::num_parameters;
+
+  const auto scale = Hartman_Schijve::detail::checked_scale< T >( test_set );
+
+  const auto prepared = Hartman_Schijve::prepare_test_set< T >( test_set );
+
+  const auto fixed = to_search< Model >( search_space_min );
+  const auto upper = to_search< Model >( search_space_max );
+
+  const st num_threads = Hartman_Schijve::detail::thread_count( );
+
+  if ( engine == engine_t::grid )
+  {
+    std::mutex       incumbent_mutex;
+    params_t         incumbent = fixed;
+    std::atomic_bool stop      = false;
+
+    // Rounded up, so that no candidate better than the incumbent is abandoned
+    std::atomic< double > bound = std::numeric_limits< double >::infinity( );
+
+    std::vector< Hartman_Schijve::distance_scratch_t< T > > scratches( num_threads );
+
+    auto objective = [ & ]( const params_t& x, std::size_t tid ) {
+      if ( stop_requested )
+      {
+        stop = true;
+      }
+
+      const auto params = from_search< Model >( x );
+
+      return penalized( objective_function< Model, Norm, Math >(
+        params, prepared, scale, scratches[ tid ], T( bound.load( ) ) ) );
+    };
+
+    // A new minimum is never abandoned, as its value is below the bound, so value is complete
+    auto report = [ & ]( const params_t& x, const params_t& low, const params_t& high, T value ) {
+      double rounded = double( value );
+      if ( rounded < value )
+      {
+        rounded = std::nextafter( rounded, std::numeric_limits< double >::infinity( ) );
+      }
+      bound = rounded;
+
+      {
+        std::lock_guard< std::mutex > lock( incumbent_mutex );
+        incumbent = x;
+      }
+
+      callback(
+        from_search< Model >( x ), from_search< Model >( low ), from_search< Model >( high ) );
+    };
+
+    cuhyso::minimize( objective,
+                      fixed,
+                      upper,
+                      subdivisions,
+                      T( amortization ),
+                      stop,
+                      report,
+                      progress_callback,
+                      0,
+                      num_threads );
+
+    return from_search< Model >( incumbent );
+  }
+
+  std::vector< st > axes;
+  std::vector< T >  low, high;
+  for ( st k = 0; k != N; k++ )
+  {
+    if ( std::fabs( upper[ k ] - fixed[ k ] ) >= 1e-19 )
+    {
+      axes.push_back( k );
+      low.push_back( fixed[ k ] );
+      high.push_back( upper[ k ] );
+    }
+  }
+
+  if ( axes.empty( ) )
+  {
+    return search_space_min;
+  }
+
+  auto params_of = [ & ]( const std::vector< T >& x ) {
+    auto full = fixed;
+    for ( st j = 0; j != axes.size( ); j++ )
+    {
+      full[ axes[ j ] ] = x[ j ];
+    }
+    return from_search< Model >( full );
+  };
+
+  std::vector< Hartman_Schijve::distance_scratch_t< T > > scratches( num_threads );
+
+  auto objective = [ & ]( const std::vector< T >& x, st tid ) {
+    return penalized( objective_function< Model, Norm, Math >(
+      params_of( x ), prepared, scale, scratches[ tid ] ) );
+  };
+
+  auto report = [ & ]( std::vector< T > x, std::vector< T > box_low, std::vector< T > box_high ) {
+    callback( params_of( x ), params_of( box_low ), params_of( box_high ) );
+  };
+
+  std::vector< T > minimum;
+
+  switch ( engine )
+  {
+  case engine_t::direct:
+  {
+    nelder_mead::direct_options_t< T > options;
+    options.max_evaluations = max_evaluations;
+    options.size_threshold  = 1e-6;
+    options.num_threads     = num_threads;
+
+    minimum = nelder_mead::search< T >(
+      objective, low, high, options, report, progress_callback, stop_requested );
+    break;
+  }
+  case engine_t::cmaes:
+  {
+    cmaes::options_t< T > options;
+    options.max_evaluations = max_evaluations;
+    options.num_threads     = num_threads;
+
+    minimum = cmaes::minimize< T >(
+      objective, low, high, { }, options, report, progress_callback, stop_requested );
+    break;
+  }
+  case engine_t::differential_evolution:
+  {
+    differential_evolution::options_t< T > options;
+    options.max_evaluations = max_evaluations;
+    options.num_threads     = num_threads;
+
+    minimum = differential_evolution::minimize< T >(
+      objective, low, high, { }, options, report, progress_callback, stop_requested );
+    break;
+  }
+  case engine_t::surrogate:
+  {
+    surrogate::options_t< T > options;
+    options.max_evaluations = max_evaluations;
+    options.num_threads     = num_threads;
+
+    minimum = surrogate::minimize< T >(
+      objective, low, high, { }, options, report, progress_callback, stop_requested );
+    break;
+  }
+  case engine_t::nelder_mead:
+  {
+    nelder_mead::simplex_options_t< T > options;
+    options.max_evaluations = max_evaluations;
+    options.size_threshold  = 1e-8;
+    options.simplices       = num_threads;
+    options.num_threads     = num_threads;
+
+    std::vector< T > center( low.size( ) );
+    for ( st j = 0; j != low.size( ); j++ )
+    {
+      center[ j ] = ( low[ j ] + high[ j ] ) / 2;
+    }
+
+    minimum = nelder_mead::minimize< T >(
+      objective, center, low, high, options, report, progress_callback, stop_requested );
+    break;
+  }
+  case engine_t::grid:
+    break;
+  }
+
+  return params_of( minimum );
+}
+
+// run for Hartman_Schijve::dispatch_norm, both geometric norms sweeping the tabulated curve
+template< class F >
+auto sweep_geometric( F& run )
+{
+  return [ &run ]( auto norm_policy ) {
+    if constexpr ( decltype( norm_policy )::geometric )
+    {
+      return run( Hartman_Schijve::geometric_sweep_norm { } );
+    }
+    else
+    {
+      return run( norm_policy );
+    }
+  };
+}
+
+} // namespace detail
+
+// Objective of Hartman_Schijve::objective_function for Model
+template< class Model, class T, class Container_t >
+Hartman_Schijve::Model_Distance_t< T > objective_function( const parameters_t< Model, T >& params,
+                                                           Hartman_Schijve::norm_t         norm,
+                                                           const Container_t& test_set )
+{
+  namespace hs = Hartman_Schijve;
+
+  const auto prepared = hs::prepare_test_set< T >( test_set );
+  const auto scale    = crack_growth::computeAxesScale< T >( test_set );
+
+  hs::distance_scratch_t< T > scratch;
+
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::objective_function< Model, decltype( norm_policy ), fast_math::std_math >(
+      params, prepared, scale, scratch );
+  };
+
+  return hs::dispatch_norm( norm, detail::sweep_geometric( run ) );
+}
+
+// Fit of Model with one of the engines of Hartman_Schijve, the grid contraction by subdivisions
+// and amortization and the others by max_evaluations. Both geometric norms sweep the tabulated
+// curve. Math is a policy of fast_math.hpp for the model evaluations.
+template< class Model, class T, class Math = fast_math::std_math, class Container_t >
+parameters_t< Model, T > fit(
+  parameters_t< Model, T > search_space_min,
+  parameters_t< Model, T > search_space_max,
+  const Container_t&       test_set,
+  Hartman_Schijve::engine_t engine,
+  std::size_t              subdivisions,
+  double                   amortization,
+  std::size_t              max_evaluations,
+  Hartman_Schijve::norm_t  norm,
+  callback_t< Model, T >   callback
+  = []( parameters_t< Model, T >, parameters_t< Model, T >, parameters_t< Model, T > ) {},
+  progress_callback_t progress_callback = []( std::size_t, std::size_t ) {},
+  const bool&         stop_requested    = false )
+{
+  namespace hs = Hartman_Schijve;
+
+  auto run = [ & ]( auto norm_policy ) {
+    return detail::fit< Model, decltype( norm_policy ), Math, T >( search_space_min,
+                                                                    search_space_max,
+                                                                    test_set,
+                                                                    engine,
+                                                                    subdivisions,
+                                                                    amortization,
+                                                                    max_evaluations,
+                                                                    callback,
+                                                                    progress_callback,
+                                                                    stop_requested );
+  };
+
+  return hs::dispatch_norm( norm, detail::sweep_geometric( run ) );
+}
+
+} // namespace models
+
+} // namespace crack_growth
@@ -40,11 +40,22 @@
 
 #pragma once
 #include "linalg.h"
+#include "search_common.hpp"
 
 #include <array>
 #include <numeric>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 
 template<typename OStream, typename T, std::size_t N>
@@ -558,179 +569,731 @@ std::vector<T> operator*( const T a, std::vector<T> v )
 
 }
 
+// Hyperrectangle of the DIRECT search, in the unit cube. The side along dimension i is 3^-levels[i].
 template <class T>
-class node
+struct node
 {
-    int dimensions = 2;
-    std::vector< node< T > > subnodes;
-    std::vector< bounds<T> > bounds_;
+    std::vector<T>          center;
+    std::vector<int>        levels;
+    T                       value;
 
-    bounds<T> get_bounds_of_subdiv( int index )
+    // Half of the diagonal, by which the rectangles are grouped
+    T size() const
     {
-        std::vector< bounds<T>> subdiv_bounds;
+        auto sorted = levels;
+        std::sort( sorted.begin(), sorted.end() );
 
-        for ( auto dim = 0; dim != bounds_.size(); dim++ )
+        T sum = 0.0;
+        for ( auto l : sorted )
         {
-            auto middle = ( bounds_[index].lower + bounds_[index].upper ) / 2.0;
+            sum += std::pow( T( 3.0 ), -2 * l );
+        }
+        return 0.5 * std::sqrt( sum );
+    }
+
+    int min_level() const { return *std::min_element( levels.begin(), levels.end() ); }
+
+    // The children of a division along dimension dim, centered at center +- third of the side
+    std::array<std::vector<T>, 2> get_centers_of_subdiv( std::size_t dim ) const
+    {
+        const T third = std::pow( T( 3.0 ), -( levels[dim] + 1 ) );
+
+        auto left  = center;
+        auto right = center;
+        left[dim]  -= third;
+        right[dim] += third;
+
+        return { left, right };
+    }
+
+    bounds<T> get_bounds_of_subdiv( std::size_t dim ) const
+    {
+        const T half = 0.5 * std::pow( T( 3.0 ), -levels[dim] );
+
+        bounds<T> b;
+        b.expand( center[dim] - half );
+        b.expand( center[dim] + half );
+        return b;
+    }
+};
+
+template <class T = double>
+struct direct_options_t
+{
+    direct_options_t() = default;
+
+    std::size_t max_evaluations = 10000;
+    std::size_t max_iterations  = 1000;
+    T size_threshold            = 1e-4; // Smallest side of the rectangle of the minimum, relative to the search box
+    T epsilon                   = 1e-4; // Required improvement of a potentially optimal rectangle, relative to the minimum
+    bool locally_biased         = true; // DIRECT-L: at most one rectangle per size in each iteration
+    std::size_t num_threads     = std::max( 1u, std::thread::hardware_concurrency() );
+};
+
+template <class T>
+using search_callback_t = std::function< void( std::vector<T>, std::vector<T>, std::vector<T> ) >;
+
+using search_progress_callback_t = std::function< void( std::size_t, std::size_t ) >;
+
+namespace detail
+{
+
+// Indices of the potentially optimal rectangles of DIRECT: those on the lower right convex hull of
+// ( size, value ), from the minimum to the largest size, that can improve the minimum by epsilon
+template <class T>
+std::vector<std::size_t> potentially_optimal( const std::vector<node<T>> &nodes,
+                                              const T &fmin,
+                                              const T &epsilon,
+                                              bool locally_biased )
+{
+    // The rectangles with the lowest value of each size, by increasing size
+    std::map<T, std::vector<std::size_t>> by_size;
+    for ( std::size_t i = 0; i != nodes.size(); i++ )
+    {
+        auto &group = by_size[ nodes[i].size() ];
+
+        if ( group.empty() || nodes[i].value < nodes[group[0]].value )
+        {
+            group = { i };
+        }
+        else if ( nodes[i].value == nodes[group[0]].value && !locally_biased )
+        {
+            group.push_back( i );
+        }
+    }
+
+    std::vector<T> sizes;
+    std::vector<std::vector<std::size_t>> groups;
+    for ( const auto &[size, group] : by_size )
+    {
+        sizes.push_back( size );
+        groups.push_back( group );
+    }
 
-            auto is_the_left = index & (1 << dim); //Binary representation of left and right
+    auto value = [&]( std::size_t k ) { return nodes[ groups[k][0] ].value; };
 
-            if ( is_the_left )
+    // Start at the largest of the sizes with the lowest value
+    std::size_t start = 0;
+    for ( std::size_t k = 1; k != groups.size(); k++ )
+    {
+        if ( value( k ) <= value( start ) )
+        {
+            start = k;
+        }
+    }
+
+    std::vector<std::size_t> hull;
+    for ( std::size_t k = start; k != groups.size(); k++ )
+    {
+        // Drop the points above the segment from the previous hull point to this one
+        while ( hull.size() >= 2 )
+        {
+            auto a = hull[ hull.size() - 2 ];
+            auto b = hull[ hull.size() - 1 ];
+
+            auto cross = ( sizes[b] - sizes[a] ) * ( value( k ) - value( a ) )
+                         - ( value( b ) - value( a ) ) * ( sizes[k] - sizes[a] );
+            if ( cross > 0 )
             {
-                subdiv_bounds.emplace_back( bounds<T>{ bounds_[index].lower, middle } );
+                break;
             }
-            else
+            hull.pop_back();
+        }
+        hull.push_back( k );
+    }
+
+    std::vector<std::size_t> selected;
+    for ( std::size_t h = 0; h != hull.size(); h++ )
+    {
+        const auto k = hull[h];
+
+        if ( h + 1 != hull.size() )
+        {
+            const auto next  = hull[h + 1];
+            const T    slope = ( value( next ) - value( k ) ) / ( sizes[next] - sizes[k] );
+
+            if ( value( k ) - slope * sizes[k] > fmin - epsilon * std::abs( fmin ) )
             {
-                subdiv_bounds.emplace_back( bounds<T>{ middle, bounds_[index].upper } );
+                continue;
             }
         }
+
+        selected.insert( selected.end(), groups[k].begin(), groups[k].end() );
     }
-};
 
+    return selected;
+}
+
+// f( x, thread ) of every point, by num_threads threads
 template <class T, class F>
-std::vector<T> search(
-        F               &&f,
-        std::vector<T>  x0,
-        std::vector<T>  low,
-        std::vector<T>  high )
+std::vector<T> evaluate_batch( F &&f, const std::vector<std::vector<T>> &points, std::size_t num_threads )
 {
-    using namespace detail;
+    std::vector<T> values( points.size() );
 
-    if ( !( x0.size() == low.size() && x0.size() == high.size())  )
+    num_threads = std::max( std::size_t( 1 ), std::min( num_threads, points.size() ) );
+
+    std::vector<std::thread> threads;
+    for ( std::size_t tid = 0; tid != num_threads; tid++ )
     {
-        throw std::runtime_error("x0 and r0 lists should be the same length.");
+        threads.push_back( std::thread( [&, tid]()
+        {
+            for ( auto i = tid; i < points.size(); i += num_threads )
+            {
+                values[i] = f( points[i], tid );
+            }
+        } ) );
     }
 
-    auto n = x0.size();
+    for ( auto &thread : threads )
+    {
+        thread.join();
+    }
 
-    std::vector< bounds< T > > bounding_box;
-    bounding_box.reserve( n );
+    return values;
+}
 
-    for ( std::size_t i = 0 ; i != n; i++)
-    {
-        bounds< T > b;
-        b.expand( low[ i ] );
-        b.expand( high[ i ] );
+}
 
-        bounding_box.emplace_back( b );
+// DIRECT global minimization of f over the box [ low, high ] (Jones et al., and the locally biased
+// DIRECT-L of Gablonsky and Kelley). f( x, thread ) is called from num_threads threads at once with
+// the index of the calling thread, so that callers can keep per thread state. The new points of
+// all rectangles divided in an iteration are evaluated as one parallel batch. callback receives
+// each new minimum and the bounds of its rectangle, progress_callback the evaluations so far and
+// the budget of them.
+template <class T, class F, class Stop = bool>
+std::vector<T> search(
+        F                               &&f,
+        std::vector<T>                  low,
+        std::vector<T>                  high,
+        direct_options_t<T>             options             = direct_options_t<T>{},
+        search_callback_t<T>            callback            = []( std::vector<T>, std::vector<T>, std::vector<T> ){},
+        search_progress_callback_t      progress_callback   = []( std::size_t, std::size_t ){},
+        const Stop                      &stop_requested     = false )
+{
+    if ( low.size() != high.size() || low.empty() )
+    {
+        throw std::runtime_error("The lower and upper bounds should be non empty lists of the same length.");
     }
 
-    auto x = x0;
-    auto fmin = f( x );
+    const auto n = low.size();
 
+    auto to_box = [&]( const std::vector<T> &u )
+    {
+        std::vector<T> x( n );
+        for ( std::size_t i = 0; i != n; i++ )
+        {
+            x[i] = low[i] + u[i] * ( high[i] - low[i] );
+        }
+        return x;
+    };
+
+    auto evaluate = [&]( const std::vector<std::vector<T>> &centers )
+    {
+        std::vector<std::vector<T>> xs;
+        for ( const auto &c : centers )
+        {
+            xs.push_back( to_box( c ) );
+        }
+        return detail::evaluate_batch<T>( f, xs, options.num_threads );
+    };
 
+    std::vector<node<T>> nodes;
+    nodes.push_back( node<T>{ std::vector<T>( n, 0.5 ), std::vector<int>( n, 0 ), 0.0 } );
+    nodes[0].value = evaluate( { nodes[0].center } )[0];
 
+    std::size_t evaluations = 1;
+    std::size_t best        = 0;
 
-    for ( auto k = 0; k != 10; k++)
+    auto report = [&]()
     {
-        for ( std::size_t j = 0 ; j != n ; j++)
+        std::vector<T> lower( n ), upper( n );
+        for ( std::size_t i = 0; i != n; i++ )
         {
-            std::cout << "[ " << bounding_box[j].lower << " " << bounding_box[j].upper << " ]" << std::endl;
+            auto b = nodes[best].get_bounds_of_subdiv( i );
+            lower[i] = low[i] + b.lower * ( high[i] - low[i] );
+            upper[i] = low[i] + b.upper * ( high[i] - low[i] );
         }
-        std::cout << "New x: " << x << std::endl;
+        callback( to_box( nodes[best].center ), lower, upper );
+    };
 
-        std::vector<T> func_vals;
-        //func_vals.push_back( fmin );
+    report();
 
-        std::vector<std::vector<double>> xs;
-        //xs.push_back( x );
+    for ( std::size_t iteration = 0;
+          iteration != options.max_iterations && evaluations < options.max_evaluations && !stop_requested &&
+          std::pow( T( 3.0 ), -nodes[best].min_level() ) > options.size_threshold;
+          iteration++ )
+    {
+        auto selected = detail::potentially_optimal( nodes, nodes[best].value, options.epsilon,
+                                                     options.locally_biased );
 
-        multi_index_t mi( std::vector<std::size_t>( n, 2) );
+        // The dimensions of the longest sides of every selected rectangle, and the batch of the
+        // centers of the thirds along them
+        std::vector<std::vector<std::size_t>> dims( selected.size() );
+        std::vector<std::vector<T>> centers;
 
-        std::vector<bounds<T>> new_bounds( n );
-        std::vector<T> newx(n);
+        for ( std::size_t s = 0; s != selected.size(); s++ )
+        {
+            const auto &rect = nodes[ selected[s] ];
+            for ( std::size_t i = 0; i != n; i++ )
+            {
+                if ( rect.levels[i] == rect.min_level() )
+                {
+                    dims[s].push_back( i );
 
-        std::size_t count = 0;
-        for ( ; mi < mi.sizes(); mi++ )
+                    auto [left, right] = rect.get_centers_of_subdiv( i );
+                    centers.push_back( left );
+                    centers.push_back( right );
+                }
+            }
+        }
+
+        auto values = evaluate( centers );
+        evaluations += values.size();
+
+        std::size_t offset = 0;
+        for ( std::size_t s = 0; s != selected.size(); s++ )
         {
-            auto l = mi.location();
+            const auto parent = selected[s];
+            const auto m      = dims[s].size();
 
-            std::vector<double> xcorner;
+            // Divide first along the dimension with the best third, so that it gets the largest
+            // rectangle
+            std::vector<T> w( m );
+            for ( std::size_t j = 0; j != m; j++ )
+            {
+                w[j] = std::min( values[offset + 2 * j], values[offset + 2 * j + 1] );
+            }
 
-            for ( std::size_t i = 0 ; i != l.size(); i++ )
+            auto order = detail::sort_indexes( w );
+
+            for ( std::size_t k = 0; k != m; k++ )
             {
-                if ( l[i] == 0 )
-                {
-                    xcorner.push_back( bounding_box[i].lower );
-                }
-                else
+                const auto j = order[k];
+
+                for ( std::size_t side = 0; side != 2; side++ )
                 {
-                    xcorner.push_back( bounding_box[i].upper );
+                    node<T> child{ centers[offset + 2 * j + side], nodes[parent].levels,
+                                   values[offset + 2 * j + side] };
+
+                    for ( std::size_t kk = 0; kk <= k; kk++ )
+                    {
+                        child.levels[ dims[s][ order[kk] ] ]++;
+                    }
+
+                    nodes.push_back( child );
                 }
+
+                nodes[parent].levels[ dims[s][j] ]++;
             }
 
+            offset += 2 * m;
+        }
 
-            for ( auto i = 0; i !=50; i++)
+        auto previous_best = best;
+        for ( std::size_t i = 0; i != nodes.size(); i++ )
+        {
+            if ( nodes[i].value < nodes[best].value )
             {
-                auto fcorner = f( xcorner ) ;
+                best = i;
+            }
+        }
 
-                auto test = 0.5*(xcorner - x);
-                auto ftest = f( test );
-                std::cout << fcorner << ", " << ftest << std::endl;
+        if ( best != previous_best )
+        {
+            report();
+        }
 
-                if ( f( test ) > f( xcorner ) )
-                {
-                    test = 1.5*(xcorner - x );
+        progress_callback( std::min( evaluations, options.max_evaluations ), options.max_evaluations );
+    }
 
-                }
-                xcorner = test;
+    return to_box( nodes[best].center );
+}
+
+template <class T = double>
+struct simplex_options_t
+{
+    simplex_options_t() = default;
+
+    std::size_t max_evaluations = 10000;
+    T threshold                 = std::numeric_limits<T>::lowest(); // Stops once the minimum is below
+    T size_threshold            = 1e-8; // Largest side of the simplex, relative to the search box
+    T initial_size              = 0.1;  // Sides of the initial simplex, relative to the search box
+    std::size_t simplices       = 1;    // Independent simplices, the first from x0 and the others from random points
+    bool speculative            = false; // Evaluates reflection, expansion and both contractions at once
+    std::size_t num_threads     = std::max( 1u, std::thread::hardware_concurrency() );
+    unsigned seed               = 1;
+};
+
+namespace detail
+{
+
+// Simplex of n + 1 vertices in one flat buffer, ordered by value through order, and the sum of its
+// vertices, so that the centroid of all but the worst is kept without a pass over the vertices.
+// Nothing is allocated once constructed.
+template <class T>
+struct simplex_t
+{
+    simplex_t( std::size_t n ):
+        n( n ),
+        vertices( ( n + 1 ) * n ),
+        values( n + 1 ),
+        order( n + 1 ),
+        sum( n ),
+        centroid( n ),
+        trials( 4 * n ),
+        trial_values( 4 )
+    {
+        std::iota( order.begin(), order.end(), 0 );
+    }
+
+    T *vertex( std::size_t i ) { return &vertices[ i * n ]; }
+    T *trial( std::size_t i ) { return &trials[ i * n ]; }
+
+    std::size_t best() const { return order[0]; }
+    std::size_t worst() const { return order[n]; }
+
+    void sort()
+    {
+        std::sort( order.begin(), order.end(), [&]( std::size_t a, std::size_t b ) { return values[a] < values[b]; } );
+
+        std::fill( sum.begin(), sum.end(), T( 0.0 ) );
+        for ( std::size_t i = 0; i != n + 1; i++ )
+        {
+            for ( std::size_t j = 0; j != n; j++ )
+            {
+                sum[j] += vertices[ i * n + j ];
             }
+        }
+    }
+
+    // Replaces the worst vertex and moves it to its rank
+    void replace_worst( const T *x, const T &value )
+    {
+        const auto w = worst();
+        for ( std::size_t j = 0; j != n; j++ )
+        {
+            sum[j] += x[j] - vertices[ w * n + j ];
+            vertices[ w * n + j ] = x[j];
+        }
+        values[w] = value;
+
+        auto k = n;
+        for ( ; k != 0 && values[ order[ k - 1 ] ] > value; k-- )
+        {
+            order[k] = order[ k - 1 ];
+        }
+        order[k] = w;
+    }
 
-            for ( std::size_t i = 0; i !=n; i++ )
+    // Largest distance of a vertex to the best one along each axis, relative to extent
+    T size( const std::vector<T> &extent ) const
+    {
+        const auto b = order[0];
+
+        T largest = 0.0;
+        for ( std::size_t i = 0; i != n + 1; i++ )
+        {
+            for ( std::size_t j = 0; j != n; j++ )
             {
-                new_bounds[i].expand( xcorner[i] );
+                largest = std::max( largest, std::fabs( vertices[ i * n + j ] - vertices[ b * n + j ] ) / extent[j] );
             }
+        }
+        return largest;
+    }
 
-            newx = newx + xcorner;
+    std::size_t n;
+    std::vector<T> vertices;
+    std::vector<T> values;
+    std::vector<std::size_t> order;
+    std::vector<T> sum;
+    std::vector<T> centroid;
+    std::vector<T> trials; // Reflection, expansion, outside and inside contraction
+    std::vector<T> trial_values;
+};
 
-            count++;
+// Evaluates count points of n coordinates, at stride n from first, on the threads of pool, the
+// first of them numbered thread_begin. points holds a buffer of n coordinates for each thread.
+template <class T, class F>
+void evaluate_points( F &&f, const T *first, std::size_t n, std::size_t count, T *values,
+                      search::worker_pool_t &pool, std::vector<std::vector<T>> &points,
+                      std::size_t thread_begin )
+{
+    auto evaluate = [&]( std::size_t i, std::size_t tid )
+    {
+        auto &point = points[tid];
+        point.assign( first + i * n, first + ( i + 1 ) * n );
+        values[i] = f( point, thread_begin + tid );
+    };
 
-            std::cout << std::endl;
+    pool.run( count, evaluate );
+}
 
-            //            xs.push_back( x );
-            //            func_vals.push_back( f(xcorner) );
+}
 
-            //            xs.push_back( mid );
-            //            func_vals.push_back( f(mid) );
+// Nelder-Mead minimization of f over the box [ low, high ] from x0, the trial points mirrored into
+// the box. f( x, thread ) is called from num_threads threads at once with the index of the calling
+// thread. The shrink points are evaluated in parallel, and with speculative set the reflection,
+// expansion and both contractions of an iteration too, which trades evaluations for fewer rounds.
+// Each simplex keeps its threads for the whole run. speculative spends more evaluations per
+// iteration, which pays off only for costly objectives, and is off by default.
+// With several simplices each runs on its own share of the threads. callback receives each new
+// minimum and the bounding box of its simplex, progress_callback the evaluations so far and the
+// budget of them.
+template <class T, class F, class Stop = bool>
+std::vector<T> minimize(
+        F                               &&f,
+        std::vector<T>                  x0,
+        std::vector<T>                  low,
+        std::vector<T>                  high,
+        simplex_options_t<T>            options             = simplex_options_t<T>{},
+        search_callback_t<T>            callback            = []( std::vector<T>, std::vector<T>, std::vector<T> ){},
+        search_progress_callback_t      progress_callback   = []( std::size_t, std::size_t ){},
+        const Stop                      &stop_requested     = false )
+{
+    using st = std::size_t;
 
-            //                   std::cout << "xcorner: " << xcorner << " " << *func_vals.rbegin() << std::endl;
-            //                   std::cout << "mid: " << mid << " " << *func_vals.rbegin() << std::endl;
+    const st n = low.size();
+
+    if ( n == 0 || high.size() != n || x0.size() != n )
+    {
+        throw std::runtime_error("The starting point and the bounds should be non empty lists of the same length.");
+    }
+
+    std::vector<T> extent( n );
+    for ( st j = 0; j != n; j++ )
+    {
+        extent[j] = high[j] > low[j] ? high[j] - low[j] : T( 1.0 );
+        x0[j]     = std::clamp( x0[j], low[j], high[j] );
+    }
+
+    // Regular Nelder-Mead parameters
+    const T alpha = 1.0;
+    const T beta  = 0.5;
+    const T gamma = 2.0;
+    const T sigma = 0.5;
+
+    const st simplices   = std::max( st( 1 ), options.simplices );
+    const st num_threads = std::max( st( 1 ), options.num_threads / simplices );
+
+    std::vector<std::vector<T>> starts( simplices, x0 );
+    {
+        std::mt19937 random( options.seed );
+        std::uniform_real_distribution<T> uniform;
+        for ( st s = 1; s != simplices; s++ )
+        {
+            for ( st j = 0; j != n; j++ )
+            {
+                starts[s][j] = low[j] + uniform( random ) * ( high[j] - low[j] );
+            }
         }
+    }
 
-        //  auto idx = detail::sort_indexes( func_vals );
+    std::mutex mutex;
+    std::vector<T> best_x = x0;
+    T best_value          = std::numeric_limits<T>::max();
+    std::atomic<st> evaluations{ 0 };
 
-        //   std::vector<bounds<T>> new_bounds( n );
+    auto run = [&]( st s )
+    {
+        const st thread_begin = s * num_threads;
 
+        detail::simplex_t<T> simplex( n );
+        std::vector<T> lower( n ), upper( n );
 
-        newx = (1.0/count) * newx;
-        //        for ( std::size_t i = 0 ; i !=idx.size() / 2 ; i ++)
-        //        {
-        //            for ( std::size_t j = 0 ; j != n ; j++)
-        //            {
-        //                new_bounds[j].expand( xs[idx[i]][j] );
-        //            }
-        //        }
+        // Kept for the whole run, so that an iteration starts no threads and allocates nothing
+        search::worker_pool_t pool( num_threads );
+        std::vector<std::vector<T>> points( num_threads, std::vector<T>( n ) );
 
+        // Mirrored at the faces rather than clamped, which would flatten the simplex against them
+        auto project = [&]( T *x )
+        {
+            for ( st j = 0; j != n; j++ )
+            {
+                const T mirrored = x[j] > high[j] ? 2 * high[j] - x[j] : x[j] < low[j] ? 2 * low[j] - x[j] : x[j];
+                x[j] = std::clamp( mirrored, low[j], high[j] );
+            }
+        };
 
+        auto offer = [&]()
+        {
+            const auto b = simplex.best();
+
+            std::lock_guard<std::mutex> lock( mutex );
+            if ( !( simplex.values[b] < best_value ) )
+            {
+                return;
+            }
 
-        //        for ( std::size_t i = 0; i !=idx.size() / 2; i++ )
-        //        {
-        //            std::cout << xs[idx[i]] << "aa" << std::endl;
-        //            newx = newx + (1.0/(idx.size() / 2)) * xs[idx[i]];
-        //        }
+            best_value = simplex.values[b];
+            best_x.assign( simplex.vertex( b ), simplex.vertex( b ) + n );
+
+            std::fill( lower.begin(), lower.end(), std::numeric_limits<T>::max() );
+            std::fill( upper.begin(), upper.end(), std::numeric_limits<T>::lowest() );
+            for ( st i = 0; i != n + 1; i++ )
+            {
+                for ( st j = 0; j != n; j++ )
+                {
+                    lower[j] = std::min( lower[j], simplex.vertex( i )[j] );
+                    upper[j] = std::max( upper[j], simplex.vertex( i )[j] );
+                }
+            }
 
-        auto fnewx = f(newx);
+            callback( best_x, lower, upper );
+        };
 
-        if ( fnewx < fmin )
+        // Initial simplex, its sides turned inwards at the upper bounds
+        for ( st i = 0; i != n + 1; i++ )
         {
-            x=newx;
-            fmin =fnewx;
+            std::copy( starts[s].begin(), starts[s].end(), simplex.vertex( i ) );
+            if ( i != 0 )
+            {
+                const auto j = i - 1;
+                const auto h = options.initial_size * extent[j];
+                simplex.vertex( i )[j] += starts[s][j] + h <= high[j] ? h : -h;
+                project( simplex.vertex( i ) );
+            }
         }
 
+        detail::evaluate_points( f, simplex.vertex( 0 ), n, n + 1, simplex.values.data(), pool, points, thread_begin );
+        evaluations += n + 1;
+
+        simplex.sort();
+        offer();
+
+        while ( evaluations < options.max_evaluations && !stop_requested &&
+                simplex.values[ simplex.best() ] > options.threshold )
+        {
+            const auto w = simplex.worst();
+            const T *xw  = simplex.vertex( w );
+
+            for ( st j = 0; j != n; j++ )
+            {
+                simplex.centroid[j] = ( simplex.sum[j] - xw[j] ) / T( n );
+            }
+
+            // Reflection, expansion, outside and inside contraction along the worst vertex
+            const T steps[4] = { alpha, gamma, alpha * beta, -beta };
+            for ( st t = 0; t != 4; t++ )
+            {
+                auto x = simplex.trial( t );
+                for ( st j = 0; j != n; j++ )
+                {
+                    x[j] = simplex.centroid[j] + steps[t] * ( simplex.centroid[j] - xw[j] );
+                }
+                project( x );
+            }
+
+            const bool speculative = options.speculative && num_threads > 1;
+            auto &tv = simplex.trial_values;
+
+            auto evaluate_trial = [&]( st t )
+            {
+                if ( !speculative )
+                {
+                    detail::evaluate_points( f, simplex.trial( t ), n, 1, &tv[t], pool, points, thread_begin );
+                    evaluations++;
+                }
+                return tv[t];
+            };
+
+            if ( speculative )
+            {
+                detail::evaluate_points( f, simplex.trial( 0 ), n, 4, tv.data(), pool, points, thread_begin );
+                evaluations += 4;
+            }
+
+            const T fb = simplex.values[ simplex.best() ];
+            const T fs = simplex.values[ simplex.order[ n - 1 ] ];
+            const T fw = simplex.values[w];
 
+            const T fr = evaluate_trial( 0 );
 
-        bounding_box = new_bounds;
+            bool shrink = false;
+            bool shrunk = false; // Only contractions and shrinks can bring the simplex under size_threshold
+
+            if ( fr < fb )
+            {
+                const T fe = evaluate_trial( 1 );
+                fe < fr ? simplex.replace_worst( simplex.trial( 1 ), fe ) : simplex.replace_worst( simplex.trial( 0 ), fr );
+            }
+            else if ( fr < fs )
+            {
+                simplex.replace_worst( simplex.trial( 0 ), fr );
+            }
+            else
+            {
+                // Outside contraction if the reflection improves on the worst vertex, else inside
+                const st t  = fr < fw ? 2 : 3;
+                const T  fc = evaluate_trial( t );
+
+                if ( fc < std::min( fr, fw ) )
+                {
+                    simplex.replace_worst( simplex.trial( t ), fc );
+                }
+                else
+                {
+                    shrink = true;
+                }
+                shrunk = true;
+            }
+
+            if ( shrink )
+            {
+                const auto b  = simplex.best();
+                const T   *xb = simplex.vertex( b );
+
+                // The best vertex is moved to the front, so that the others are contiguous
+                if ( b != 0 )
+                {
+                    std::swap_ranges( simplex.vertex( 0 ), simplex.vertex( 0 ) + n, simplex.vertex( b ) );
+                    std::swap( simplex.values[0], simplex.values[b] );
+                    xb = simplex.vertex( 0 );
+                }
+
+                for ( st i = 1; i != n + 1; i++ )
+                {
+                    for ( st j = 0; j != n; j++ )
+                    {
+                        simplex.vertex( i )[j] = xb[j] + sigma * ( simplex.vertex( i )[j] - xb[j] );
+                    }
+                }
+
+                detail::evaluate_points( f, simplex.vertex( 1 ), n, n, simplex.values.data() + 1, pool, points, thread_begin );
+                evaluations += n;
+
+                simplex.sort();
+            }
+
+            offer();
+
+            progress_callback( std::min( st( evaluations ), options.max_evaluations ), options.max_evaluations );
+
+            if ( shrunk && simplex.size( extent ) <= options.size_threshold )
+            {
+                break;
+            }
+        }
+    };
+
+    if ( simplices == 1 )
+    {
+        run( 0 );
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        for ( st s = 0; s != simplices; s++ )
+        {
+            threads.push_back( std::thread( run, s ) );
+        }
+
+        for ( auto &thread : threads )
+        {
+            thread.join();
+        }
     }
+
+    return best_x;
 }
 }
 
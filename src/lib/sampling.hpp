@@ -0,0 +1,369 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Samplers of the unit cube for the contraction search of cuhyso::minimize and fit. The tensor
+// grid costs subdivisions^N evaluations per round. The low discrepancy sequences cover the box
+// about as evenly with any budget, and the sparse grid keeps the structure of the grid (the corners
+// of the box, nested levels) with far fewer points.
+namespace cuhyso
+{
+
+// The adaptive grid is a tensor grid whose subdivisions per axis follow the variation of the
+// objective along the axes (fit only).
+enum class sampler_t
+{
+  grid,
+  sobol,
+  halton,
+  sparse_grid,
+  adaptive_grid
+};
+
+// Points in [ 0, 1 ]^dimensions
+using unit_points_t = std::vector< std::vector< double > >;
+
+namespace detail
+{
+
+// Primitive polynomials and initial direction numbers of Joe and Kuo for the dimensions after the
+// first, which takes the van der Corput sequence in base 2.
+struct sobol_direction_t
+{
+  unsigned                degree;
+  std::uint32_t           coefficients;
+  std::array< unsigned, 6 > initial;
+};
+
+constexpr sobol_direction_t sobol_directions[] = { { 1, 0, { 1 } },
+                                                   { 2, 1, { 1, 3 } },
+                                                   { 3, 1, { 1, 3, 1 } },
+                                                   { 3, 2, { 1, 1, 1 } },
+                                                   { 4, 1, { 1, 1, 3, 3 } },
+                                                   { 4, 4, { 1, 3, 5, 13 } },
+                                                   { 5, 2, { 1, 1, 5, 5, 17 } },
+                                                   { 5, 4, { 1, 1, 5, 5, 5 } },
+                                                   { 5, 7, { 1, 1, 7, 11, 19 } },
+                                                   { 5, 11, { 1, 1, 5, 1, 1 } },
+                                                   { 5, 13, { 1, 1, 1, 3, 11 } },
+                                                   { 5, 14, { 1, 3, 5, 5, 31 } },
+                                                   { 6, 1, { 1, 3, 3, 9, 7, 49 } },
+                                                   { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+                                                   { 6, 16, { 1, 3, 1, 13, 27, 49 } } };
+
+constexpr std::size_t sobol_max_dimensions = 1 + std::size( sobol_directions );
+
+constexpr unsigned sobol_bits = 32;
+
+// Direction numbers v_k = m_k 2^( 32 - k ) of one dimension
+inline std::array< std::uint32_t, sobol_bits > sobol_direction_numbers( std::size_t dimension )
+{
+  std::array< std::uint32_t, sobol_bits > v;
+
+  if ( dimension == 0 )
+  {
+    for ( unsigned k = 0; k != sobol_bits; k++ )
+    {
+      v[ k ] = std::uint32_t( 1 ) << ( sobol_bits - 1 - k );
+    }
+    return v;
+  }
+
+  const auto& direction = sobol_directions[ dimension - 1 ];
+  const auto  s         = direction.degree;
+
+  for ( unsigned k = 0; k != s; k++ )
+  {
+    v[ k ] = std::uint32_t( direction.initial[ k ] ) << ( sobol_bits - 1 - k );
+  }
+
+  for ( unsigned k = s; k != sobol_bits; k++ )
+  {
+    v[ k ] = v[ k - s ] ^ ( v[ k - s ] >> s );
+
+    for ( unsigned j = 1; j != s; j++ )
+    {
+      if ( ( direction.coefficients >> ( s - 1 - j ) ) & 1 )
+      {
+        v[ k ] ^= v[ k - j ];
+      }
+    }
+  }
+
+  return v;
+}
+
+inline std::vector< unsigned > first_primes( std::size_t count )
+{
+  std::vector< unsigned > primes;
+
+  for ( unsigned n = 2; primes.size( ) != count; n++ )
+  {
+    bool prime = true;
+    for ( auto p : primes )
+    {
+      if ( p * p > n )
+      {
+        break;
+      }
+      if ( n % p == 0 )
+      {
+        prime = false;
+        break;
+      }
+    }
+
+    if ( prime )
+    {
+      primes.push_back( n );
+    }
+  }
+
+  return primes;
+}
+
+// Nested one dimensional points of level l of the sparse grid, without those of the lower levels:
+// 1 / 2, then 0 and 1, then the odd multiples of 2^-l.
+inline std::vector< double > sparse_grid_level( std::size_t level )
+{
+  if ( level == 0 )
+  {
+    return { 0.5 };
+  }
+
+  if ( level == 1 )
+  {
+    return { 0.0, 1.0 };
+  }
+
+  std::vector< double > points;
+
+  const double h = std::ldexp( 1.0, -int( level ) );
+  for ( std::size_t k = 1; k < ( std::size_t( 1 ) << level ); k += 2 )
+  {
+    points.push_back( k * h );
+  }
+
+  return points;
+}
+
+inline void append_sparse_grid( std::size_t           dimensions,
+                                std::size_t           level,
+                                std::vector< double > upstream,
+                                unit_points_t&        points )
+{
+  if ( upstream.size( ) == dimensions )
+  {
+    points.push_back( upstream );
+    return;
+  }
+
+  for ( std::size_t l = 0; l <= level; l++ )
+  {
+    for ( auto x : sparse_grid_level( l ) )
+    {
+      upstream.push_back( x );
+      append_sparse_grid( dimensions, level - l, upstream, points );
+      upstream.pop_back( );
+    }
+  }
+}
+
+} // namespace detail
+
+// Sobol points with a random digital shift drawn from seed. Every 2^m consecutive points from the
+// start stratify each axis in 2^m intervals. Up to detail::sobol_max_dimensions dimensions.
+inline unit_points_t sobol_points( std::size_t dimensions, std::size_t count, unsigned seed = 0 )
+{
+  if ( dimensions > detail::sobol_max_dimensions )
+  {
+    throw std::runtime_error( "Sobol sampling supports up to "
+                              + std::to_string( detail::sobol_max_dimensions )
+                              + " parameters." );
+  }
+
+  std::mt19937 generator( seed );
+
+  std::vector< std::array< std::uint32_t, detail::sobol_bits > > directions;
+  std::vector< std::uint32_t >                                   state;
+
+  for ( std::size_t d = 0; d != dimensions; d++ )
+  {
+    directions.push_back( detail::sobol_direction_numbers( d ) );
+    state.push_back( seed == 0 ? 0 : std::uint32_t( generator( ) ) );
+  }
+
+  unit_points_t points( count, std::vector< double >( dimensions ) );
+
+  // Gray code order, point i + 1 differs from point i by the direction number of the lowest zero
+  // bit of i
+  for ( std::size_t i = 0; i != count; i++ )
+  {
+    for ( std::size_t d = 0; d != dimensions; d++ )
+    {
+      points[ i ][ d ] = std::ldexp( double( state[ d ] ), -int( detail::sobol_bits ) );
+    }
+
+    unsigned c = 0;
+    for ( auto n = i; n & 1; n >>= 1 )
+    {
+      c++;
+    }
+
+    for ( std::size_t d = 0; d != dimensions; d++ )
+    {
+      state[ d ] ^= directions[ d ][ c ];
+    }
+  }
+
+  return points;
+}
+
+// Halton points, radical inverses in the first primes. A nonzero seed scrambles the digits of each
+// base with a random permutation that keeps zero, which breaks the correlations between the axes
+// of large bases.
+inline unit_points_t halton_points( std::size_t dimensions, std::size_t count, unsigned seed = 0 )
+{
+  const auto bases = detail::first_primes( dimensions );
+
+  std::mt19937 generator( seed );
+
+  std::vector< std::vector< unsigned > > permutations;
+  for ( auto base : bases )
+  {
+    std::vector< unsigned > permutation( base );
+    std::iota( permutation.begin( ), permutation.end( ), 0 );
+
+    if ( seed != 0 )
+    {
+      std::shuffle( permutation.begin( ) + 1, permutation.end( ), generator );
+    }
+
+    permutations.push_back( permutation );
+  }
+
+  unit_points_t points( count, std::vector< double >( dimensions ) );
+
+  for ( std::size_t i = 0; i != count; i++ )
+  {
+    for ( std::size_t d = 0; d != dimensions; d++ )
+    {
+      const double inverse_base = 1.0 / bases[ d ];
+
+      double x      = 0.0;
+      double factor = inverse_base;
+
+      // Index 0 would be the origin for every seed
+      for ( auto n = i + 1; n != 0; n /= bases[ d ] )
+      {
+        x += permutations[ d ][ n % bases[ d ] ] * factor;
+        factor *= inverse_base;
+      }
+
+      points[ i ][ d ] = x;
+    }
+  }
+
+  return points;
+}
+
+// Smolyak sparse grid of the nested levels of detail::sparse_grid_level, the points whose levels
+// add up to at most level. In 4 dimensions levels 0 to 6 have 1, 9, 41, 137, 401, 1105 and 2929
+// points, against 3^4, 5^4, 9^4, ... for the tensor grids with the same points per axis.
+inline unit_points_t sparse_grid_points( std::size_t dimensions, std::size_t level )
+{
+  unit_points_t points;
+  detail::append_sparse_grid( dimensions, level, { }, points );
+
+  return points;
+}
+
+// At most budget points, but at least one, by any sampler but the grid. The sparse grid takes the
+// highest level within the budget. seed is the round of the search, so that the scrambling of the
+// sequences changes from round to round.
+inline unit_points_t sample_unit_cube( sampler_t   sampler,
+                                       std::size_t dimensions,
+                                       std::size_t budget,
+                                       unsigned    seed )
+{
+  budget = std::max( budget, std::size_t( 1 ) );
+
+  switch ( sampler )
+  {
+  case sampler_t::sobol:
+    return sobol_points( dimensions, budget, seed + 1 );
+  case sampler_t::halton:
+    return halton_points( dimensions, budget, seed + 1 );
+  case sampler_t::sparse_grid:
+  {
+    auto points = sparse_grid_points( dimensions, 0 );
+    for ( std::size_t level = 1;; level++ )
+    {
+      auto finer = sparse_grid_points( dimensions, level );
+      if ( finer.size( ) > budget )
+      {
+        break;
+      }
+      points = std::move( finer );
+    }
+    return points;
+  }
+  case sampler_t::grid:
+  case sampler_t::adaptive_grid:
+    break;
+  }
+
+  throw std::runtime_error( "The grids are sampled by the subdivisions of the search." );
+}
+
+} // namespace cuhyso
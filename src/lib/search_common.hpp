@@ -0,0 +1,270 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Pieces shared by the box constrained searches of cmaes.hpp, differential_evolution.hpp,
+// surrogate.hpp and nelder_mead.hpp.
+namespace search
+{
+
+// Receives each new minimum and a box around it
+template< class T >
+using callback_t = std::function< void( std::vector< T >, std::vector< T >, std::vector< T > ) >;
+
+// Receives the evaluations so far and the budget of them
+using progress_callback_t = std::function< void( std::size_t, std::size_t ) >;
+
+// Map of the unit cube onto the box [ low, high ], linearly or, for the dimensions with log_scale
+// set, logarithmically.
+template< class T >
+struct unit_box_t
+{
+  unit_box_t( const std::vector< T >& low, const std::vector< T >& high, std::vector< bool > log )
+    : log_scale( std::move( log ) )
+  {
+    const auto n = low.size( );
+
+    if ( n == 0 || high.size( ) != n )
+    {
+      throw std::runtime_error(
+        "The lower and upper bounds should be non empty lists of the same length." );
+    }
+
+    log_scale.resize( n, false );
+
+    origin.resize( n );
+    extent.resize( n );
+    for ( std::size_t i = 0; i != n; i++ )
+    {
+      if ( log_scale[ i ] && !( low[ i ] > 0 && high[ i ] > 0 ) )
+      {
+        throw std::runtime_error( "Log scaled dimensions need positive bounds." );
+      }
+
+      origin[ i ] = log_scale[ i ] ? std::log( low[ i ] ) : low[ i ];
+      extent[ i ] = ( log_scale[ i ] ? std::log( high[ i ] ) : high[ i ] ) - origin[ i ];
+    }
+  }
+
+  std::size_t size( ) const
+  {
+    return origin.size( );
+  }
+
+  // The point of the box at u of the unit cube, whose coordinates convert to T
+  template< class U >
+  std::vector< T > operator( )( const U& u ) const
+  {
+    std::vector< T > x( origin.size( ) );
+    for ( std::size_t i = 0; i != x.size( ); i++ )
+    {
+      x[ i ] = origin[ i ] + T( u[ i ] ) * extent[ i ];
+      if ( log_scale[ i ] )
+      {
+        x[ i ] = std::exp( x[ i ] );
+      }
+    }
+    return x;
+  }
+
+  std::vector< bool > log_scale;
+  std::vector< T >    origin;
+  std::vector< T >    extent;
+};
+
+// Runs f( i, thread ) for i in [ 0, count ) on up to num_threads threads, which take every
+// num_threads-th i
+template< class F >
+void parallel_for( std::size_t count, std::size_t num_threads, F&& f )
+{
+  if ( count == 0 )
+  {
+    return;
+  }
+
+  num_threads = std::max( std::size_t( 1 ), std::min( num_threads, count ) );
+
+  std::vector< std::thread > threads;
+  for ( std::size_t tid = 0; tid != num_threads; tid++ )
+  {
+    threads.push_back( std::thread( [ &f, count, num_threads, tid ]( ) {
+      for ( auto i = tid; i < count; i += num_threads )
+      {
+        f( i, tid );
+      }
+    } ) );
+  }
+
+  for ( auto& thread : threads )
+  {
+    thread.join( );
+  }
+}
+
+// Threads kept for many small batches, where starting threads for each would cost more than the
+// batch. run( count, f ) calls f( i, thread ) for i in [ 0, count ), on the calling thread as
+// thread 0 and on the workers, and returns once all are done. Nothing is allocated per batch.
+class worker_pool_t
+{
+public:
+  explicit worker_pool_t( std::size_t num_threads )
+  {
+    for ( std::size_t tid = 1; tid < num_threads; tid++ )
+    {
+      workers_.push_back( std::thread( [ this, tid ]( ) { work( tid ); } ) );
+    }
+  }
+
+  worker_pool_t( const worker_pool_t& ) = delete;
+  worker_pool_t& operator=( const worker_pool_t& ) = delete;
+
+  ~worker_pool_t( )
+  {
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      quit_ = true;
+    }
+    wake_.notify_all( );
+
+    for ( auto& worker : workers_ )
+    {
+      worker.join( );
+    }
+  }
+
+  std::size_t size( ) const
+  {
+    return workers_.size( ) + 1;
+  }
+
+  template< class F >
+  void run( std::size_t count, F& f )
+  {
+    if ( workers_.empty( ) || count < 2 )
+    {
+      for ( std::size_t i = 0; i != count; i++ )
+      {
+        f( i, 0 );
+      }
+      return;
+    }
+
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      task_ = []( void* task, std::size_t i, std::size_t tid ) {
+        ( *static_cast< F* >( task ) )( i, tid );
+      };
+      context_ = &f;
+      count_   = count;
+      next_    = 0;
+      pending_ = workers_.size( );
+      batch_++;
+    }
+    wake_.notify_all( );
+
+    drain( 0 );
+
+    std::unique_lock< std::mutex > lock( mutex_ );
+    done_.wait( lock, [ this ] { return pending_ == 0; } );
+  }
+
+private:
+  void drain( std::size_t tid )
+  {
+    for ( auto i = next_++; i < count_; i = next_++ )
+    {
+      task_( context_, i, tid );
+    }
+  }
+
+  void work( std::size_t tid )
+  {
+    for ( std::size_t seen = 0;; )
+    {
+      {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        wake_.wait( lock, [ & ] { return quit_ || batch_ != seen; } );
+        if ( quit_ )
+        {
+          return;
+        }
+        seen = batch_;
+      }
+
+      drain( tid );
+
+      std::lock_guard< std::mutex > lock( mutex_ );
+      if ( --pending_ == 0 )
+      {
+        done_.notify_one( );
+      }
+    }
+  }
+
+  std::vector< std::thread > workers_;
+
+  std::mutex              mutex_;
+  std::condition_variable wake_, done_;
+  bool                    quit_    = false;
+  std::size_t             batch_   = 0;
+  std::size_t             pending_ = 0;
+
+  // The batch, set under the lock before the workers are woken
+  using task_t = void ( * )( void*, std::size_t, std::size_t );
+
+  task_t                     task_    = nullptr;
+  void*                      context_ = nullptr;
+  std::size_t                count_   = 0;
+  std::atomic< std::size_t > next_ { 0 };
+};
+
+} // namespace search
@@ -0,0 +1,518 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#pragma once
+
+#include "sampling.hpp"
+#include "search_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Surrogate assisted minimization for expensive objectives. A Gaussian process with a Matern 5/2
+// kernel is fitted to the logarithm of the best evaluated values, and each batch of candidates in a
+// trust region around the best point maximizes the expected improvement, one after the other with
+// the previous ones believed at their predicted values (kriging believer), so that the batch is
+// evaluated in parallel. The trust region grows after successful batches, shrinks after failed
+// ones and restarts from its initial size once it has collapsed.
+namespace surrogate
+{
+
+template< class T = double >
+struct options_t
+{
+  std::size_t max_evaluations = 2000;
+  std::size_t initial_points  = 0; // Sobol points of the initial design, 10 dimensions if 0
+  std::size_t batch_size      = 0; // max( 4, num_threads ) if 0
+  std::size_t max_training    = 100; // Best points the process is fitted to
+  std::size_t candidates      = 1000; // Among which each batch maximizes the expected improvement
+  T           initial_trust   = 0.8; // Side of the trust region, relative to the box
+  T           min_trust       = 1e-4;
+  std::size_t num_threads     = std::max( 1u, std::thread::hardware_concurrency( ) );
+  unsigned    seed            = 1;
+};
+
+using search::callback_t;
+using search::progress_callback_t;
+
+namespace detail
+{
+
+template< class T >
+using points_t = std::vector< std::vector< T > >;
+
+template< class T >
+T matern52( const std::vector< T >& a, const std::vector< T >& b, const T& length_scale )
+{
+  T r2 = 0.0;
+  for ( std::size_t i = 0; i != a.size( ); i++ )
+  {
+    r2 += ( a[ i ] - b[ i ] ) * ( a[ i ] - b[ i ] );
+  }
+
+  const T r = std::sqrt( 5.0 * r2 ) / length_scale;
+
+  return ( 1.0 + r + r * r / 3.0 ) * std::exp( -r );
+}
+
+// Lower triangular L with L L^T = K, in place. Returns false if K is not positive definite.
+template< class T >
+bool cholesky( std::vector< T >& K, std::size_t n )
+{
+  for ( std::size_t j = 0; j != n; j++ )
+  {
+    T d = K[ j * n + j ];
+    for ( std::size_t k = 0; k != j; k++ )
+    {
+      d -= K[ j * n + k ] * K[ j * n + k ];
+    }
+
+    if ( !( d > 0 ) )
+    {
+      return false;
+    }
+
+    K[ j * n + j ] = std::sqrt( d );
+
+    for ( std::size_t i = j + 1; i != n; i++ )
+    {
+      T s = K[ i * n + j ];
+      for ( std::size_t k = 0; k != j; k++ )
+      {
+        s -= K[ i * n + k ] * K[ j * n + k ];
+      }
+      K[ i * n + j ] = s / K[ j * n + j ];
+    }
+  }
+
+  return true;
+}
+
+// Solves L x = b in place
+template< class T >
+void forward_substitute( const std::vector< T >& L, std::size_t n, std::vector< T >& b )
+{
+  for ( std::size_t i = 0; i != n; i++ )
+  {
+    for ( std::size_t k = 0; k != i; k++ )
+    {
+      b[ i ] -= L[ i * n + k ] * b[ k ];
+    }
+    b[ i ] /= L[ i * n + i ];
+  }
+}
+
+// Solves L^T x = b in place
+template< class T >
+void backward_substitute( const std::vector< T >& L, std::size_t n, std::vector< T >& b )
+{
+  for ( std::size_t i = n; i-- != 0; )
+  {
+    for ( std::size_t k = i + 1; k != n; k++ )
+    {
+      b[ i ] -= L[ k * n + i ] * b[ k ];
+    }
+    b[ i ] /= L[ i * n + i ];
+  }
+}
+
+// Gaussian process of standardized values, its length scale chosen among a geometric sequence by
+// the marginal likelihood and its signal variance by the closed form of its maximum
+template< class T >
+struct process_t
+{
+  points_t< T >    x;
+  std::vector< T > L;
+  std::vector< T > alpha; // K^-1 y
+  T                length_scale = 0.2;
+  T                mean         = 0.0;
+  T                deviation    = 1.0;
+  T                variance     = 1.0;
+
+  static constexpr T nugget = 1.0e-6;
+
+  // False if the kernel matrix is singular at every length scale
+  bool fit( const points_t< T >& points, const std::vector< T >& values )
+  {
+    x = points;
+    L.clear( );
+
+    const auto n = x.size( );
+
+    mean = std::accumulate( values.begin( ), values.end( ), T( 0.0 ) ) / n;
+
+    T sum2 = 0.0;
+    for ( const auto& v : values )
+    {
+      sum2 += ( v - mean ) * ( v - mean );
+    }
+    deviation = std::sqrt( sum2 / n ) > 0 ? std::sqrt( sum2 / n ) : T( 1.0 );
+
+    std::vector< T > y( n );
+    for ( std::size_t i = 0; i != n; i++ )
+    {
+      y[ i ] = ( values[ i ] - mean ) / deviation;
+    }
+
+    T best_likelihood = -std::numeric_limits< T >::max( );
+
+    for ( T ell : { 0.02, 0.04, 0.08, 0.15, 0.3, 0.6, 1.2 } )
+    {
+      std::vector< T > K( n * n );
+      for ( std::size_t i = 0; i != n; i++ )
+      {
+        for ( std::size_t j = 0; j <= i; j++ )
+        {
+          K[ i * n + j ] = matern52( x[ i ], x[ j ], ell ) + ( i == j ? nugget : 0.0 );
+        }
+      }
+
+      if ( !cholesky( K, n ) )
+      {
+        continue;
+      }
+
+      auto a = y;
+      forward_substitute( K, n, a );
+
+      T quadratic = 0.0, log_det = 0.0;
+      for ( std::size_t i = 0; i != n; i++ )
+      {
+        quadratic += a[ i ] * a[ i ];
+        log_det += 2.0 * std::log( K[ i * n + i ] );
+      }
+
+      const T signal_variance = std::max( quadratic / n, T( 1.0e-12 ) );
+      const T likelihood      = -0.5 * ( n * std::log( signal_variance ) + log_det );
+
+      if ( likelihood > best_likelihood )
+      {
+        best_likelihood = likelihood;
+        length_scale    = ell;
+        variance        = signal_variance;
+        L               = K;
+
+        backward_substitute( L, n, a );
+        alpha = a;
+      }
+    }
+
+    return !L.empty( );
+  }
+
+  // k( point, x_i ) of the fitted points
+  std::vector< T > kernel_vector( const std::vector< T >& point ) const
+  {
+    std::vector< T > v( x.size( ) );
+    for ( std::size_t i = 0; i != x.size( ); i++ )
+    {
+      v[ i ] = matern52( point, x[ i ], length_scale );
+    }
+
+    return v;
+  }
+};
+
+inline double normal_pdf( double z ) { return 0.3989422804014327 * std::exp( -0.5 * z * z ); }
+
+inline double normal_cdf( double z ) { return 0.5 * std::erfc( -z * 0.7071067811865476 ); }
+
+// Expected improvement below best of a prediction of mean mu and deviation sigma
+template< class T >
+T expected_improvement( const T& mu, const T& sigma, const T& best )
+{
+  if ( !( sigma > 0 ) )
+  {
+    return std::max( best - mu, T( 0.0 ) );
+  }
+
+  const T z = ( best - mu ) / sigma;
+
+  return ( best - mu ) * normal_cdf( z ) + sigma * normal_pdf( z );
+}
+
+} // namespace detail
+
+// Minimizes f over the box [ low, high ] within max_evaluations. Dimensions with log_scale set are
+// searched in the logarithm of x, which then must be positive. f( x, thread ) is called from
+// num_threads threads at once with the index of the calling thread. callback receives each new
+// minimum and the bounding box of the points the process is fitted to, progress_callback the
+// evaluations so far and the budget of them.
+template< class T, class F, class Stop = bool >
+std::vector< T > minimize(
+  F&&                 f,
+  std::vector< T >    low,
+  std::vector< T >    high,
+  std::vector< bool > log_scale = { },
+  options_t< T >      options   = options_t< T > { },
+  callback_t< T >     callback  = []( std::vector< T >, std::vector< T >, std::vector< T > ) {},
+  progress_callback_t progress_callback = []( std::size_t, std::size_t ) {},
+  const Stop&         stop_requested    = false )
+{
+  using st = std::size_t;
+
+  const search::unit_box_t< T > to_box( low, high, std::move( log_scale ) );
+
+  const st n = to_box.size( );
+
+  if ( options.max_evaluations == 0 )
+  {
+    throw std::runtime_error( "The surrogate search needs a positive number of evaluations." );
+  }
+
+  // The process is computed in double whatever T
+  using R = double;
+
+  const st num_threads = std::max( st( 1 ), options.num_threads );
+  const st batch_size
+    = options.batch_size > 0 ? options.batch_size : std::max( st( 4 ), num_threads );
+
+  // Evaluated points in the unit cube and their values
+  detail::points_t< R > points;
+  std::vector< R >      values;
+  st                    best = 0;
+
+  auto evaluate = [ & ]( const detail::points_t< R >& batch ) {
+    std::vector< R > batch_values( batch.size( ) );
+
+    search::parallel_for( batch.size( ), num_threads, [ & ]( st i, st tid ) {
+      batch_values[ i ] = R( f( to_box( batch[ i ] ), tid ) );
+    } );
+
+    points.insert( points.end( ), batch.begin( ), batch.end( ) );
+    values.insert( values.end( ), batch_values.begin( ), batch_values.end( ) );
+  };
+
+  std::mt19937                        random( options.seed );
+  std::uniform_real_distribution< R > uniform;
+
+  {
+    const st initial = std::min( options.max_evaluations,
+                                 options.initial_points > 0 ? options.initial_points : 10 * n );
+
+    detail::points_t< R > design;
+    for ( const auto& p : cuhyso::sobol_points( n, initial, options.seed ) )
+    {
+      design.emplace_back( p.begin( ), p.end( ) );
+    }
+
+    evaluate( design );
+  }
+
+  detail::process_t< R > process;
+
+  R  reported  = std::numeric_limits< R >::max( );
+  R  trust     = R( options.initial_trust );
+  st successes = 0, failures = 0;
+
+  while ( points.size( ) < options.max_evaluations && !stop_requested )
+  {
+    // The best points, to which the process is fitted
+    std::vector< st > order( points.size( ) );
+    std::iota( order.begin( ), order.end( ), 0 );
+    std::stable_sort(
+      order.begin( ), order.end( ), [ & ]( st a, st b ) { return values[ a ] < values[ b ]; } );
+
+    best = order[ 0 ];
+
+    const st m = std::min( options.max_training, order.size( ) );
+
+    detail::points_t< R > training;
+    std::vector< R >      training_values;
+    for ( st k = 0; k != m; k++ )
+    {
+      training.push_back( points[ order[ k ] ] );
+      training_values.push_back( values[ order[ k ] ] );
+    }
+
+    std::vector< R > lower( n ), upper( n );
+    for ( st j = 0; j != n; j++ )
+    {
+      lower[ j ] = std::max( points[ best ][ j ] - trust / 2, R( 0.0 ) );
+      upper[ j ] = std::min( points[ best ][ j ] + trust / 2, R( 1.0 ) );
+    }
+
+    if ( values[ best ] < reported )
+    {
+      reported = values[ best ];
+
+      callback( to_box( points[ best ] ), to_box( lower ), to_box( upper ) );
+    }
+
+    // The values span orders of magnitude near a minimum, their logarithm is smoother; the offset
+    // keeps the best one finite
+    {
+      const R lowest = training_values[ 0 ];
+      const R offset
+        = std::max( R( 0.01 ) * ( training_values[ m / 2 ] - lowest ), R( 1.0e-300 ) );
+
+      for ( auto& y : training_values )
+      {
+        y = std::log( y - lowest + offset );
+      }
+    }
+
+    const bool fitted = process.fit( training, training_values );
+
+    // Candidates in the trust region, those beyond the box clamped onto its faces where the
+    // minimum often is
+    const st count = options.candidates;
+
+    detail::points_t< R > candidates( count, std::vector< R >( n ) );
+    for ( auto& candidate : candidates )
+    {
+      for ( st j = 0; j != n; j++ )
+      {
+        candidate[ j ] = std::clamp(
+          points[ best ][ j ] + trust * ( uniform( random ) - 0.5 ), R( 0.0 ), R( 1.0 ) );
+      }
+    }
+
+    // Predictions of the candidates, relative to the signal variance: v = L^-1 k, mean k^T alpha,
+    // covariance k( a, b ) - v_a^T v_b. Without a process the prior spreads the batch.
+    detail::points_t< R > v( count );
+    std::vector< R >      mu( count, 0.0 ), var( count, 1.0 );
+    search::parallel_for( fitted ? count : 0, num_threads, [ & ]( st c, st ) {
+      auto& vc = v[ c ];
+
+      vc = process.kernel_vector( candidates[ c ] );
+
+      mu[ c ] = std::inner_product( vc.begin( ), vc.end( ), process.alpha.begin( ), R( 0.0 ) );
+
+      detail::forward_substitute( process.L, m, vc );
+
+      var[ c ] = 1.0 + process.nugget
+                 - std::inner_product( vc.begin( ), vc.end( ), vc.begin( ), R( 0.0 ) );
+    } );
+
+    const R incumbent = ( training_values[ 0 ] - process.mean ) / process.deviation;
+
+    // Kriging believer: each chosen candidate is believed at its mean, which leaves the means and
+    // lowers the variances by the covariances with it
+    const st q = std::min( batch_size, options.max_evaluations - points.size( ) );
+
+    detail::points_t< R >           batch;
+    std::vector< std::vector< R > > covariances; // With each chosen one, given the previous ones
+    std::vector< st >               chosen;
+
+    for ( st b = 0; b != q; b++ )
+    {
+      st next    = count;
+      R  best_ei = -1.0;
+      for ( st c = 0; c != count; c++ )
+      {
+        const R sigma = std::sqrt( std::max( var[ c ], R( 0.0 ) ) * process.variance );
+        const R ei    = detail::expected_improvement( mu[ c ], sigma, incumbent );
+
+        if ( ei > best_ei && std::find( chosen.begin( ), chosen.end( ), c ) == chosen.end( ) )
+        {
+          best_ei = ei;
+          next    = c;
+        }
+      }
+
+      chosen.push_back( next );
+      batch.push_back( candidates[ next ] );
+
+      std::vector< R > covariance( count );
+      for ( st c = 0; c != count; c++ )
+      {
+        covariance[ c ]
+          = detail::matern52( candidates[ c ], candidates[ next ], process.length_scale )
+            - std::inner_product( v[ c ].begin( ), v[ c ].end( ), v[ next ].begin( ), R( 0.0 ) );
+
+        for ( st k = 0; k != covariances.size( ); k++ )
+        {
+          covariance[ c ] -= covariances[ k ][ c ] * covariances[ k ][ next ];
+        }
+      }
+
+      const R scale = std::sqrt( std::max( covariance[ next ], R( 1.0e-12 ) ) );
+      for ( st c = 0; c != count; c++ )
+      {
+        covariance[ c ] /= scale;
+        var[ c ] -= covariance[ c ] * covariance[ c ];
+      }
+
+      covariances.push_back( std::move( covariance ) );
+    }
+
+    const R before = values[ best ];
+
+    evaluate( batch );
+
+    if ( *std::min_element( values.end( ) - batch.size( ), values.end( ) )
+         < before - 1.0e-3 * std::fabs( before ) )
+    {
+      failures = 0;
+      if ( ++successes == 3 )
+      {
+        trust     = std::min( 2 * trust, R( options.initial_trust ) );
+        successes = 0;
+      }
+    }
+    else
+    {
+      successes = 0;
+      if ( ++failures == std::max( st( 2 ), n / batch.size( ) ) )
+      {
+        trust    = trust / 2 < R( options.min_trust ) ? R( options.initial_trust ) : trust / 2;
+        failures = 0;
+      }
+    }
+
+    progress_callback( std::min( points.size( ), options.max_evaluations ),
+                       options.max_evaluations );
+  }
+
+  best = std::min_element( values.begin( ), values.end( ) ) - values.begin( );
+
+  return to_box( points[ best ] );
+}
+
+} // namespace surrogate
@@ -61,7 +61,7 @@ void test_nelder_mead( TestSet_t& test_set )
 {
   using namespace crack_growth::Hartman_Schijve;
 
-  auto obj = [ &test_set ]( std::array< real_t, 4 > vals ) {
+  auto obj = [ &test_set ]( const std::vector< real_t >& vals, std::size_t ) {
     parameters< real_t > params;
     params.D          = vals[ 0 ];
     params.p          = vals[ 1 ];
@@ -72,26 +72,19 @@ void test_nelder_mead( TestSet_t& test_set )
     return d.distance;
   };
 
-  nelder_mead::iteration_callback_t< real_t, 4 > callback
-    = []( std::array< real_t, 5 >                  func_val,
-          std::array< std::array< real_t, 4 >, 5 > vertices,
-          nelder_mead::step_kind_t                 step_kind ) {
-        spdlog::info( "fmin:{}, D:{} , p: {}, DeltaK_thr: {}, A: {} | Kind: {}",
-                      func_val[ 0 ],
-                      vertices[ 0 ][ 0 ],
-                      vertices[ 0 ][ 1 ],
-                      vertices[ 0 ][ 2 ],
-                      vertices[ 0 ][ 3 ],
-                      nelder_mead::to_string( step_kind ) );
+  nelder_mead::search_callback_t< real_t > callback
+    = []( std::vector< real_t > x, std::vector< real_t >, std::vector< real_t > ) {
+        spdlog::info( "D:{} , p: {}, DeltaK_thr: {}, A: {}", x[ 0 ], x[ 1 ], x[ 2 ], x[ 3 ] );
       };
 
-  auto options           = nelder_mead::options_t< real_t >( );
+  auto options           = nelder_mead::simplex_options_t< real_t >( );
   options.size_threshold = 1e-5;
 
-  std::array< real_t, 4 > x0      = { 2.0e-10, 2.0, 2.5, 100.0 };
-  std::array< real_t, 4 > Deltax0 = { 0.1e-10, 0.1, 0.2, 20.0 };
+  std::vector< real_t > x0   = { 2.0e-10, 2.0, 2.5, 100.0 };
+  std::vector< real_t > low  = { 1.0e-10, 1.7, 0.0001, 50.0 };
+  std::vector< real_t > high = { 5.0e-10, 2.3, 5.0, 450.0 };
 
-  nelder_mead::searchmin( obj, x0, Deltax0, callback, options );
+  nelder_mead::minimize< real_t >( obj, x0, low, high, options, callback );
 }
 
 double      fmin1 = 1e10;
@@ -1,8 +1,8 @@
 #include "nelder_mead.hpp"
 
 #include <spdlog/spdlog.h>
-#include <nlopt.hpp>
 
+#include <atomic>
 #include <vector>
 
 #define SCALE 1
@@ -14,14 +14,7 @@ double rosenbrock( double x, double y )
     return pow( 1.0 - SCALE*x, 2 ) + 100.0 * pow( y - pow( SCALE*x, 2 ), 2 );
 }
 
-int count =0;
-
-double f_wrapper(const std::vector<double> &x, std::vector<double> &, void* )
-{
-    count ++;
-    auto fv = rosenbrock( x[0], x[1] );
-    return fv;
-}
+std::atomic<int> count{ 0 };
 
 
 int main()
@@ -56,46 +49,49 @@ int main()
     }
 
 
-//    auto res2 = nelder_mead::search<double>(
-//                [](auto x)
-//    {
-//        return rosenbrock( x[0],x[1] );
-//    },
-//    {1.0,0.0},
-//    {-2.0,-2.0},
-//    {2.0,2.0}
-//    );
+    nelder_mead::direct_options_t<double> direct_options;
+    direct_options.max_evaluations  = 5000;
+    direct_options.size_threshold   = 1e-5;
 
-    try
+    auto res2 = nelder_mead::search<double>(
+                [](const std::vector<double> &x, std::size_t )
     {
-        nlopt::opt opt( nlopt::GN_ORIG_DIRECT_L, 2 );
-
-        opt.set_lower_bounds( {-2.0, -2.0} );
-        opt.set_upper_bounds( { 2.0, 2.0} );
-        opt.set_min_objective( f_wrapper, nullptr );
-        opt.set_maxeval( 5000 );
-
-        opt.set_xtol_rel( 1.0e-5);
+        count++;
+        return rosenbrock( x[0], x[1] );
+    },
+    {-2.0,-2.0},
+    { 2.0, 2.0},
+    direct_options );
 
-        info( "nlopt algorithm: {}. Number of dimensions: {}",
-                      opt.get_algorithm_name(),
-                      opt.get_dimension());
+    info("DIRECT-L x: {} {}, fmin: {}, evaluations: {}", res2[0], res2[1], rosenbrock( res2[0], res2[1] ), count );
 
-        std::vector<double> x_optim( opt.get_dimension() );
-        double f_optim;
-        auto res = opt.optimize( x_optim, f_optim );
 
-        info("optim x: {} {}, fmin: {}, iterations: {}", x_optim[0], x_optim[1], f_optim, count );
+    // Bounded, with the minimum of the box on its upper face in x, from several simplices at once
+    nelder_mead::simplex_options_t<double> simplex_options;
+    simplex_options.simplices   = 4;
+    simplex_options.num_threads = 8;
 
-    }
-    catch ( const std::exception &e )
+    count = 0;
+    auto res3 = nelder_mead::minimize<double>(
+                [](const std::vector<double> &x, std::size_t )
     {
-        std::cout << e.what() << std::endl;
-    }
+        count++;
+        return rosenbrock( x[0], x[1] );
+    },
+    { -1.5, 1.5 },
+    { -2.0, -2.0 },
+    {  0.5,  2.0 },
+    simplex_options );
+
+    info("Bounded Nelder-Mead x: {} {}, fmin: {}, evaluations: {}", res3[0], res3[1], rosenbrock( res3[0], res3[1] ), count );
 
     if ( std::abs( res[0] - 1.0 ) < options.size_threshold &&
-         std::abs( res[0] - 1.0 ) < options.size_threshold )
+         std::abs( res[1] - 1.0 ) < options.size_threshold &&
+         rosenbrock( res2[0], res2[1] ) < 1e-4 &&
+         std::abs( res3[0] - 0.5 ) < 1e-6 && std::abs( res3[1] - 0.25 ) < 1e-6 )
     {
         return 0;
     }
+
+    return 1;
 }
@@ -0,0 +1,467 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using real_t      = long double;
+using test_data_t = crack_growth::test_data_t< real_t >;
+using test_set_t  = std::vector< test_data_t >;
+
+constexpr real_t tD     = 3.9e-10;
+constexpr real_t tp     = 2.29;
+constexpr real_t tDKThr = 3.04;
+constexpr real_t tA     = 116.81;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+template< class T >
+std::vector< T > generate_sequence( T from, T to, std::size_t count )
+{
+  std::vector< T > seq;
+
+  T step = ( to - from ) / ( count - 1 );
+
+  for ( std::size_t i = 0; i != count; i++ )
+  {
+    seq.push_back( from + step * i );
+  }
+
+  return seq;
+}
+
+void append_synthetic_test( test_set_t& test_set, real_t R, std::size_t num_data_points = 50 )
+{
+  auto params     = hs::parameters< real_t > { tD, tp, tDKThr, tA };
+  auto DeltaK_max = hs::calc_K_max( params, R );
+
+  auto DKs = generate_sequence(
+    params.DeltaK_thr * real_t( 1.01 ), DeltaK_max * real_t( 0.99 ), num_data_points );
+
+  test_data_t test_data;
+  test_data.R = R;
+
+  for ( const auto& DK : DKs )
+  {
+    test_data.points.push_back( { DK, hs::evaluate( params, R, DK ) } );
+  }
+
+  test_set.emplace_back( test_data );
+}
+
+// Candidates on a small grid around the reference parameters, similar to a late fit round.
+std::vector< hs::parameters< real_t > > generate_candidates( std::size_t subdivisions )
+{
+  std::vector< hs::parameters< real_t > > candidates;
+
+  for ( std::size_t i = 0; i != subdivisions; i++ )
+    for ( std::size_t j = 0; j != subdivisions; j++ )
+      for ( std::size_t k = 0; k != subdivisions; k++ )
+        for ( std::size_t l = 0; l != subdivisions; l++ )
+        {
+          candidates.push_back( { cuhyso::sample_parameter( 0.8 * tD, 1.2 * tD, subdivisions, i ),
+                                  cuhyso::sample_parameter( 0.9 * tp, 1.1 * tp, subdivisions, j ),
+                                  cuhyso::sample_parameter( 0.5 * tDKThr, tDKThr, subdivisions, k ),
+                                  cuhyso::sample_parameter( tA, 1.5 * tA, subdivisions, l ) } );
+        }
+
+  return candidates;
+}
+
+// The objective as it was before the norm policies, for reference: the norm chosen at run time on
+// every call, the points read as given, and a bisection that ran all of its 60 steps, since the
+// span of its bracket was never updated.
+real_t baseline_minimum_distance( const real_t&                    DeltaKi,
+                                  const real_t&                    dadNi,
+                                  const real_t&                    R,
+                                  const hs::parameters< real_t >& params,
+                                  const real_t&                    scale )
+{
+  const real_t& DeltaKthr = params.DeltaK_thr;
+  const real_t& A         = params.A;
+
+  auto deriv = [ & ]( const real_t& DeltaK ) {
+    return hs::DistanceDeriv( DeltaK, DeltaKi, dadNi, R, params.D, params.p, DeltaKthr, A, scale );
+  };
+
+  auto distance = [ & ]( const real_t& DeltaK ) {
+    return hs::DistanceScaled(
+      DeltaK, DeltaKi, dadNi, R, params.D, params.p, DeltaKthr, A, scale );
+  };
+
+  if ( dadNi < 1e-17 )
+  {
+    return DeltaKthr;
+  }
+
+  constexpr real_t beta   = 1.0e-4;
+  const real_t     DKlow  = DeltaKthr * ( 1.0 + beta );
+  const real_t     DKhigh = A * ( 1.0 - R ) * ( 1.0 - beta );
+
+  const real_t dlow  = deriv( DKlow );
+  const real_t dhigh = deriv( DKhigh );
+
+  if ( dlow > 0 && dhigh > 0 )
+  {
+    return distance( DKlow );
+  }
+  else if ( dlow < 0 && dhigh < 0 )
+  {
+    return distance( DKhigh );
+  }
+
+  real_t xpos = dlow > 0 ? DKlow : DKhigh;
+  real_t xneg = dlow > 0 ? DKhigh : DKlow;
+
+  for ( std::size_t niters = 0; niters != 60; niters++ )
+  {
+    const real_t xhalf = ( xpos + xneg ) / 2.0;
+    ( deriv( xhalf ) > 0 ? xpos : xneg ) = xhalf;
+  }
+
+  return distance( ( xpos + xneg ) / 2.0 );
+}
+
+hs::Model_Distance_t< real_t >
+baseline_objective_function( const hs::parameters< real_t >& params,
+                             bool                            use_geometric,
+                             const test_set_t&               test_set,
+                             const real_t                    scale )
+{
+  real_t sum = 0.0;
+
+  std::size_t num_rejected_data_points = 0;
+  std::size_t num_data_points          = 0;
+
+  for ( const auto& test : test_set )
+  {
+    for ( const auto& point : test.points )
+    {
+      num_data_points++;
+
+      const real_t dis
+        = use_geometric
+            ? baseline_minimum_distance( point.DeltaK, point.dadN, test.R, params, scale )
+            : std::abs( std::log10( hs::evaluate( params, test.R, point.DeltaK ) )
+                        - std::log10( point.dadN ) );
+
+      if ( std::isfinite( dis ) )
+      {
+        sum += dis;
+      }
+      else
+      {
+        num_rejected_data_points++;
+      }
+    }
+  }
+
+  const auto num_utilized_points = num_data_points - num_rejected_data_points;
+
+  if ( num_utilized_points == 0 )
+  {
+    return { real_t( 1000000.0 ), 0.0 };
+  }
+
+  return { sum / num_utilized_points, double( num_utilized_points ) / num_data_points };
+}
+
+template< class F >
+double time_ms( F&& f )
+{
+  using namespace std::chrono;
+
+  auto start = steady_clock::now( );
+  f( );
+  return double( duration_cast< microseconds >( steady_clock::now( ) - start ).count( ) ) / 1.0e3;
+}
+
+// The specialized kernel on the test set prepared once, as the fits call it, against the baseline
+// on the same candidates and points. The baseline has only the ordinary and the geometric norms.
+template< class Norm >
+void bench( const test_set_t&                              test_set,
+            const std::vector< hs::parameters< real_t > >& candidates,
+            const char*                                    name )
+{
+  auto scale    = crack_growth::computeAxesScale< real_t >( test_set );
+  auto prepared = hs::prepare_test_set< real_t >( test_set );
+
+  constexpr bool has_baseline = std::is_same_v< Norm, hs::ordinary_norm >
+                                || std::is_same_v< Norm, hs::geometric_norm >;
+
+  real_t sum_baseline    = 0.0;
+  real_t sum_specialized = 0.0;
+  real_t sum_warm        = 0.0;
+
+  auto baseline_ms = time_ms( [ & ]( ) {
+    for ( const auto& c : candidates )
+    {
+      if constexpr ( has_baseline )
+      {
+        sum_baseline += baseline_objective_function( c, Norm::geometric, test_set, scale ).distance;
+      }
+    }
+  } );
+
+  hs::distance_scratch_t< real_t > cold;
+  cold.warm_start = false;
+
+  auto specialized_ms = time_ms( [ & ]( ) {
+    for ( const auto& c : candidates )
+    {
+      sum_specialized += hs::objective_function< Norm >( c, prepared, scale, cold ).distance;
+    }
+  } );
+
+  hs::distance_scratch_t< real_t > warm;
+
+  auto warm_ms = time_ms( [ & ]( ) {
+    for ( const auto& c : candidates )
+    {
+      sum_warm += hs::objective_function< Norm >( c, prepared, scale, warm ).distance;
+    }
+  } );
+
+  if ( has_baseline )
+  {
+    spdlog::info( "{:<10} baseline: {:9.2f} ms, specialized: {:9.2f} ms ({:.2f}x), "
+                  "{:.3g} evals/s, relative checksum difference: {:.3g}",
+                  name,
+                  baseline_ms,
+                  specialized_ms,
+                  baseline_ms / specialized_ms,
+                  candidates.size( ) / ( specialized_ms / 1.0e3 ),
+                  double( ( sum_baseline - sum_specialized ) / sum_baseline ) );
+  }
+  else
+  {
+    spdlog::info( "{:<10} specialized: {:9.2f} ms, {:.3g} evals/s",
+                  name,
+                  specialized_ms,
+                  candidates.size( ) / ( specialized_ms / 1.0e3 ) );
+  }
+
+  if ( Norm::geometric && !Norm::sweep )
+  {
+    spdlog::info( "{:<10} warm started: {:9.2f} ms ({:.2f}x), root solver iterations per point: "
+                  "{:.2f} (cold: {:.2f}), closed form: {:.1f}%, checksum difference: {}",
+                  name,
+                  warm_ms,
+                  specialized_ms / warm_ms,
+                  double( warm.iterations ) / warm.solves,
+                  double( cold.iterations ) / cold.solves,
+                  100.0 * warm.closed_form / warm.solves,
+                  double( sum_warm - sum_specialized ) );
+  }
+}
+
+// The sweep against the warm started root solver, candidate by candidate.
+void bench_sweep( const test_set_t&                              test_set,
+                  const std::vector< hs::parameters< real_t > >& candidates )
+{
+  auto scale    = crack_growth::computeAxesScale< real_t >( test_set );
+  auto prepared = hs::prepare_test_set< real_t >( test_set );
+
+  std::vector< real_t > solver( candidates.size( ) );
+  std::vector< real_t > sweep( candidates.size( ) );
+
+  hs::distance_scratch_t< real_t > warm;
+
+  auto solver_ms = time_ms( [ & ]( ) {
+    for ( std::size_t i = 0; i != candidates.size( ); i++ )
+    {
+      solver[ i ]
+        = hs::objective_function< hs::geometric_norm >( candidates[ i ], prepared, scale, warm )
+            .distance;
+    }
+  } );
+
+  hs::distance_scratch_t< real_t > scratch;
+
+  auto sweep_ms = time_ms( [ & ]( ) {
+    for ( std::size_t i = 0; i != candidates.size( ); i++ )
+    {
+      sweep[ i ] = hs::objective_function< hs::geometric_sweep_norm >(
+                     candidates[ i ], prepared, scale, scratch )
+                     .distance;
+    }
+  } );
+
+  // The reference candidate fits the synthetic data exactly
+  double max_relative_difference = 0.0;
+  for ( std::size_t i = 0; i != candidates.size( ); i++ )
+  {
+    max_relative_difference
+      = std::max( max_relative_difference,
+                  double( std::abs( sweep[ i ] - solver[ i ] )
+                          / std::max( solver[ i ], real_t( 1.0e-10 ) ) ) );
+  }
+
+  spdlog::info( "{:<10} sweep: {:9.2f} ms ({:.2f}x the warm started solver), curve samples: {}, "
+                "max relative difference: {:.3g}",
+                "Geometric",
+                sweep_ms,
+                solver_ms / sweep_ms,
+                scratch.samples.size( ),
+                max_relative_difference );
+}
+
+// Noisy data, around 0.05 decades of scatter in da/dN
+void append_noisy_test( test_set_t&   test_set,
+                        real_t        R,
+                        std::size_t   num_data_points,
+                        std::mt19937& generator )
+{
+  append_synthetic_test( test_set, R, num_data_points );
+
+  std::normal_distribution< double > noise( 0.0, 0.05 );
+
+  for ( auto& point : test_set.back( ).points )
+  {
+    point.dadN *= std::pow( real_t( 10.0 ), real_t( noise( generator ) ) );
+  }
+}
+
+// Objective on the coreset of compress_test_set against the full set.
+template< class Norm >
+void bench_coreset( const test_set_t&                              test_set,
+                    const std::vector< hs::parameters< real_t > >& candidates,
+                    real_t                                         cell_size,
+                    const char*                                    name )
+{
+  auto compressed = crack_growth::compress_test_set( test_set, cell_size );
+
+  auto scale               = crack_growth::computeAxesScale< real_t >( test_set );
+  auto prepared            = hs::prepare_test_set< real_t >( test_set );
+  auto prepared_compressed = hs::prepare_test_set< real_t >( compressed );
+
+  std::vector< real_t > full( candidates.size( ) );
+  std::vector< real_t > coreset( candidates.size( ) );
+
+  hs::distance_scratch_t< real_t > scratch;
+
+  auto full_ms = time_ms( [ & ]( ) {
+    for ( std::size_t i = 0; i != candidates.size( ); i++ )
+    {
+      full[ i ]
+        = hs::objective_function< Norm >( candidates[ i ], prepared, scale, scratch ).distance;
+    }
+  } );
+
+  auto coreset_ms = time_ms( [ & ]( ) {
+    for ( std::size_t i = 0; i != candidates.size( ); i++ )
+    {
+      coreset[ i ]
+        = hs::objective_function< Norm >( candidates[ i ], prepared_compressed, scale, scratch )
+            .distance;
+    }
+  } );
+
+  double max_relative_difference = 0.0;
+  for ( std::size_t i = 0; i != candidates.size( ); i++ )
+  {
+    max_relative_difference = std::max(
+      max_relative_difference, double( std::abs( coreset[ i ] - full[ i ] ) / full[ i ] ) );
+  }
+
+  // What the fit sees is the ranking of the candidates
+  auto best_full    = std::min_element( full.begin( ), full.end( ) ) - full.begin( );
+  auto best_coreset = std::min_element( coreset.begin( ), coreset.end( ) ) - coreset.begin( );
+
+  spdlog::info( "{:<10} coreset of {} points: {:9.2f} ms, full set: {:9.2f} ms ({:.1f}x), "
+                "max relative difference: {:.3g}, same best candidate: {}",
+                name,
+                prepared_compressed.points.size( ),
+                coreset_ms,
+                full_ms,
+                full_ms / coreset_ms,
+                max_relative_difference,
+                best_full == best_coreset );
+}
+
+int main( )
+{
+  test_set_t test_set;
+  append_synthetic_test( test_set, 0.8 );
+  append_synthetic_test( test_set, 0.5 );
+  append_synthetic_test( test_set, 0.1 );
+
+  auto candidates = generate_candidates( 8 );
+
+  spdlog::info( "Candidates: {}, data points: {}",
+                candidates.size( ),
+                test_set.size( ) * test_set[ 0 ].points.size( ) );
+
+  bench< hs::ordinary_norm >( test_set, candidates, "Ordinary" );
+  bench< hs::ordinary_huber_norm >( test_set, candidates, "Huber" );
+  bench< hs::ordinary_trimmed_norm >( test_set, candidates, "Trimmed" );
+  bench< hs::ordinary_median_norm >( test_set, candidates, "Median" );
+  bench< hs::geometric_norm >( test_set, candidates, "Geometric" );
+  bench_sweep( test_set, candidates );
+
+  // The sweep pays off when there are many points per R
+  test_set_t dense_test_set;
+  append_synthetic_test( dense_test_set, 0.8, 500 );
+  append_synthetic_test( dense_test_set, 0.1, 500 );
+
+  spdlog::info( "Data points: {}", 2 * dense_test_set[ 0 ].points.size( ) );
+
+  bench_sweep( dense_test_set, generate_candidates( 5 ) );
+
+  // Large noisy data set against its coreset
+  std::mt19937 generator( 1 );
+
+  test_set_t large_test_set;
+  append_noisy_test( large_test_set, 0.8, 50000, generator );
+  append_noisy_test( large_test_set, 0.1, 50000, generator );
+
+  spdlog::info( "Data points: {}", 2 * large_test_set[ 0 ].points.size( ) );
+
+  bench_coreset< hs::ordinary_norm >( large_test_set, generate_candidates( 3 ), 0.02, "Ordinary" );
+  bench_coreset< hs::geometric_norm >( large_test_set, generate_candidates( 3 ), 0.02, "Geometric" );
+
+  return 0;
+}
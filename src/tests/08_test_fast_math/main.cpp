@@ -0,0 +1,278 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+// Verifies the approximations of fast_math.hpp against libm over the ranges of the arguments that
+// occur in fit, and checks them against the bounds documented in the header.
+
+#include <cgrow.hpp>
+#include <fast_math.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+using real_t = long double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+constexpr std::size_t num_samples = 1000000;
+
+// Distance in units in the last place of T
+template< class T >
+double ulp_error( const T& approximation, const real_t& reference )
+{
+  const T rounded = T( reference );
+  const T ulp     = std::nextafter( std::abs( rounded ), std::numeric_limits< T >::infinity( ) )
+                - std::abs( rounded );
+
+  return double( std::abs( real_t( approximation ) - reference ) / ulp );
+}
+
+// Samples x uniformly, or logarithmically if both ends are positive
+template< class T >
+double max_ulp_error( const std::function< T( T ) >&           approximation,
+                      const std::function< real_t( real_t ) >& reference,
+                      real_t                                   from,
+                      real_t                                   to )
+{
+  const bool logarithmic = from > 0;
+  if ( logarithmic )
+  {
+    from = std::log( from );
+    to   = std::log( to );
+  }
+
+  double max_error = 0.0;
+  for ( std::size_t i = 0; i != num_samples; i++ )
+  {
+    real_t x = from + ( to - from ) * i / ( num_samples - 1 );
+    if ( logarithmic )
+    {
+      x = std::exp( x );
+    }
+
+    const T xt = T( x );
+
+    max_error = std::max( max_error, ulp_error( approximation( xt ), reference( real_t( xt ) ) ) );
+  }
+
+  return max_error;
+}
+
+template< class T >
+bool check( const char* name, double error, double bound )
+{
+  const bool passed = error <= bound;
+
+  spdlog::info( "{:<8} {:<6} max error: {:8.3f} ulp, bound: {:6.1f} ulp {}",
+                sizeof( T ) == sizeof( float ) ? "float" : "double",
+                name,
+                error,
+                bound,
+                passed ? "" : "FAILED" );
+
+  return passed;
+}
+
+template< class T >
+bool verify( )
+{
+  namespace fm = fast_math;
+
+  bool passed = true;
+
+  const double log_bound = sizeof( T ) == sizeof( float ) ? 5.0 : 4.0;
+
+  // da/dN, DeltaK and the factors of the model
+  passed &= check< T >( "log2",
+                        max_ulp_error< T >( []( T x ) { return fm::log2( x ); },
+                                            []( real_t x ) { return std::log2( x ); },
+                                            1.0e-12,
+                                            1.0e4 ),
+                        log_bound );
+
+  passed &= check< T >( "log",
+                        max_ulp_error< T >( []( T x ) { return fm::log( x ); },
+                                            []( real_t x ) { return std::log( x ); },
+                                            1.0e-12,
+                                            1.0e4 ),
+                        log_bound );
+
+  passed &= check< T >( "log10",
+                        max_ulp_error< T >( []( T x ) { return fm::log10( x ); },
+                                            []( real_t x ) { return std::log10( x ); },
+                                            1.0e-12,
+                                            1.0e4 ),
+                        log_bound );
+
+  passed &= check< T >( "exp2",
+                        max_ulp_error< T >( []( T x ) { return fm::exp2( x ); },
+                                            []( real_t x ) { return std::exp2( x ); },
+                                            -60.0,
+                                            20.0 ),
+                        2.0 );
+
+  passed &= check< T >( "exp",
+                        max_ulp_error< T >( []( T x ) { return fm::exp( x ); },
+                                            []( real_t x ) { return std::exp( x ); },
+                                            -40.0,
+                                            14.0 ),
+                        2.0 );
+
+  passed &= check< T >( "rsqrt",
+                        max_ulp_error< T >( []( T x ) { return fm::rsqrt( x ); },
+                                            []( real_t x ) { return 1.0 / std::sqrt( x ); },
+                                            1.0e-8,
+                                            1.0e8 ),
+                        3.0 );
+
+  passed &= check< T >( "sqrt",
+                        max_ulp_error< T >( []( T x ) { return fm::sqrt( x ); },
+                                            []( real_t x ) { return std::sqrt( x ); },
+                                            1.0e-8,
+                                            1.0e8 ),
+                        3.0 );
+
+  // The exponents of the model, and its base ( DeltaK - DeltaKthr ) / sqrt( 1 - DeltaK / Kmax )
+  for ( T y : { T( 0.5 ), T( 1.7 ), T( 2.3 ), T( 3.5 ) } )
+  {
+    const real_t from = 1.0e-4;
+    const real_t to   = 1.0e4;
+
+    const double bound = 4.0 + 2.0 * y * std::log2( to );
+
+    auto approximation = [ y ]( T x ) { return fm::pow( x, y ); };
+    auto reference     = [ y ]( real_t x ) { return std::pow( x, real_t( y ) ); };
+
+    passed &= check< T >(
+      "pow", max_ulp_error< T >( approximation, reference, from, to ), bound );
+  }
+
+  return passed;
+}
+
+// Out of the domain, the results of libm
+template< class T >
+bool verify_domain( )
+{
+  namespace fm = fast_math;
+
+  constexpr T inf = std::numeric_limits< T >::infinity( );
+  constexpr T nan = std::numeric_limits< T >::quiet_NaN( );
+
+  auto same = []( T a, T b ) { return a == b || ( std::isnan( a ) && std::isnan( b ) ); };
+
+  const bool checks[] = { std::isnan( fm::log( T( -1.0 ) ) ),
+                          std::isnan( fm::log( nan ) ),
+                          same( fm::log( T( 0.0 ) ), -inf ),
+                          same( fm::log( inf ), inf ),
+                          std::isnan( fm::log10( T( -1.0 ) ) ),
+                          std::isnan( fm::pow( T( -2.0 ), T( 2.5 ) ) ),
+                          std::isnan( fm::pow( nan, T( 2.0 ) ) ),
+                          std::isnan( fm::pow( T( 2.0 ), nan ) ),
+                          same( fm::pow( T( 0.0 ), T( 2.0 ) ), T( 0.0 ) ),
+                          same( fm::pow( T( 0.0 ), T( -2.0 ) ), inf ),
+                          same( fm::pow( T( 0.0 ), T( 0.0 ) ), T( 1.0 ) ),
+                          same( fm::pow( inf, T( 2.0 ) ), inf ),
+                          same( fm::pow( inf, T( -2.0 ) ), T( 0.0 ) ),
+                          std::isnan( fm::rsqrt( T( -1.0 ) ) ),
+                          same( fm::rsqrt( T( 0.0 ) ), inf ),
+                          same( fm::rsqrt( inf ), T( 0.0 ) ),
+                          std::isnan( fm::sqrt( T( -1.0 ) ) ),
+                          same( fm::sqrt( T( 0.0 ) ), T( 0.0 ) ),
+                          same( fm::sqrt( inf ), inf ),
+                          std::isnan( fm::exp( nan ) ),
+                          std::isnan( fm::exp2( nan ) ) };
+
+  const bool passed
+    = std::all_of( std::begin( checks ), std::end( checks ), []( bool c ) { return c; } );
+
+  spdlog::info( "{:<8} out of the domain {}",
+                sizeof( T ) == sizeof( float ) ? "float" : "double",
+                passed ? "" : "FAILED" );
+
+  return passed;
+}
+
+// The model through the policy, against the long double model of fit
+bool verify_evaluate( )
+{
+  const hs::parameters< real_t > params { 3.9e-10, 2.29, 3.04, 116.81 };
+
+  double max_relative_error = 0.0;
+  for ( real_t R : { 0.1, 0.5, 0.8 } )
+  {
+    const real_t Kmax = params.A * ( 1.0 - R );
+
+    for ( std::size_t i = 1; i != num_samples; i++ )
+    {
+      const real_t DeltaK = params.DeltaK_thr + ( Kmax - params.DeltaK_thr ) * i / num_samples;
+
+      const real_t reference = hs::evaluate( params, R, DeltaK );
+      const real_t approximation
+        = hs::evaluate< real_t, fast_math::approximate_math >( params, R, DeltaK );
+
+      max_relative_error = std::max(
+        max_relative_error, double( std::abs( approximation - reference ) / reference ) );
+    }
+  }
+
+  const double bound = 1.0e-13;
+
+  spdlog::info( "evaluate through approximate_math, max relative error: {:.3g}, bound: {:.3g} {}",
+                max_relative_error,
+                bound,
+                max_relative_error <= bound ? "" : "FAILED" );
+
+  return max_relative_error <= bound;
+}
+
+int main( )
+{
+  bool passed = verify< float >( );
+  passed &= verify< double >( );
+  passed &= verify_domain< float >( );
+  passed &= verify_domain< double >( );
+  passed &= verify_evaluate( );
+
+  return passed ? 0 : 1;
+}
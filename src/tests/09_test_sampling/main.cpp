@@ -0,0 +1,187 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+
+// Checks the point sets of sampling.hpp: the net property of the Sobol points, which validates the
+// table of direction numbers, the range of the Halton points and the sizes of the sparse grids.
+
+#include <sampling.hpp>
+#include <spdlog/spdlog.h>
+
+#include <map>
+#include <set>
+
+// Smallest t for which the first 2^m points, projected on the axes a and b, are a (t,m,2)-net:
+// every elementary interval of area 2^( t - m ) holds 2^t points.
+std::size_t net_quality( const cuhyso::unit_points_t& points, std::size_t a, std::size_t b, int m )
+{
+  for ( int t = 0; t <= m; t++ )
+  {
+    bool net = true;
+
+    for ( int k = 0; k <= m - t && net; k++ )
+    {
+      const int l = m - t - k;
+
+      std::map< std::pair< long, long >, std::size_t > counts;
+      for ( const auto& x : points )
+      {
+        counts[ { long( std::ldexp( x[ a ], k ) ), long( std::ldexp( x[ b ], l ) ) } ]++;
+      }
+
+      net = counts.size( ) == ( std::size_t( 1 ) << ( m - t ) );
+      for ( const auto& [ interval, count ] : counts )
+      {
+        net &= count == ( std::size_t( 1 ) << t );
+      }
+    }
+
+    if ( net )
+    {
+      return t;
+    }
+  }
+
+  return m;
+}
+
+// Whether the points on the axis a fall in distinct intervals of width 1 / points.size( )
+bool stratified( const cuhyso::unit_points_t& points, std::size_t a )
+{
+  std::set< long > intervals;
+  for ( const auto& x : points )
+  {
+    intervals.insert( long( x[ a ] * points.size( ) ) );
+  }
+
+  return intervals.size( ) == points.size( );
+}
+
+bool verify_sobol( )
+{
+  constexpr int         m          = 10;
+  constexpr std::size_t dimensions = cuhyso::detail::sobol_max_dimensions;
+
+  bool passed = true;
+
+  // A digital shift keeps the net property
+  for ( unsigned seed : { 0, 1 } )
+  {
+    const auto points = cuhyso::sobol_points( dimensions, std::size_t( 1 ) << m, seed );
+
+    std::size_t worst = 0;
+    for ( std::size_t a = 0; a != dimensions; a++ )
+    {
+      passed &= stratified( points, a );
+
+      for ( std::size_t b = a + 1; b != dimensions; b++ )
+      {
+        worst = std::max( worst, net_quality( points, a, b, m ) );
+      }
+    }
+
+    // The first two axes are a (0,m,2)-net
+    passed &= net_quality( points, 0, 1, m ) == 0 && worst <= 6;
+
+    spdlog::info( "Sobol, seed {}: t of the first two axes: {}, worst pair: {}",
+                  seed,
+                  net_quality( points, 0, 1, m ),
+                  worst );
+  }
+
+  return passed;
+}
+
+bool verify_halton( )
+{
+  bool passed = true;
+
+  for ( unsigned seed : { 0, 1 } )
+  {
+    const auto points = cuhyso::halton_points( 8, 4096, seed );
+
+    std::set< std::vector< double > > distinct;
+    for ( const auto& x : points )
+    {
+      for ( auto xi : x )
+      {
+        passed &= xi > 0.0 && xi < 1.0;
+      }
+      distinct.insert( x );
+    }
+
+    passed &= distinct.size( ) == points.size( );
+  }
+
+  spdlog::info( "Halton: {}", passed ? "points distinct and inside the cube" : "FAILED" );
+
+  return passed;
+}
+
+bool verify_sparse_grid( )
+{
+  const std::size_t expected[] = { 1, 9, 41, 137, 401, 1105, 2929 };
+
+  bool passed = true;
+
+  for ( std::size_t level = 0; level != std::size( expected ); level++ )
+  {
+    const auto points = cuhyso::sparse_grid_points( 4, level );
+
+    std::set< std::vector< double > > distinct( points.begin( ), points.end( ) );
+
+    passed &= points.size( ) == expected[ level ] && distinct.size( ) == points.size( );
+  }
+
+  passed &= cuhyso::sample_unit_cube( cuhyso::sampler_t::sparse_grid, 4, 1296, 0 ).size( ) == 1105;
+
+  spdlog::info( "Sparse grid: {}", passed ? "sizes as expected" : "FAILED" );
+
+  return passed;
+}
+
+int main( )
+{
+  bool passed = verify_sobol( );
+  passed &= verify_halton( );
+  passed &= verify_sparse_grid( );
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+// Verifies the gradients of the model instantiated with dual.hpp against central differences, and
+// that Levenberg-Marquardt recovers the parameters of noise free data from a distant start.
+
+#include <cgrow.hpp>
+#include <dual.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+
+using real_t = long double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+const hs::parameters< real_t > truth { 3.9e-10, 2.29, 3.04, 116.81 };
+
+bool verify_gradient( )
+{
+  using number_t = dual::dual_t< real_t, 5 >;
+
+  double max_relative_error = 0.0;
+  for ( real_t R : { 0.1, 0.5, 0.8 } )
+  {
+    const real_t Kmax = truth.A * ( 1.0 - R );
+
+    for ( std::size_t i = 1; i != 100; i++ )
+    {
+      const real_t DeltaK = truth.DeltaK_thr + ( Kmax - truth.DeltaK_thr ) * i / 100;
+
+      const std::array< real_t, 5 > x { truth.D, truth.p, truth.DeltaK_thr, truth.A, DeltaK };
+
+      std::array< number_t, 5 > variables;
+      for ( std::size_t k = 0; k != 5; k++ )
+      {
+        variables[ k ] = number_t::variable( x[ k ], k );
+      }
+
+      const auto model = hs::evaluate< number_t >( variables[ 0 ],
+                                                   variables[ 1 ],
+                                                   variables[ 2 ],
+                                                   variables[ 3 ],
+                                                   number_t( R ),
+                                                   variables[ 4 ] );
+
+      for ( std::size_t k = 0; k != 5; k++ )
+      {
+        const real_t h = 1.0e-6 * x[ k ];
+
+        auto at = [ & ]( const real_t& offset ) {
+          auto y = x;
+          y[ k ] += offset;
+          return hs::evaluate< real_t >( y[ 0 ], y[ 1 ], y[ 2 ], y[ 3 ], R, y[ 4 ] );
+        };
+
+        const real_t difference = ( at( h ) - at( -h ) ) / ( 2 * h );
+
+        max_relative_error
+          = std::max( max_relative_error,
+                      double( std::abs( model.gradient[ k ] - difference )
+                              / std::max( std::abs( difference ), real_t( 1.0e-300 ) ) ) );
+      }
+    }
+  }
+
+  const double bound = 1.0e-6;
+
+  spdlog::info( "dual gradient of evaluate, max relative error: {:.3g}, bound: {:.3g} {}",
+                max_relative_error,
+                bound,
+                max_relative_error <= bound ? "" : "FAILED" );
+
+  return max_relative_error <= bound;
+}
+
+bool verify_levenberg_marquardt( hs::norm_t norm )
+{
+  std::vector< crack_growth::test_data_t< real_t > > test_set;
+  for ( real_t R : { 0.1, 0.7 } )
+  {
+    crack_growth::test_data_t< real_t > test;
+    test.R = R;
+
+    const real_t Kmax = truth.A * ( 1.0 - R );
+    for ( std::size_t i = 1; i != 60; i++ )
+    {
+      const real_t DeltaK = truth.DeltaK_thr
+                            * std::pow( 0.99 * Kmax / truth.DeltaK_thr, real_t( i ) / 60 );
+      test.points.push_back( { DeltaK, hs::evaluate( truth, R, DeltaK ) } );
+    }
+    test_set.push_back( test );
+  }
+
+  const hs::parameters< real_t > low { 1.0e-10, 1.7, 0.0001, 100.0 };
+  const hs::parameters< real_t > high { 9.0e-10, 2.9, 3.3, 450.0 };
+  const hs::parameters< real_t > start { 2.0e-10, 2.1, 2.0, 150.0 };
+
+  const auto fitted = hs::fit_levenberg_marquardt( low, high, test_set, start, 100, norm );
+
+  const double error = double( std::max( { std::abs( fitted.D / truth.D - 1 ),
+                                           std::abs( fitted.p / truth.p - 1 ),
+                                           std::abs( fitted.DeltaK_thr / truth.DeltaK_thr - 1 ),
+                                           std::abs( fitted.A / truth.A - 1 ) } ) );
+
+  const double bound = 1.0e-3;
+
+  spdlog::info( "Levenberg-Marquardt, norm {}, max relative error: {:.3g}, bound: {:.3g} {}",
+                int( norm ),
+                error,
+                bound,
+                error <= bound ? "" : "FAILED" );
+
+  return error <= bound;
+}
+
+int main( )
+{
+  bool passed = verify_gradient( );
+  passed &= verify_levenberg_marquardt( hs::norm_t::ordinary );
+  passed &= verify_levenberg_marquardt( hs::norm_t::ordinary_huber );
+  passed &= verify_levenberg_marquardt( hs::norm_t::geometric );
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+// Fits every built-in model of models.hpp to noise free data of known parameters, in the search box
+// of its bounds, and checks that the parameters are recovered.
+
+#include <models.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using real_t = long double;
+
+namespace hs     = crack_growth::Hartman_Schijve;
+namespace models = crack_growth::models;
+
+template< class Model >
+bool verify( const char*                                  name,
+             const models::parameters_t< Model, real_t >& truth,
+             hs::engine_t                                 engine,
+             double                                       bound )
+{
+  std::vector< crack_growth::test_data_t< real_t > > test_set;
+  for ( real_t R : { 0.1, 0.5, 0.7 } )
+  {
+    crack_growth::test_data_t< real_t > test;
+    test.R = R;
+
+    auto [ low, high ] = Model::domain( truth, R );
+    low                = std::max( low * real_t( 1.05 ), real_t( 3.0 ) );
+    high               = std::min( high * real_t( 0.97 ), real_t( 60.0 ) );
+
+    for ( std::size_t i = 0; i != 40; i++ )
+    {
+      const real_t DeltaK = low * std::pow( high / low, real_t( i ) / 39 );
+      test.points.push_back( { DeltaK, Model::evaluate( truth, R, DeltaK ) } );
+    }
+    test_set.push_back( test );
+  }
+
+  const auto [ low, high ] = Model::template bounds< real_t >( test_set );
+
+  const auto fitted = models::fit< Model, real_t >(
+    low, high, test_set, engine, 8, 1.5, 20000, hs::norm_t::ordinary );
+
+  double error = 0.0;
+  for ( std::size_t k = 0; k != Model::num_parameters; k++ )
+  {
+    error = std::max( error, double( std::abs( fitted[ k ] / truth[ k ] - 1 ) ) );
+  }
+
+  spdlog::info( "{}, max relative parameter error: {:.3g}, bound: {:.3g} {}",
+                name,
+                error,
+                bound,
+                error <= bound ? "" : "FAILED" );
+
+  return error <= bound;
+}
+
+int main( )
+{
+  const auto cmaes = hs::engine_t::cmaes;
+
+  bool passed = verify< models::paris >( "Paris", { 1e-11, 3.1 }, cmaes, 1.0e-4 );
+  passed &= verify< models::walker >( "Walker", { 1e-11, 3.1, 0.6 }, cmaes, 1.0e-4 );
+  passed &= verify< models::forman >( "Forman", { 1e-9, 2.8, 120.0 }, cmaes, 1.0e-4 );
+  passed &= verify< models::nasgro >(
+    "NASGRO", { 1e-11, 3.0, 0.5, 0.5, 2.5, 120.0 }, cmaes, 1.0e-3 );
+  const auto truth = synthetic::truth< real_t >( );
+  passed &= verify< models::hartman_schijve >(
+    "Hartman-Schijve", { truth.D, truth.p, truth.DeltaK_thr, truth.A }, cmaes, 1.0e-4 );
+
+  // The grid contraction, whose candidates are abandoned once they cannot improve
+  passed &= verify< models::walker >(
+    "Walker, grid", { 1e-11, 3.1, 0.6 }, hs::engine_t::grid, 5.0e-2 );
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+// Fits noise free tests that share D and p but not DeltaK_thr and A jointly, and checks that the
+// parameters of every test are recovered, and that fitting them independently matches.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using real_t = long double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+bool verify( const char*                                    name,
+             const hs::common_among_tests&                  common,
+             const std::vector< hs::parameters< real_t > >& truth,
+             const std::vector< real_t >&                   Rs,
+             double                                         bound )
+{
+  std::vector< crack_growth::test_data_t< real_t > > test_set;
+  for ( std::size_t t = 0; t != truth.size( ); t++ )
+  {
+    test_set.push_back(
+      synthetic::test< real_t >( truth[ t ], Rs[ t ], 40, 1.05, 0.97, synthetic::no_noise ) );
+  }
+
+  const hs::parameters< real_t > low { 1.0e-11, 1.5, 0.5, 40.0 };
+  const hs::parameters< real_t > high { 1.0e-8, 3.0, 6.0, 400.0 };
+
+  const auto fitted
+    = hs::fit_joint< real_t >( common, low, high, test_set, 5, 1.3, 0, hs::norm_t::ordinary );
+
+  double error = 0.0;
+  for ( std::size_t t = 0; t != truth.size( ); t++ )
+  {
+    error = std::max( { error,
+                        double( std::abs( fitted[ t ].D / truth[ t ].D - 1 ) ),
+                        double( std::abs( fitted[ t ].p / truth[ t ].p - 1 ) ),
+                        double( std::abs( fitted[ t ].DeltaK_thr / truth[ t ].DeltaK_thr - 1 ) ),
+                        double( std::abs( fitted[ t ].A / truth[ t ].A - 1 ) ) } );
+  }
+
+  spdlog::info( "{}, max relative parameter error: {:.3g}, bound: {:.3g} {}",
+                name,
+                error,
+                bound,
+                error <= bound ? "" : "FAILED" );
+
+  return error <= bound;
+}
+
+int main( )
+{
+  const auto shared = synthetic::truth< real_t >( );
+
+  const std::vector< hs::parameters< real_t > > truth { shared,
+                                                        { shared.D, shared.p, 3.10, 95.0 },
+                                                        { shared.D, shared.p, 1.50, 140.0 },
+                                                        { shared.D, shared.p, 4.20, 120.0 } };
+
+  const std::vector< real_t > Rs { 0.1, 0.1, 0.3, 0.5 };
+
+  bool passed = verify( "Shared D and p",
+                        hs::common_among_tests { true, true, false, false },
+                        truth,
+                        Rs,
+                        1e-3 );
+
+  passed &= verify( "Nothing shared",
+                    hs::common_among_tests { false, false, false, false },
+                    truth,
+                    Rs,
+                    1e-3 );
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+// Bootstraps a fit to noisy data of known parameters, and checks that the percentile intervals
+// cover them, that the summary streams once per replicate and that the result is reproducible.
+// Also checks that a test without points is rejected.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <cmath>
+#include <random>
+
+using real_t = long double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+int main( )
+{
+  const auto truth = synthetic::truth< real_t >( );
+
+  std::mt19937                       random( 7 );
+  std::normal_distribution< double > noise( 0.0, 0.03 );
+
+  const auto test_set = synthetic::test_set< real_t >(
+    truth, { 0.1, 0.5, 0.7 }, 30, 1.3, 0.95, [ & ]( ) { return noise( random ); } );
+
+  const hs::parameters< real_t > low { 1.0e-10, 1.7, 0.5, 100.0 };
+  const hs::parameters< real_t > high { 1.0e-9, 2.9, 3.0, 200.0 };
+
+  const auto estimate = hs::fit_levenberg_marquardt< real_t >(
+    low, high, test_set, { 2.0e-10, 2.5, 1.5, 130.0 }, 100, hs::norm_t::ordinary );
+
+  std::size_t streamed = 0;
+
+  // 99% intervals, as one of four 95% ones missing the truth would not be unusual
+
+  auto run = [ & ]( hs::resampling_t resampling ) {
+    return hs::bootstrap< real_t >( low,
+                                    high,
+                                    test_set,
+                                    estimate,
+                                    100,
+                                    resampling,
+                                    hs::norm_t::ordinary,
+                                    0.99,
+                                    0.5,
+                                    [ & ]( hs::bootstrap_t< real_t > ) { streamed++; } );
+  };
+
+  const auto points = run( hs::resampling_t::points );
+  const auto again  = run( hs::resampling_t::points );
+
+  auto covers = [ & ]( const char* name, const real_t& lower, const real_t& upper, real_t value ) {
+    const bool covered = lower <= value && value <= upper;
+    spdlog::info( "{}: [{:.4g}, {:.4g}], truth {:.4g} {}",
+                  name,
+                  double( lower ),
+                  double( upper ),
+                  double( value ),
+                  covered ? "" : "FAILED" );
+    return covered;
+  };
+
+  bool passed = covers( "D", points.lower.D, points.upper.D, truth.D );
+  passed &= covers( "p", points.lower.p, points.upper.p, truth.p );
+  passed &= covers(
+    "DeltaK_thr", points.lower.DeltaK_thr, points.upper.DeltaK_thr, truth.DeltaK_thr );
+  passed &= covers( "A", points.lower.A, points.upper.A, truth.A );
+
+  // D and p trade off against each other
+  spdlog::info( "Correlation of log10 D and p: {:.3f}", double( points.correlation[ 0 ][ 1 ] ) );
+  passed &= points.correlation[ 0 ][ 1 ] < -0.5;
+
+  passed &= streamed == 200 && points.replicates == 100;
+  passed &= points.lower.D == again.lower.D && points.upper.A == again.upper.A;
+
+  spdlog::info( "Summaries streamed: {}, replicates at the bound of their box: {}",
+                streamed,
+                points.at_bound );
+
+  const auto tests = run( hs::resampling_t::tests );
+  spdlog::info( "Resampling the tests, p: [{:.4g}, {:.4g}]",
+                double( tests.lower.p ),
+                double( tests.upper.p ) );
+
+  passed &= tests.replicates == 100;
+
+  // A test without points is rejected before any replicate is fitted
+  auto with_empty = test_set;
+  with_empty.push_back( { 0.3, { } } );
+
+  bool rejected = false;
+  try
+  {
+    hs::bootstrap< real_t >( low, high, with_empty, estimate, 10, hs::resampling_t::points );
+  }
+  catch ( const std::runtime_error& )
+  {
+    rejected = true;
+  }
+
+  spdlog::info( "Test without points rejected: {}", rejected );
+
+  passed &= rejected;
+
+  return passed ? 0 : 1;
+}
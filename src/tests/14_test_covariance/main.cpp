@@ -0,0 +1,132 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+// Compares the standard deviations of the linearized covariance at a fit to noisy data with those
+// of a bootstrap, and checks that the two sigma prediction band holds about 95% of the points.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <cmath>
+#include <random>
+
+using real_t = long double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+int main( )
+{
+  const auto truth = synthetic::truth< real_t >( );
+
+  std::mt19937                       random( 11 );
+  std::normal_distribution< double > noise( 0.0, 0.03 );
+
+  const auto test_set = synthetic::test_set< real_t >(
+    truth, { 0.1, 0.5, 0.7 }, 30, 1.3, 0.95, [ & ]( ) { return noise( random ); } );
+
+  const hs::parameters< real_t > low { 1.0e-10, 1.7, 0.5, 100.0 };
+  const hs::parameters< real_t > high { 1.0e-9, 2.9, 3.0, 200.0 };
+
+  const auto estimate = hs::fit_levenberg_marquardt< real_t >(
+    low, high, test_set, { 2.0e-10, 2.5, 1.5, 130.0 }, 100, hs::norm_t::ordinary );
+
+  const auto covariance = hs::covariance< real_t >( low, high, test_set, estimate );
+
+  spdlog::info( "Residual standard deviation: {:.4f}, noise: 0.03",
+                double( std::sqrt( covariance.residual_variance ) ) );
+
+  bool passed = std::abs( std::sqrt( covariance.residual_variance ) - 0.03 ) < 0.01;
+
+  // One sigma from the 68% intervals of the bootstrap
+  const auto bootstrap = hs::bootstrap< real_t >(
+    low, high, test_set, estimate, 200, hs::resampling_t::points, hs::norm_t::ordinary, 0.6827 );
+
+  const std::array< real_t, 4 > bootstrap_sigmas {
+    std::log10( bootstrap.upper.D / bootstrap.lower.D ) / 2,
+    ( bootstrap.upper.p - bootstrap.lower.p ) / 2,
+    ( bootstrap.upper.DeltaK_thr - bootstrap.lower.DeltaK_thr ) / 2,
+    ( bootstrap.upper.A - bootstrap.lower.A ) / 2 };
+
+  const char* names[] = { "log10 D", "p", "DeltaK_thr", "A" };
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    const real_t sigma = std::sqrt( covariance.matrix[ k ][ k ] );
+    const real_t ratio = sigma / bootstrap_sigmas[ k ];
+
+    // A, set by the few points near its asymptote, is far from linear in the residuals. Its
+    // linearized sigma overstates the bootstrap one by a factor of about three here, see
+    // covariance.
+    const real_t tolerance = k == 3 ? 4.0 : 2.0;
+    const bool   agree     = ratio > 1 / tolerance && ratio < tolerance;
+
+    spdlog::info( "{}: sigma {:.4g}, bootstrap {:.4g} {}",
+                  names[ k ],
+                  double( sigma ),
+                  double( bootstrap_sigmas[ k ] ),
+                  agree ? "" : "FAILED" );
+
+    passed &= covariance.identified[ k ] && agree;
+  }
+
+  std::size_t inside = 0, total = 0;
+  for ( const auto& test : test_set )
+  {
+    std::vector< real_t > DeltaKs;
+    for ( const auto& point : test.points )
+    {
+      DeltaKs.push_back( point.DeltaK );
+    }
+
+    const auto [ lower, upper ] = hs::prediction_band( estimate, covariance, test.R, DeltaKs );
+
+    for ( std::size_t i = 0; i != test.points.size( ); i++ )
+    {
+      inside += lower[ i ] <= test.points[ i ].dadN && test.points[ i ].dadN <= upper[ i ];
+      total++;
+    }
+  }
+
+  const double fraction = double( inside ) / total;
+  spdlog::info( "Points within the two sigma prediction band: {:.3f}", fraction );
+
+  passed &= fraction > 0.85;
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+// Profiles every parameter of a fit to data with noise of a Laplace distribution, for which the
+// ordinary norm is the likelihood, and checks that the intervals hold the parameters of the data.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <cmath>
+#include <random>
+
+using real_t = long double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+int main( )
+{
+  const auto truth = synthetic::truth< real_t >( );
+
+  std::mt19937                            random( 11 );
+  std::exponential_distribution< double > noise( 1.0 / 0.03 );
+  std::bernoulli_distribution             sign( 0.5 );
+
+  auto laplace = [ & ]( ) { return sign( random ) ? noise( random ) : -noise( random ); };
+
+  const auto test_set
+    = synthetic::test_set< real_t >( truth, { 0.1, 0.5, 0.7 }, 30, 1.3, 0.95, laplace );
+
+  const hs::parameters< real_t > low { 1.0e-10, 1.7, 0.5, 100.0 };
+  const hs::parameters< real_t > high { 1.0e-9, 2.9, 3.0, 200.0 };
+
+  const auto estimate = hs::fit< real_t >( low, high, test_set, 7, 1.2, 0, hs::norm_t::ordinary );
+
+  const auto profiles = hs::profile< real_t >(
+    low, high, test_set, estimate, 21, hs::norm_t::ordinary, 0.99 );
+
+  const std::array< real_t, 4 > truths { truth.D, truth.p, truth.DeltaK_thr, truth.A };
+  const std::array< real_t, 4 > estimates {
+    estimate.D, estimate.p, estimate.DeltaK_thr, estimate.A };
+
+  bool passed = true;
+
+  const char* names[] = { "D", "p", "DeltaK_thr", "A" };
+  for ( std::size_t k = 0; k != 4; k++ )
+  {
+    const auto& profile = profiles[ k ];
+
+    // The fit is the minimum of its profiles
+    const auto at_estimate
+      = std::find( profile.values.begin( ), profile.values.end( ), estimates[ k ] )
+        - profile.values.begin( );
+    const bool minimal = std::size_t( at_estimate ) != profile.values.size( )
+                         && profile.deviances[ at_estimate ] < 0.5;
+
+    const bool covers = !profile.lower_open && !profile.upper_open
+                        && profile.lower <= truths[ k ] && truths[ k ] <= profile.upper;
+
+    spdlog::info( "{}: [{:.4g}, {:.4g}], {:.4g} {}",
+                  names[ k ],
+                  double( profile.lower ),
+                  double( profile.upper ),
+                  double( truths[ k ] ),
+                  minimal && covers ? "" : "FAILED" );
+
+    passed &= minimal && covers;
+  }
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+// Fits with the adaptive grid, and checks that the first round stays within the budget, and that
+// every axis of the search box contracts in every round while the volume contracts by amortization
+// to the number of axes.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+using real_t = double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+int main( )
+{
+  const auto truth = synthetic::truth< real_t >( );
+
+  const auto test_set = synthetic::test_set< real_t >(
+    truth, { 0.1, 0.5, 0.7 }, 20, 1.3, 0.95, synthetic::no_noise );
+
+  const hs::parameters< real_t > low { 1.0e-10, 1.7, 0.5, 100.0 };
+  const hs::parameters< real_t > high { 1.0e-9, 2.9, 3.0, 200.0 };
+
+  const double      amortization = 1.5;
+  const std::size_t budget       = 3000;
+
+  std::atomic< std::size_t > evaluations { 0 };
+
+  // Search box and evaluations of every round
+  std::vector< std::array< double, 4 > > widths;
+  std::vector< std::size_t >             round_evaluations;
+
+  auto callback = [ & ]( hs::parameters< real_t >,
+                         hs::parameters< real_t > min,
+                         hs::parameters< real_t > max ) {
+    widths.push_back( { std::log10( max.D / min.D ),
+                        max.p - min.p,
+                        max.DeltaK_thr - min.DeltaK_thr,
+                        max.A - min.A } );
+    round_evaluations.push_back( evaluations.exchange( 0 ) );
+  };
+
+  const bool stop = false;
+
+  const auto estimate = hs::fit< real_t >(
+    low,
+    high,
+    test_set,
+    8,
+    amortization,
+    10,
+    hs::norm_t::ordinary,
+    callback,
+    []( std::size_t, std::size_t ) {},
+    stop,
+    [ & ]( hs::parameters< real_t > ) { evaluations++; },
+    cuhyso::sampler_t::adaptive_grid,
+    budget );
+
+  bool passed = !round_evaluations.empty( ) && round_evaluations.front( ) <= budget;
+
+  spdlog::info( "Evaluations of the first round: {}, budget: {} {}",
+                round_evaluations.front( ),
+                budget,
+                passed ? "" : "FAILED" );
+
+  for ( std::size_t t = 1; t < widths.size( ); t++ )
+  {
+    double volume_ratio = 1.0;
+    bool   contracted   = round_evaluations[ t ] <= budget;
+
+    for ( std::size_t k = 0; k != 4; k++ )
+    {
+      const double ratio = widths[ t - 1 ][ k ] / widths[ t ][ k ];
+
+      contracted &= ratio > 1.0;
+      volume_ratio *= ratio;
+    }
+
+    const double expected = std::pow( amortization, 4 );
+    const bool   round_passed
+      = contracted && std::abs( volume_ratio - expected ) < 1.0e-9 * expected;
+
+    spdlog::info( "Round {}: width ratios {:.3f} {:.3f} {:.3f} {:.3f}, volume ratio {:.4f} {}",
+                  t,
+                  widths[ t - 1 ][ 0 ] / widths[ t ][ 0 ],
+                  widths[ t - 1 ][ 1 ] / widths[ t ][ 1 ],
+                  widths[ t - 1 ][ 2 ] / widths[ t ][ 2 ],
+                  widths[ t - 1 ][ 3 ] / widths[ t ][ 3 ],
+                  volume_ratio,
+                  round_passed ? "" : "FAILED" );
+
+    passed &= round_passed;
+  }
+
+  const double p_error = std::abs( estimate.p - truth.p ) / truth.p;
+
+  spdlog::info( "p: {:.4f}, relative error: {:.2g} {}",
+                estimate.p,
+                p_error,
+                p_error < 0.05 ? "" : "FAILED" );
+
+  passed &= p_error < 0.05;
+
+  return passed ? 0 : 1;
+}
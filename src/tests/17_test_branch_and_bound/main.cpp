@@ -0,0 +1,121 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+// Branch and bound over p and DeltaK_thr, D and A held fixed, against the minimum of an exhaustive
+// grid. The result must be certified, and its objective must be within its gap of the grid minimum.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <cmath>
+#include <random>
+
+using real_t = double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+int main( )
+{
+  const auto truth = synthetic::truth< real_t >( );
+
+  std::mt19937                       random( 7 );
+  std::normal_distribution< double > noise( 0.0, 0.05 );
+
+  const auto test_set = synthetic::test_set< real_t >(
+    truth, { 0.1, 0.7 }, 15, 1.3, 0.9, [ & ]( ) { return noise( random ); } );
+
+  const hs::parameters< real_t > low { truth.D, 1.8, 0.5, truth.A };
+  const hs::parameters< real_t > high { truth.D, 2.8, 2.5, truth.A };
+
+  const real_t tolerance = 1.0e-4;
+
+  const auto result = hs::fit_branch_and_bound< real_t >(
+    low, high, test_set, tolerance, 200000, hs::norm_t::ordinary );
+
+  spdlog::info( "Branch and bound: p {:.5f}, DeltaK_thr {:.5f}, objective {:.6f}, gap {:.2g}, "
+                "evaluations {}, certified {}",
+                result.estimate.p,
+                result.estimate.DeltaK_thr,
+                result.objective,
+                result.gap,
+                result.evaluations,
+                result.certified );
+
+  // Exhaustive grid, among the parameters that utilize all points
+  const auto        scale     = crack_growth::computeAxesScale< real_t >( test_set );
+  const std::size_t grid_size = 400;
+
+  real_t                   grid_min = std::numeric_limits< real_t >::max( );
+  hs::parameters< real_t > grid_params;
+
+  for ( std::size_t i = 0; i != grid_size; i++ )
+  {
+    for ( std::size_t j = 0; j != grid_size; j++ )
+    {
+      const hs::parameters< real_t > params {
+        truth.D,
+        low.p + ( high.p - low.p ) * i / ( grid_size - 1 ),
+        low.DeltaK_thr + ( high.DeltaK_thr - low.DeltaK_thr ) * j / ( grid_size - 1 ),
+        truth.A };
+
+      const auto d = hs::objective_function( params, hs::norm_t::ordinary, test_set, scale );
+
+      if ( d.utilization >= 1.0 && d.distance < grid_min )
+      {
+        grid_min    = d.distance;
+        grid_params = params;
+      }
+    }
+  }
+
+  spdlog::info( "Exhaustive grid: p {:.5f}, DeltaK_thr {:.5f}, objective {:.6f}",
+                grid_params.p,
+                grid_params.DeltaK_thr,
+                grid_min );
+
+  const bool passed = result.certified && result.utilization >= 1.0
+                      && result.gap <= tolerance && result.objective - result.gap <= grid_min
+                      && result.objective <= grid_min + tolerance;
+
+  spdlog::info( "{}", passed ? "Passed" : "FAILED" );
+
+  return passed ? 0 : 1;
+}
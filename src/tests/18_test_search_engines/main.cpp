@@ -0,0 +1,234 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+// Minimizes a shifted sphere, with one log scaled dimension, and the Rosenbrock function with
+// CMA-ES, differential evolution in both modes and the surrogate search, and checks the distance of
+// each result to the minimum. Also checks that invalid boxes and budgets are rejected, and that a
+// search stopped before it starts returns the center of the box.
+
+#include <cmaes.hpp>
+#include <differential_evolution.hpp>
+#include <spdlog/spdlog.h>
+#include <surrogate.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+using real_t = double;
+
+using minimizer_t = std::function< std::vector< real_t >(
+  std::function< real_t( const std::vector< real_t >&, std::size_t ) >,
+  std::vector< real_t >,
+  std::vector< real_t >,
+  std::vector< bool > ) >;
+
+// The last dimension is searched in the logarithm, its minimum at 50 in [ 1, 1000 ]
+real_t sphere( const std::vector< real_t >& x )
+{
+  const real_t c[] = { 0.3, -0.7, 2.0 };
+
+  real_t sum = 0.0;
+  for ( std::size_t i = 0; i != 3; i++ )
+  {
+    sum += ( x[ i ] - c[ i ] ) * ( x[ i ] - c[ i ] );
+  }
+
+  const real_t l = std::log10( x[ 3 ] / 50.0 );
+
+  return sum + l * l;
+}
+
+real_t rosenbrock( const std::vector< real_t >& x )
+{
+  return 100.0 * ( x[ 1 ] - x[ 0 ] * x[ 0 ] ) * ( x[ 1 ] - x[ 0 ] * x[ 0 ] )
+         + ( 1.0 - x[ 0 ] ) * ( 1.0 - x[ 0 ] );
+}
+
+bool verify( const char*        name,
+             const minimizer_t& minimize,
+             real_t             sphere_tolerance,
+             real_t             rosenbrock_tolerance )
+{
+  std::atomic< std::size_t > evaluations { 0 };
+
+  const auto x = minimize(
+    [ & ]( const std::vector< real_t >& x, std::size_t ) {
+      evaluations++;
+      return sphere( x );
+    },
+    { -2.0, -2.0, -2.0, 1.0 },
+    { 2.0, 2.0, 3.0, 1000.0 },
+    { false, false, false, true } );
+
+  const real_t sphere_error = std::sqrt( sphere( x ) );
+
+  const auto y = minimize(
+    [ & ]( const std::vector< real_t >& x, std::size_t ) {
+      evaluations++;
+      return rosenbrock( x );
+    },
+    { -2.0, -2.0 },
+    { 2.0, 2.0 },
+    { } );
+
+  const real_t rosenbrock_error = std::hypot( y[ 0 ] - 1.0, y[ 1 ] - 1.0 );
+
+  const bool passed = sphere_error < sphere_tolerance && rosenbrock_error < rosenbrock_tolerance;
+
+  spdlog::info( "{:<28} sphere error: {:.2e} (bound {:.0e}), Rosenbrock error: {:.2e} (bound "
+                "{:.0e}), evaluations: {} {}",
+                name,
+                sphere_error,
+                sphere_tolerance,
+                rosenbrock_error,
+                rosenbrock_tolerance,
+                evaluations.load( ),
+                passed ? "" : "FAILED" );
+
+  return passed;
+}
+
+template< class F >
+bool throws( F&& f )
+{
+  try
+  {
+    f( );
+  }
+  catch ( const std::runtime_error& )
+  {
+    return true;
+  }
+
+  return false;
+}
+
+int main( )
+{
+  bool passed = true;
+
+  passed &= verify(
+    "CMA-ES",
+    []( auto f, auto low, auto high, auto log_scale ) {
+      cmaes::options_t< real_t > options;
+      options.num_threads = 4;
+
+      return cmaes::minimize< real_t >( f, low, high, log_scale, options );
+    },
+    1.0e-6,
+    1.0e-6 );
+
+  for ( auto mode : { differential_evolution::mode_t::synchronous,
+                      differential_evolution::mode_t::asynchronous } )
+  {
+    passed &= verify(
+      mode == differential_evolution::mode_t::synchronous ? "Differential evolution, sync"
+                                                          : "Differential evolution, async",
+      [ mode ]( auto f, auto low, auto high, auto log_scale ) {
+        differential_evolution::options_t< real_t > options;
+        options.num_threads     = 4;
+        options.mode            = mode;
+        options.max_evaluations = 20000;
+
+        return differential_evolution::minimize< real_t >( f, low, high, log_scale, options );
+      },
+      1.0e-4,
+      1.0e-3 );
+  }
+
+  passed &= verify(
+    "Surrogate",
+    []( auto f, auto low, auto high, auto log_scale ) {
+      surrogate::options_t< real_t > options;
+      options.num_threads     = 4;
+      options.max_evaluations = 500;
+
+      return surrogate::minimize< real_t >( f, low, high, log_scale, options );
+    },
+    1.0e-3,
+    1.0e-1 );
+
+  auto objective = []( const std::vector< real_t >& x, std::size_t ) { return sphere( x ); };
+
+  surrogate::options_t< real_t > no_evaluations;
+  no_evaluations.max_evaluations = 0;
+
+  cmaes::options_t< real_t > no_cmaes_evaluations;
+  no_cmaes_evaluations.max_evaluations = 0;
+
+  const bool rejected
+    = throws( [ & ] { cmaes::minimize< real_t >( objective, { 0.0 }, { 1.0, 2.0 } ); } )
+      && throws( [ & ] {
+           differential_evolution::minimize< real_t >( objective, { -1.0 }, { 1.0 }, { true } );
+         } )
+      && throws( [ & ] {
+           surrogate::minimize< real_t >(
+             objective, { -2.0, -2.0, -2.0, 1.0 }, { 2.0, 2.0, 3.0, 1000.0 }, { }, no_evaluations );
+         } )
+      && throws( [ & ] {
+           cmaes::minimize< real_t >( objective, { 0.0 }, { 1.0 }, { }, no_cmaes_evaluations );
+         } );
+
+  spdlog::info( "Invalid boxes and budgets: {}", rejected ? "rejected" : "FAILED" );
+
+  passed &= rejected;
+
+  // Stopped before any evaluation, CMA-ES returns the center of the box
+  const bool stop   = true;
+  const auto center = cmaes::minimize< real_t >( objective,
+                                                 { 0.0, 0.0, 0.0, 1.0 },
+                                                 { 2.0, 2.0, 2.0, 100.0 },
+                                                 { false, false, false, true },
+                                                 { },
+                                                 []( auto, auto, auto ) {},
+                                                 []( std::size_t, std::size_t ) {},
+                                                 stop );
+
+  const bool centered = center.size( ) == 4 && std::fabs( center[ 0 ] - 1.0 ) < 1.0e-12
+                        && std::fabs( center[ 3 ] - 10.0 ) < 1.0e-9;
+
+  spdlog::info( "CMA-ES stopped at once: {}", centered ? "center of the box" : "FAILED" );
+
+  passed &= centered;
+
+  return passed ? 0 : 1;
+}
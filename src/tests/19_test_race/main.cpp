@@ -0,0 +1,114 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+
+// Races CMA-ES, differential evolution and Nelder-Mead on noise-free data over p, DeltaK_thr and A,
+// D held fixed. The result must be the best of the minima the engines reported, and must recover
+// the parameters the data were generated with.
+
+#include <cgrow.hpp>
+#include <spdlog/spdlog.h>
+#include <synthetic.hpp>
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+using real_t = double;
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+int main( )
+{
+  const auto truth = synthetic::truth< real_t >( );
+
+  const auto test_set = synthetic::test_set< real_t >(
+    truth, { 0.1, 0.4, 0.7 }, 20, 1.1, 0.95, synthetic::no_noise );
+
+  const hs::parameters< real_t > low { truth.D, 1.5, 0.5, 80.0 };
+  const hs::parameters< real_t > high { truth.D, 3.5, 3.5, 160.0 };
+
+  const auto scale = crack_growth::computeAxesScale< real_t >( test_set );
+
+  auto penalized = [ & ]( const hs::parameters< real_t >& params ) {
+    const auto d = hs::objective_function( params, hs::norm_t::ordinary, test_set, scale );
+    return d.distance + 1000000.0 * ( 1.0 - d.utilization );
+  };
+
+  std::mutex mutex;
+  real_t     best_reported = std::numeric_limits< real_t >::max( );
+
+  const auto result = hs::fit_race< real_t >(
+    low,
+    high,
+    test_set,
+    { hs::engine_t::cmaes, hs::engine_t::differential_evolution, hs::engine_t::nelder_mead },
+    8,
+    1.5,
+    60000,
+    hs::norm_t::ordinary,
+    [ & ]( hs::parameters< real_t > params, hs::parameters< real_t >, hs::parameters< real_t > ) {
+      const real_t value = penalized( params );
+
+      std::lock_guard< std::mutex > lock( mutex );
+      best_reported = std::min( best_reported, value );
+    } );
+
+  const real_t objective = penalized( result );
+
+  spdlog::info( "Race: p {:.5f}, DeltaK_thr {:.5f}, A {:.4f}, objective {:.3g}, "
+                "best reported {:.3g}",
+                result.p,
+                result.DeltaK_thr,
+                result.A,
+                objective,
+                best_reported );
+
+  auto relative = []( real_t estimate, real_t exact ) {
+    return std::fabs( estimate - exact ) / std::fabs( exact );
+  };
+
+  const bool passed = objective == best_reported && relative( result.p, truth.p ) < 1.0e-3
+                      && relative( result.DeltaK_thr, truth.DeltaK_thr ) < 1.0e-3
+                      && relative( result.A, truth.A ) < 1.0e-3;
+
+  spdlog::info( "{}", passed ? "Passed" : "FAILED" );
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// CGROW: A crack growth model identification framework.
+
+// AUTHORIZATION TO USE AND DISTRIBUTE. By using or distributing the CGROW software
+// ("THE SOFTWARE"), you agree to the following terms governing the use and redistribution of
+// THE SOFTWARE originally developed at the U.S. Naval Research Laboratory ("NRL"), Computational
+// Multiphysics Systems Lab., Code 6394.
+
+// The modules of CGROW containing an attribution in their header files to the NRL have been
+// authored by federal employees. To the extent that a federal employee is an author of a portion of
+// this software or a derivative work thereof, no copyright is claimed by the United States
+// Government, as represented by the Secretary of the Navy ("GOVERNMENT") under Title 17, U.S. Code.
+// All Other Rights Reserved.
+
+// Download, redistribution and use of source and/or binary forms, with or without modification,
+// constitute an acknowledgement and agreement to the following:
+
+// (1) source code distributions retain the above notice, this list of conditions, and the following
+// disclaimer in its entirety,
+// (2) distributions including binary code include this paragraph in its entirety in the
+// documentation or other materials provided with the distribution, and
+// (3) all published research using this software display the following acknowledgment:
+// "This work uses the software components contained within the NRL CGROW computer package
+// written and developed by the U.S. Naval Research Laboratory, Computational Multiphysics Systems
+// lab., Code 6394"
+
+// Neither the name of NRL or its contributors, nor any entity of the United States Government may
+// be used to endorse or promote products derived from this software, nor does the inclusion of the
+// NRL written and developed software directly or indirectly suggest NRL's or the United States
+// Government's endorsement of this product.
+
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+// NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR THE U.S. GOVERNMENT BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// NOTICE OF THIRD-PARTY SOFTWARE LICENSES. This software uses open source software packages from
+// third parties. These are available on an "as is" basis and subject to their individual license
+// agreements. Additional information can be found in the provided "licenses" folder.
+// Synthetic test data of the model of Hartman_Schijve, shared by the tests that fit it.
+
+#pragma once
+
+#include <cgrow.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace synthetic
+{
+
+namespace hs = crack_growth::Hartman_Schijve;
+
+// The parameters that the tests recover
+template< class T >
+hs::parameters< T > truth( )
+{
+  return { 3.9e-10, 2.29, 2.04, 116.81 };
+}
+
+// No offset of da/dN
+inline double no_noise( )
+{
+  return 0.0;
+}
+
+// Test of params at R, with count points evenly spaced in log( DeltaK ) from low_factor times the
+// threshold to high_factor times the asymptote. Each da/dN is offset by noise( ) in log10.
+template< class T, class Noise >
+crack_growth::test_data_t< T > test( const hs::parameters< T >& params,
+                                     const T&                   R,
+                                     std::size_t                count,
+                                     const T&                   low_factor,
+                                     const T&                   high_factor,
+                                     Noise&&                    noise )
+{
+  crack_growth::test_data_t< T > test;
+  test.R = R;
+
+  const T low  = params.DeltaK_thr * low_factor;
+  const T high = params.A * ( 1 - R ) * high_factor;
+
+  for ( std::size_t i = 0; i != count; i++ )
+  {
+    const T DeltaK = low * std::pow( high / low, T( i ) / ( count - 1 ) );
+    test.points.push_back(
+      { DeltaK, hs::evaluate( params, R, DeltaK ) * std::pow( 10.0, noise( ) ) } );
+  }
+
+  return test;
+}
+
+// A test of params at each of Rs, in turn
+template< class T, class Noise >
+std::vector< crack_growth::test_data_t< T > > test_set( const hs::parameters< T >& params,
+                                                        const std::vector< T >&    Rs,
+                                                        std::size_t                count,
+                                                        const T&                   low_factor,
+                                                        const T&                   high_factor,
+                                                        Noise&&                    noise )
+{
+  std::vector< crack_growth::test_data_t< T > > test_set;
+  for ( const T& R : Rs )
+  {
+    test_set.push_back( test( params, R, count, low_factor, high_factor, noise ) );
+  }
+  return test_set;
+}
+
+} // namespace synthetic